@@ -49,9 +49,92 @@ env.Append(CCFLAGS = [
     '-fno-exceptions'
 ])
 
+if ARGUMENTS.get('lock_statistics', '0') == '1':
+    env.Append(CPPDEFINES = [
+        'ENABLE_LOCK_STATISTICS',
+    ])
+
+if ARGUMENTS.get('tokenized_logging', '0') == '1':
+    env.Append(CPPDEFINES = [
+        'ENABLE_TOKENIZED_LOGGING',
+    ])
+
+if ARGUMENTS.get('trace', '0') == '1':
+    env.Append(CPPDEFINES = [
+        'ENABLE_TRACE',
+    ])
+
+if ARGUMENTS.get('event_recorder', '0') == '1':
+    env.Append(CPPDEFINES = [
+        'ENABLE_EVENT_RECORDER',
+    ])
+
+if ARGUMENTS.get('memory_statistics', '0') == '1':
+    env.Append(CPPDEFINES = [
+        'ENABLE_MEMORY_STATISTICS',
+    ])
+    env.Append(LINKFLAGS = [
+        '-Wl,--wrap=malloc,--wrap=free,--wrap=realloc,--wrap=calloc',
+    ])
+
+# Every node on a bus needs its own id. Without node_id the firmware refuses to start.
+if 'node_id' in ARGUMENTS:
+    env.Append(CPPDEFINES = [
+        ('OSSHS_NODE_ID', ARGUMENTS['node_id']),
+    ])
+else:
+    print('warning: node_id is not set, the firmware will not start')
+
+if ARGUMENTS.get('benchmark', '0') == '1':
+    env.Append(CPPDEFINES = [
+        'ENABLE_BENCHMARK',
+    ])
+
 if profile == 'debug':
     env.Append(CCFLAGS = [
         '-O0',
     ])
 
-env.BuildTarget(sources)
+if profile == 'release':
+    env.Append(CPPDEFINES = [
+        ('OSSHS_LOG_COMPILE_LEVEL', ARGUMENTS.get('log_level', 'INFO')),
+    ])
+
+    env.AppendUnique(CCFLAGS = [
+        '-Os',
+        '-ffunction-sections',
+        '-fdata-sections',
+    ])
+
+    env.AppendUnique(LINKFLAGS = [
+        '-Os',
+        '-Wl,--gc-sections',
+    ])
+
+    if ARGUMENTS.get('lto', '1') == '1':
+        env.Append(CCFLAGS = [
+            '-flto',
+        ])
+        env.Append(LINKFLAGS = [
+            '-flto',
+        ])
+
+    # Event parsing and dispatch, plus the application, where the TLC594x frame packing
+    # and module handlers are instantiated. GCC keeps the per-file level through LTO.
+    hot_sources = ARGUMENTS.get('hot_sources', ','.join([
+        '../common/src/osshs/events',
+        '../common/src/osshs/system.cpp',
+        'src/main.cpp',
+    ]))
+    hot_paths = [env.Entry(path).abspath for path in hot_sources.split(',') if path]
+
+    def is_hot(source):
+        path = env.File(str(source)).abspath
+        return any(path == hot or path.startswith(hot + os.sep) for hot in hot_paths)
+
+    sources = [env.Object(source, CCFLAGS = env['CCFLAGS'] + ['-O2']) if is_hot(source) else source for source in sources]
+
+program = env.BuildTarget(sources)
+
+if ARGUMENTS.get('size_report', '1') == '1':
+    env.AddPostAction(program, 'python3 %s $TARGET' % abspath('../tools/size_report.py'))
@@ -0,0 +1,90 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2019 Linas Nikiperavicius
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef OSSHS_BENCHMARK_HPP
+#define OSSHS_BENCHMARK_HPP
+
+#ifdef ENABLE_BENCHMARK
+	#ifdef DISABLE_LOGGING
+		#error "Benchmark results are written to the log, ENABLE_BENCHMARK needs logging."
+	#endif  // DISABLE_LOGGING
+
+	#include <cstdint>
+
+	#ifndef BENCHMARK_ITERATIONS
+		#define BENCHMARK_ITERATIONS 1000
+	#endif  // BENCHMARK_ITERATIONS
+
+	namespace osshs
+	{
+		/**
+		 * @brief On-target benchmarks of the event paths, run once before the main loop
+		 * (see SCons option benchmark=1). Results are written to the log in nanoseconds per event.
+		 */
+		class Benchmark
+		{
+		public:
+			static constexpr uint16_t ITERATIONS = BENCHMARK_ITERATIONS;
+
+			/**
+			 * @brief Run all benchmarks. Called from System::loop once the node id is set.
+			 * 
+			 */
+			static void
+			run();
+		private:
+			/**
+			 * @brief Compare delivering an event to a local subscriber directly with passing it
+			 * through serialize() and EventFactory::make first, as the path through an interface does.
+			 * The benchmark subscribes a counter to SystemErrorEvent, which no module handles.
+			 * 
+			 */
+			static void
+			runLocalDelivery();
+
+			/**
+			 * @brief Send ITERATIONS segmented transfers from one SegmentedTransport instance over a
+			 * loopback bus shared by a receiver and a bystander node, once to the receiver and once as
+			 * broadcast. Reports the bytes each node received, the flow control frames, the CPU time per
+			 * transfer and the payload rate the bus itself would allow at the configured bitrate.
+			 * 
+			 */
+			static void
+			runSegmentedTransport();
+
+			struct LoopbackCan;
+
+			/**
+			 * @brief Nanoseconds per iteration.
+			 * 
+			 * @param start start time in microseconds.
+			 * @return uint32_t time per iteration since start.
+			 */
+			static uint32_t
+			getTimePerIteration(uint32_t start);
+		};
+	}
+#endif  // ENABLE_BENCHMARK
+
+#endif  // OSSHS_BENCHMARK_HPP
@@ -0,0 +1,118 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2019 Linas Nikiperavicius
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef OSSHS_BOOT_PROFILE_HPP
+#define OSSHS_BOOT_PROFILE_HPP
+
+#include <cstdint>
+
+#ifndef BOOT_PROFILE_SIZE
+	#define BOOT_PROFILE_SIZE 16
+#endif  // BOOT_PROFILE_SIZE
+
+namespace osshs
+{
+	enum class BootPhase : uint8_t
+	{
+		SYSTEM_INITIALIZED,
+		INTERFACE_REGISTERED,
+		MODULE_REGISTERED,
+		APPLICATION,
+		LOOP_STARTED,
+		FIRST_EVENT
+	};
+
+	/**
+	 * @brief Timestamps of the initialization phases, from system time initialization up to the first delivered event.
+	 * 
+	 * Marking a phase only stores a timestamp, so startup does not wait for the UART. The profile is
+	 * logged from the main loop after the first event was delivered, one entry every REPORT_INTERVAL.
+	 */
+	class BootProfile
+	{
+	public:
+		static constexpr uint8_t SIZE = BOOT_PROFILE_SIZE;
+		static constexpr uint32_t REPORT_DELAY = 1000;
+		static constexpr uint32_t REPORT_INTERVAL = 10;
+
+		/**
+		 * @brief Record the end of an initialization phase. Phases past SIZE are counted, but not stored.
+		 * 
+		 * @param phase finished phase.
+		 * @param argument phase specific argument, e.g. the module type id.
+		 */
+		static void
+		mark(BootPhase phase, uint16_t argument = 0);
+
+		/**
+		 * @brief Record the first event delivered to a local subscriber once the main loop started.
+		 * Events reported during initialization and later calls have no effect.
+		 * 
+		 * @param type event type id.
+		 */
+		static inline void
+		markFirstEvent(uint16_t type)
+		{
+			if (loopStarted && !firstEvent)
+			{
+				firstEvent = true;
+				mark(BootPhase::FIRST_EVENT, type);
+			}
+		}
+
+		/**
+		 * @brief Time to first event getter.
+		 * 
+		 * @return uint32_t microseconds from system time initialization to the first delivered event, 0 if there was none yet.
+		 */
+		static uint32_t
+		getTimeToFirstEvent();
+
+		/**
+		 * @brief Log the next profile entry once the first event was delivered or REPORT_DELAY passed since the loop started.
+		 * 
+		 */
+		static void
+		update();
+	private:
+		struct Entry
+		{
+			BootPhase phase;
+			uint16_t argument;
+			uint32_t timestamp;
+		};
+
+		static Entry entries[SIZE];
+		static uint8_t count;
+		static uint8_t reported;
+		static uint8_t overflow;
+		static bool loopStarted;
+		static bool firstEvent;
+		static uint32_t firstEventTimestamp;
+		static uint32_t loopTimestamp;
+		static uint32_t reportTimestamp;
+	};
+}
+
+#endif  // OSSHS_BOOT_PROFILE_HPP
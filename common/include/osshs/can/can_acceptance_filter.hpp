@@ -0,0 +1,92 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2019 Linas Nikiperavicius
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef OSSHS_CAN_ACCEPTANCE_FILTER_HPP
+#define OSSHS_CAN_ACCEPTANCE_FILTER_HPP
+
+#include <cstdint>
+#include <vector>
+
+#include <osshs/can/can_identifier.hpp>
+#include <osshs/events/event_selector.hpp>
+
+namespace osshs
+{
+	namespace can
+	{
+		/**
+		 * @brief Programs bxCAN filter banks from event selectors, so frames of event
+		 * types nobody subscribed to are dropped by hardware.
+		 * 
+		 * The filters rely on the identifier layout of can::makeIdentifier, so they are
+		 * only correct for interfaces sending with it, such as SegmentedCanInterface.
+		 * Responses to Rpc requests are delivered without a subscription, but pass the
+		 * filters only if their type is subscribed as well.
+		 * 
+		 * @tparam CanFilter modm CanFilter.
+		 * @tparam banks number of filter banks available to this CAN instance.
+		 */
+		template<typename CanFilter, uint8_t banks = 14>
+		class CanAcceptanceFilter
+		{
+		public:
+			/**
+			 * @brief Configure the filter banks from System::getEventSelectors() now and again
+			 * whenever a subscription adds a new selector. Call after System::setNodeId.
+			 * 
+			 */
+			static void
+			enable();
+
+			/**
+			 * @brief Configure filter banks. If there are more selectors than banks,
+			 * selectors are merged into broader ones and software matching in
+			 * System::reportEvent drops the remaining frames. A selector with an empty
+			 * mask, or no selectors at all, accepts every frame. Otherwise the first bank
+			 * accepts the flow control frames of the segmented transport for transfers
+			 * sent by this node, or from any node while the node id is not set.
+			 * 
+			 * @param selectors event selectors to accept, usually System::getEventSelectors().
+			 * @return uint8_t number of filter banks in use.
+			 */
+			static uint8_t
+			configure(std::vector<events::EventSelector> selectors);
+		private:
+			/**
+			 * @brief Merge the pair of selectors that loses the fewest mask bits.
+			 * 
+			 * @param selectors selectors, at least two.
+			 */
+			static void
+			mergeClosest(std::vector<events::EventSelector> &selectors);
+
+			static events::EventSelector
+			merge(const events::EventSelector &a, const events::EventSelector &b);
+		};
+	}
+}
+
+#include <osshs/can/can_acceptance_filter_impl.hpp>
+
+#endif  // OSSHS_CAN_ACCEPTANCE_FILTER_HPP
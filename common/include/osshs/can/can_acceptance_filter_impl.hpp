@@ -0,0 +1,155 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2019 Linas Nikiperavicius
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef OSSHS_CAN_ACCEPTANCE_FILTER_HPP
+	#error "Don't include this file directly, use 'can_acceptance_filter.hpp' instead!"
+#endif
+
+#include <osshs/system.hpp>
+#include <osshs/log/logger.hpp>
+
+namespace osshs
+{
+	namespace can
+	{
+		template<typename CanFilter, uint8_t banks>
+		void
+		CanAcceptanceFilter<CanFilter, banks>::enable()
+		{
+			System::setSubscriptionHandler(
+				[]() -> void
+				{
+					configure(System::getEventSelectors());
+				}
+			);
+
+			configure(System::getEventSelectors());
+		}
+
+		template<typename CanFilter, uint8_t banks>
+		uint8_t
+		CanAcceptanceFilter<CanFilter, banks>::configure(std::vector<events::EventSelector> selectors)
+		{
+			bool acceptAll = selectors.empty();
+
+			for (const events::EventSelector &selector : selectors)
+				acceptAll |= (selector.mask == 0);
+
+			if (acceptAll)
+			{
+				selectors.clear();
+				selectors.push_back(events::EventSelector(0, 0));
+			}
+
+			// Flow control frames of the segmented transport are accepted by a bank of their own.
+			uint8_t firstBank = acceptAll ? 0 : 1;
+			std::size_t selectorBanks = banks - firstBank;
+
+			while (selectors.size() > selectorBanks)
+				mergeClosest(selectors);
+
+			if (!acceptAll)
+			{
+				// Flow control frames carry the identifier of the transfer, so its source is this node.
+				uint32_t identifier = FLOW_CONTROL_FLAG;
+				uint32_t mask = FLOW_CONTROL_FLAG;
+
+				if (System::getNodeId() <= events::Event::MAX_NODE_ID)
+				{
+					identifier |= static_cast<uint32_t>(System::getNodeId()) << SOURCE_SHIFT;
+					mask |= SOURCE_MASK;
+				}
+
+				CanFilter::setFilter(
+					0,
+					CanFilter::FIFO0,
+					typename CanFilter::ExtendedIdentifier(identifier),
+					typename CanFilter::ExtendedFilterMask(mask)
+				);
+			}
+
+			for (uint8_t bank = firstBank; bank < banks; bank++)
+			{
+				std::size_t index = bank - firstBank;
+
+				if (index < selectors.size())
+				{
+					const events::EventSelector &selector = selectors[index];
+
+					OSSHS_LOG_INFO("Setting can filter(bank = %u, mask = 0x%04x, identifier = 0x%04x).", bank, selector.mask, selector.identifier);
+
+					CanFilter::setFilter(
+						bank,
+						CanFilter::FIFO0,
+						typename CanFilter::ExtendedIdentifier(static_cast<uint32_t>(selector.identifier) << EVENT_TYPE_SHIFT),
+						typename CanFilter::ExtendedFilterMask(static_cast<uint32_t>(selector.mask) << EVENT_TYPE_SHIFT)
+					);
+				}
+				else
+				{
+					CanFilter::disableFilter(bank);
+				}
+			}
+
+			return selectors.size() + firstBank;
+		}
+
+		template<typename CanFilter, uint8_t banks>
+		void
+		CanAcceptanceFilter<CanFilter, banks>::mergeClosest(std::vector<events::EventSelector> &selectors)
+		{
+			std::size_t first = 0;
+			std::size_t second = 1;
+			int bestBits = -1;
+
+			for (std::size_t i = 0; i < selectors.size(); i++)
+			{
+				for (std::size_t j = i + 1; j < selectors.size(); j++)
+				{
+					int bits = __builtin_popcount(merge(selectors[i], selectors[j]).mask);
+
+					if (bits > bestBits)
+					{
+						bestBits = bits;
+						first = i;
+						second = j;
+					}
+				}
+			}
+
+			selectors[first] = merge(selectors[first], selectors[second]);
+			selectors.erase(selectors.begin() + second);
+		}
+
+		template<typename CanFilter, uint8_t banks>
+		events::EventSelector
+		CanAcceptanceFilter<CanFilter, banks>::merge(const events::EventSelector &a, const events::EventSelector &b)
+		{
+			// Keep only the bits both selectors care about and agree on.
+			uint16_t mask = a.mask & b.mask & ~(a.identifier ^ b.identifier);
+
+			return events::EventSelector(mask, a.identifier & mask);
+		}
+	}
+}
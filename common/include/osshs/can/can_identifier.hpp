@@ -0,0 +1,96 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2019 Linas Nikiperavicius
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef OSSHS_CAN_IDENTIFIER_HPP
+#define OSSHS_CAN_IDENTIFIER_HPP
+
+#include <cstdint>
+
+#include <osshs/events/event.hpp>
+
+namespace osshs
+{
+	namespace can
+	{
+		/**
+		 * Layout of the 29-bit extended identifier of frames carrying events.
+		 * The event type occupies the low 16 bits, so acceptance filters can
+		 * be derived from event selectors. Flow control frames of the segmented
+		 * transport carry the identifier of the transfer with FLOW_CONTROL_FLAG set;
+		 * they are only sent by the single node a transfer is addressed to.
+		 * The source node id follows, so no two nodes send frames with the same
+		 * identifier and transfers of the same event type from different nodes
+		 * never share a transport session.
+		 * The event priority occupies the most significant bits, so urgent events
+		 * win arbitration against bulk transfers.
+		 */
+		static constexpr uint8_t EVENT_TYPE_SHIFT = 0;
+		static constexpr uint32_t EVENT_TYPE_MASK = static_cast<uint32_t>(0xffff) << EVENT_TYPE_SHIFT;
+		static constexpr uint32_t FLOW_CONTROL_FLAG = static_cast<uint32_t>(1) << 16;
+		static constexpr uint8_t SOURCE_SHIFT = 17;
+		static constexpr uint32_t SOURCE_MASK = static_cast<uint32_t>(events::Event::MAX_NODE_ID) << SOURCE_SHIFT;
+		static constexpr uint8_t PRIORITY_SHIFT = 26;
+		static constexpr uint32_t PRIORITY_MASK = static_cast<uint32_t>(0x7) << PRIORITY_SHIFT;
+
+		/**
+		 * @brief Make the identifier of frames carrying an event.
+		 * 
+		 * @param event event to send.
+		 * @return uint32_t 29-bit extended identifier.
+		 */
+		inline uint32_t
+		makeIdentifier(const events::Event &event)
+		{
+			return (static_cast<uint32_t>(event.getPriority()) << PRIORITY_SHIFT)
+				| (static_cast<uint32_t>(event.getSource() & events::Event::MAX_NODE_ID) << SOURCE_SHIFT)
+				| (static_cast<uint32_t>(event.getType()) << EVENT_TYPE_SHIFT);
+		}
+
+		/**
+		 * @brief Get the source node id encoded in an identifier.
+		 * 
+		 * @param identifier 29-bit extended identifier.
+		 * @return uint8_t id of the node which sent the event.
+		 */
+		inline uint8_t
+		getSource(uint32_t identifier)
+		{
+			return (identifier & SOURCE_MASK) >> SOURCE_SHIFT;
+		}
+
+		/**
+		 * @brief Get the priority level encoded in an identifier.
+		 * 
+		 * @param identifier 29-bit extended identifier.
+		 * @return uint8_t priority level, 0 is the most urgent.
+		 */
+		inline uint8_t
+		getPriorityLevel(uint32_t identifier)
+		{
+			return (identifier & PRIORITY_MASK) >> PRIORITY_SHIFT;
+		}
+	}
+}
+
+#endif  // OSSHS_CAN_IDENTIFIER_HPP
@@ -0,0 +1,59 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2019 Linas Nikiperavicius
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef OSSHS_CRC32_HPP
+#define OSSHS_CRC32_HPP
+
+#include <cstddef>
+#include <cstdint>
+
+namespace osshs
+{
+	/**
+	 * @brief CRC-32 (IEEE 802.3, reflected, as used by zlib).
+	 * 
+	 * A 16 entry table keeps the flash footprint small. The result of update()
+	 * can be passed back in to checksum data in pieces, like zlib.crc32().
+	 */
+	class Crc32
+	{
+	public:
+		static constexpr uint32_t INITIAL = 0;
+
+		/**
+		 * @brief Continue a checksum over more data.
+		 * 
+		 * @param crc checksum of the preceding data, INITIAL for the first piece.
+		 * @param data data to checksum.
+		 * @param length data length.
+		 * @return uint32_t checksum of all data so far.
+		 */
+		static uint32_t
+		update(uint32_t crc, const uint8_t *data, std::size_t length);
+	private:
+		static const uint32_t table[16];
+	};
+}
+
+#endif  // OSSHS_CRC32_HPP
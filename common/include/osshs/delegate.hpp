@@ -0,0 +1,102 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2019 Linas Nikiperavicius
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef OSSHS_DELEGATE_HPP
+#define OSSHS_DELEGATE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+namespace osshs
+{
+	template<typename Signature, std::size_t capacity = sizeof(void*)>
+	class Delegate;
+
+	/**
+	 * @brief Non-allocating replacement for std::function.
+	 * 
+	 * The callable is stored inline, so it must fit into `capacity` bytes and be
+	 * trivially copyable and destructible, e.g. a lambda capturing `this`.
+	 * Anything larger is rejected at compile time instead of falling back to the heap.
+	 * 
+	 * @tparam Result return type.
+	 * @tparam Arguments argument types.
+	 * @tparam capacity inline storage size in bytes.
+	 */
+	template<typename Result, typename... Arguments, std::size_t capacity>
+	class Delegate<Result (Arguments...), capacity>
+	{
+	public:
+		/**
+		 * @brief Construct an empty delegate.
+		 * 
+		 */
+		Delegate(std::nullptr_t = nullptr);
+
+		/**
+		 * @brief Construct a delegate wrapping a callable.
+		 * 
+		 * @param callable lambda or function object to store inline.
+		 */
+		template<typename Callable, typename = std::enable_if_t<!std::is_same_v<std::decay_t<Callable>, Delegate>>>
+		Delegate(Callable callable);
+
+		/**
+		 * @brief Invoke the stored callable. Must not be called on an empty delegate.
+		 * 
+		 * @param arguments arguments to forward to the callable.
+		 * @return Result result of the callable.
+		 */
+		Result
+		operator()(Arguments... arguments) const;
+
+		/**
+		 * @brief Check whether the delegate holds a callable.
+		 * 
+		 * @return true delegate holds a callable.
+		 */
+		explicit
+		operator bool() const;
+
+		bool
+		operator==(std::nullptr_t) const;
+
+		bool
+		operator!=(std::nullptr_t) const;
+	private:
+		typedef Result (*Invoker)(const void *storage, Arguments... arguments);
+
+		typename std::aligned_storage<capacity, alignof(void*)>::type storage;
+		Invoker invoker;
+
+		template<typename Callable>
+		static Result
+		invoke(const void *storage, Arguments... arguments);
+	};
+}
+
+#include <osshs/delegate_impl.hpp>
+
+#endif  // OSSHS_DELEGATE_HPP
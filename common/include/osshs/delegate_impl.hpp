@@ -0,0 +1,87 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2019 Linas Nikiperavicius
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef OSSHS_DELEGATE_HPP
+	#error "Don't include this file directly, use 'delegate.hpp' instead!"
+#endif
+
+#include <new>
+#include <utility>
+
+namespace osshs
+{
+	template<typename Result, typename... Arguments, std::size_t capacity>
+	Delegate<Result (Arguments...), capacity>::Delegate(std::nullptr_t)
+		: storage(), invoker(nullptr)
+	{
+	}
+
+	template<typename Result, typename... Arguments, std::size_t capacity>
+	template<typename Callable, typename>
+	Delegate<Result (Arguments...), capacity>::Delegate(Callable callable)
+		: storage(), invoker(&invoke<Callable>)
+	{
+		static_assert(sizeof(Callable) <= capacity, "Callable does not fit into the delegate storage.");
+		static_assert(alignof(Callable) <= alignof(void*), "Callable is over-aligned for the delegate storage.");
+		static_assert(std::is_trivially_copyable_v<Callable> && std::is_trivially_destructible_v<Callable>,
+			"Delegates only hold trivially copyable callables, e.g. lambdas capturing `this`.");
+
+		new (&storage) Callable(callable);
+	}
+
+	template<typename Result, typename... Arguments, std::size_t capacity>
+	Result
+	Delegate<Result (Arguments...), capacity>::operator()(Arguments... arguments) const
+	{
+		return invoker(&storage, std::forward<Arguments>(arguments)...);
+	}
+
+	template<typename Result, typename... Arguments, std::size_t capacity>
+	Delegate<Result (Arguments...), capacity>::operator bool() const
+	{
+		return invoker != nullptr;
+	}
+
+	template<typename Result, typename... Arguments, std::size_t capacity>
+	bool
+	Delegate<Result (Arguments...), capacity>::operator==(std::nullptr_t) const
+	{
+		return invoker == nullptr;
+	}
+
+	template<typename Result, typename... Arguments, std::size_t capacity>
+	bool
+	Delegate<Result (Arguments...), capacity>::operator!=(std::nullptr_t) const
+	{
+		return invoker != nullptr;
+	}
+
+	template<typename Result, typename... Arguments, std::size_t capacity>
+	template<typename Callable>
+	Result
+	Delegate<Result (Arguments...), capacity>::invoke(const void *storage, Arguments... arguments)
+	{
+		return (*static_cast<const Callable*>(storage))(std::forward<Arguments>(arguments)...);
+	}
+}
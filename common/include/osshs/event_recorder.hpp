@@ -0,0 +1,123 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2019 Linas Nikiperavicius
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef OSSHS_EVENT_RECORDER_HPP
+#define OSSHS_EVENT_RECORDER_HPP
+
+#ifdef ENABLE_EVENT_RECORDER
+	#include <cstdint>
+
+	#include <osshs/events/event.hpp>
+
+	#ifndef EVENT_RECORDER_BUFFER_SIZE
+		#define EVENT_RECORDER_BUFFER_SIZE 1024
+	#endif  // EVENT_RECORDER_BUFFER_SIZE
+
+	#define OSSHS_RECORD_RECEIVED(data) do { osshs::EventRecorder::recordReceived(data); } while (0)
+	#define OSSHS_RECORD_SENT(event) do { osshs::EventRecorder::recordSent((event).get()); } while (0)
+
+	namespace osshs
+	{
+		enum class EventDirection : uint8_t
+		{
+			RECEIVED,
+			SENT
+		};
+
+		/**
+		 * @brief Capture of the serialized events crossing the interfaces of this node.
+		 * 
+		 * Recording only copies the event into a byte ring, the records are written to the
+		 * log from the main loop while the log buffer has room. Records that do not fit
+		 * into the ring are dropped, their sequence numbers are skipped, so the capture
+		 * shows the gap. The output is understood by tools/event_capture.py.
+		 */
+		class EventRecorder
+		{
+		public:
+			static constexpr uint16_t SIZE = EVENT_RECORDER_BUFFER_SIZE;
+
+			/**
+			 * @brief Record a serialized event received from an interface.
+			 * 
+			 * @param data serialized event, starting with its length.
+			 */
+			static void
+			recordReceived(const uint8_t *data);
+
+			/**
+			 * @brief Record an event passed to the interfaces.
+			 * 
+			 * @param event event to serialize and record, ignored if nullptr.
+			 */
+			static void
+			recordSent(const events::Event *event);
+
+			/**
+			 * @brief Write the oldest record to the log, if the log buffer has room. Called from the main loop.
+			 * 
+			 */
+			static void
+			update();
+
+			/**
+			 * @brief Dropped record count getter.
+			 * 
+			 * @return uint32_t number of records dropped since boot because the ring was full.
+			 */
+			static uint32_t
+			getDroppedCount();
+		private:
+			/**
+			 * @brief Record header in the ring: [0-1] sequence, [2] direction, [3-6] timestamp in microseconds,
+			 * followed by the serialized event.
+			 */
+			static constexpr uint8_t RECORD_HEADER_LENGTH = 7;
+			static constexpr uint8_t LOG_CHUNK_LENGTH = 16;
+
+			static uint8_t ring[SIZE];
+			static uint16_t head;
+			static uint16_t tail;
+			static uint16_t used;
+			static uint16_t sequence;
+			static uint32_t droppedCount;
+			static uint32_t reportedDroppedCount;
+			static uint16_t logOffset;
+
+			static void
+			record(EventDirection direction, const uint8_t *data);
+
+			static void
+			write(const uint8_t *data, uint16_t length);
+
+			static uint8_t
+			peek(uint16_t offset);
+		};
+	}
+#else  // ENABLE_EVENT_RECORDER
+	#define OSSHS_RECORD_RECEIVED(data) do { } while (0)
+	#define OSSHS_RECORD_SENT(event) do { } while (0)
+#endif  // ENABLE_EVENT_RECORDER
+
+#endif  // OSSHS_EVENT_RECORDER_HPP
@@ -0,0 +1,112 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2019 Linas Nikiperavicius
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef OSSHS_CAUSE_ID_ALLOCATOR_HPP
+#define OSSHS_CAUSE_ID_ALLOCATOR_HPP
+
+#include <cstdint>
+
+#ifndef CAUSE_ID_MAX_RESERVED
+	#define CAUSE_ID_MAX_RESERVED 4
+#endif  // CAUSE_ID_MAX_RESERVED
+
+namespace osshs
+{
+	namespace events
+	{
+		/**
+		 * @brief Allocates cause ids which are unique across the bus.
+		 * 
+		 * A cause id is the node id in its upper 7 bits and a per-node sequence
+		 * number in its lower 9 bits, so nodes never hand out each other's ids.
+		 * The 16-bit cause id is part of the event header, so the sequence cannot
+		 * grow without a bus-wide flag day.
+		 * 
+		 * 512 ids are enough because every consumer that correlates by cause id
+		 * is bounded well below a wrap-around. Ids of requests pending in Rpc and
+		 * ids reserved by other correlators, such as the PWM module's storage
+		 * requests, are skipped when the sequence wraps around. The trace recorder
+		 * holds at most TRACE_BUFFER_SIZE records, fewer than the sequence length,
+		 * so a full trace never sees the same id for two different events.
+		 * Allocation is safe from interrupt context.
+		 */
+		class CauseIdAllocator
+		{
+		public:
+			static constexpr uint8_t SEQUENCE_BITS = 9;
+			static constexpr uint16_t SEQUENCE_MASK = (1 << SEQUENCE_BITS) - 1;
+
+			/**
+			 * @brief Allocate a cause id.
+			 * 
+			 * @return uint16_t cause id, never Event::CAUSE_ID_GENERATE.
+			 */
+			static uint16_t
+			allocate();
+
+			/**
+			 * @brief Set the node id placed in the upper bits of allocated cause ids.
+			 * 
+			 * @param nodeId node id in range 0x00-0x7f.
+			 */
+			static void
+			setNodeId(uint8_t nodeId);
+
+			/**
+			 * @brief Keep a cause id from being allocated again until it is released.
+			 * Meant for correlators which may still see a response after giving up on it.
+			 * 
+			 * @param causeId cause id.
+			 * @return true cause id is reserved.
+			 * @return false all CAUSE_ID_MAX_RESERVED reservations are taken.
+			 */
+			static bool
+			reserve(uint16_t causeId);
+
+			/**
+			 * @brief Release a reserved cause id. Releasing an id which is not reserved does nothing.
+			 * 
+			 * @param causeId cause id.
+			 */
+			static void
+			release(uint16_t causeId);
+		private:
+			static uint16_t prefix;
+			static uint16_t sequence;
+			static uint16_t reserved[CAUSE_ID_MAX_RESERVED];
+			static uint8_t reservedCount;
+
+			/**
+			 * @brief Check whether a cause id is reserved. Must be called with interrupts disabled.
+			 * 
+			 * @param causeId cause id.
+			 * @return true cause id is reserved.
+			 */
+			static bool
+			isReserved(uint16_t causeId);
+		};
+	}
+}
+
+#endif  // OSSHS_CAUSE_ID_ALLOCATOR_HPP
@@ -0,0 +1,429 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2019 Linas Nikiperavicius
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef OSSHS_DIAGNOSTICS_EVENT_HPP
+#define OSSHS_DIAGNOSTICS_EVENT_HPP
+
+#include <osshs/events/event_registrar.hpp>
+
+namespace osshs
+{
+	namespace events
+	{
+		enum class DiagnosticsEvent : uint16_t
+		{
+			BASE = 0x03 << 8,
+
+			REQUEST_LOCK_STATISTICS,
+			LOCK_STATISTICS_READY,
+
+			REQUEST_TRACE,
+			TRACE_READY,
+
+			REQUEST_MODULE_METRICS,
+			MODULE_METRICS_READY,
+
+			REQUEST_MEMORY_STATISTICS,
+			MEMORY_STATISTICS_READY,
+
+			ERROR
+		};
+
+		enum class DiagnosticsError : uint8_t
+		{
+			LOCK_OUT_OF_BOUNDS,
+			STATISTICS_DISABLED,
+			TRACE_DISABLED,
+			MODULE_OUT_OF_BOUNDS,
+			MEMORY_STATISTICS_DISABLED
+		};
+
+		enum class DiagnosticsTraceTarget : uint8_t
+		{
+			EVENT,
+			LOG
+		};
+
+		enum class DiagnosticsTraceStage : uint8_t
+		{
+			MADE,
+			REPORTED,
+			QUEUED,
+			DEQUEUED,
+			LOCKED,
+			TRANSFERRED,
+			RESPONDED
+		};
+
+		typedef struct DiagnosticsLockStatistics
+		{
+			uint32_t lockId;
+			uint32_t acquisitions;
+			uint32_t failedTryLocks;
+			uint32_t maxHoldTime;
+			uint32_t averageHoldTime;
+			uint32_t maxWaitTime;
+
+			DiagnosticsLockStatistics()
+			{
+				this->lockId = 0;
+				this->acquisitions = 0;
+				this->failedTryLocks = 0;
+				this->maxHoldTime = 0;
+				this->averageHoldTime = 0;
+				this->maxWaitTime = 0;
+			}
+		} DiagnosticsLockStatistics;
+
+		typedef struct DiagnosticsTraceRecord
+		{
+			uint32_t timestamp;
+			uint16_t causeId;
+			uint16_t type;
+			DiagnosticsTraceStage stage;
+
+			DiagnosticsTraceRecord()
+			{
+				this->timestamp = 0;
+				this->causeId = 0;
+				this->type = 0;
+				this->stage = DiagnosticsTraceStage::MADE;
+			}
+		} DiagnosticsTraceRecord;
+
+		typedef struct DiagnosticsModuleMetrics
+		{
+			uint32_t eventsHandled;
+			uint32_t errors;
+			uint16_t queueHighWaterMark;
+			uint64_t totalHandlerTime;
+			uint32_t maxHandlerTime;
+
+			DiagnosticsModuleMetrics()
+			{
+				this->eventsHandled = 0;
+				this->errors = 0;
+				this->queueHighWaterMark = 0;
+				this->totalHandlerTime = 0;
+				this->maxHandlerTime = 0;
+			}
+		} DiagnosticsModuleMetrics;
+
+		typedef struct DiagnosticsEventCount
+		{
+			uint16_t type;
+			uint32_t count;
+
+			DiagnosticsEventCount()
+			{
+				this->type = 0;
+				this->count = 0;
+			}
+		} DiagnosticsEventCount;
+
+		typedef struct DiagnosticsMemoryStatistics
+		{
+			uint32_t liveBytes;
+			uint32_t peakBytes;
+			uint32_t allocations;
+			uint32_t failedAllocations;
+			uint32_t largestFreeBlock;
+			uint32_t stackHighWaterMark;
+			uint32_t stackSize;
+
+			DiagnosticsMemoryStatistics()
+			{
+				this->liveBytes = 0;
+				this->peakBytes = 0;
+				this->allocations = 0;
+				this->failedAllocations = 0;
+				this->largestFreeBlock = 0;
+				this->stackHighWaterMark = 0;
+				this->stackSize = 0;
+			}
+		} DiagnosticsMemoryStatistics;
+
+		class DiagnosticsRequestLockStatisticsEvent : public EventRegistrar<DiagnosticsRequestLockStatisticsEvent>
+		{
+		public:
+			static constexpr uint16_t EVENT_LENGTH = 9;
+			static constexpr uint16_t TYPE = static_cast<uint16_t> (DiagnosticsEvent::REQUEST_LOCK_STATISTICS);
+			static constexpr EventPriority PRIORITY = EventPriority::BULK;
+
+			DiagnosticsRequestLockStatisticsEvent(std::unique_ptr<const uint8_t[]> data, EventCallback callback = nullptr);
+
+			DiagnosticsRequestLockStatisticsEvent(uint8_t lock, uint16_t causeId = Event::CAUSE_ID_GENERATE, EventCallback callback = nullptr)
+				: EventRegistrar<DiagnosticsRequestLockStatisticsEvent>(causeId, callback), lock(lock)
+			{
+			}
+
+			uint8_t
+			getLock() const;
+
+			std::unique_ptr<const uint8_t[]>
+			serialize() const;
+		private:
+			uint8_t lock;
+		};
+
+		class DiagnosticsLockStatisticsReadyEvent : public EventRegistrar<DiagnosticsLockStatisticsReadyEvent>
+		{
+		public:
+			static constexpr uint16_t EVENT_LENGTH = 34;
+			static constexpr uint16_t TYPE = static_cast<uint16_t> (DiagnosticsEvent::LOCK_STATISTICS_READY);
+			static constexpr EventPriority PRIORITY = EventPriority::BULK;
+
+			DiagnosticsLockStatisticsReadyEvent(std::unique_ptr<const uint8_t[]> data, EventCallback callback = nullptr);
+
+			DiagnosticsLockStatisticsReadyEvent(uint8_t lock, uint8_t lockCount, DiagnosticsLockStatistics statistics, uint16_t causeId = Event::CAUSE_ID_GENERATE, EventCallback callback = nullptr)
+				: EventRegistrar<DiagnosticsLockStatisticsReadyEvent>(causeId, callback), lock(lock), lockCount(lockCount), statistics(statistics)
+			{
+			}
+
+			uint8_t
+			getLock() const;
+
+			uint8_t
+			getLockCount() const;
+
+			DiagnosticsLockStatistics
+			getStatistics() const;
+
+			std::unique_ptr<const uint8_t[]>
+			serialize() const;
+		private:
+			uint8_t lock;
+			uint8_t lockCount;
+			DiagnosticsLockStatistics statistics;
+		};
+
+		class DiagnosticsRequestTraceEvent : public EventRegistrar<DiagnosticsRequestTraceEvent>
+		{
+		public:
+			static constexpr uint16_t EVENT_LENGTH = 11;
+			static constexpr uint16_t TYPE = static_cast<uint16_t> (DiagnosticsEvent::REQUEST_TRACE);
+			static constexpr EventPriority PRIORITY = EventPriority::BULK;
+
+			DiagnosticsRequestTraceEvent(std::unique_ptr<const uint8_t[]> data, EventCallback callback = nullptr);
+
+			DiagnosticsRequestTraceEvent(uint16_t index, DiagnosticsTraceTarget target = DiagnosticsTraceTarget::EVENT, uint16_t causeId = Event::CAUSE_ID_GENERATE, EventCallback callback = nullptr)
+				: EventRegistrar<DiagnosticsRequestTraceEvent>(causeId, callback), index(index), target(target)
+			{
+			}
+
+			uint16_t
+			getIndex() const;
+
+			DiagnosticsTraceTarget
+			getTarget() const;
+
+			std::unique_ptr<const uint8_t[]>
+			serialize() const;
+		private:
+			uint16_t index;
+			DiagnosticsTraceTarget target;
+		};
+
+		class DiagnosticsTraceReadyEvent : public EventRegistrar<DiagnosticsTraceReadyEvent>
+		{
+		public:
+			static constexpr uint8_t MAX_RECORDS = 4;
+			static constexpr uint16_t RECORD_LENGTH = 9;
+			static constexpr uint16_t EVENT_LENGTH = 13 + MAX_RECORDS * RECORD_LENGTH;
+			static constexpr uint16_t TYPE = static_cast<uint16_t> (DiagnosticsEvent::TRACE_READY);
+			static constexpr EventPriority PRIORITY = EventPriority::BULK;
+
+			DiagnosticsTraceReadyEvent(std::unique_ptr<const uint8_t[]> data, EventCallback callback = nullptr);
+
+			DiagnosticsTraceReadyEvent(uint16_t index, uint16_t recordCount, uint8_t length, const DiagnosticsTraceRecord *records, uint16_t causeId = Event::CAUSE_ID_GENERATE, EventCallback callback = nullptr)
+				: EventRegistrar<DiagnosticsTraceReadyEvent>(causeId, callback), index(index), recordCount(recordCount), length((length < MAX_RECORDS) ? length : MAX_RECORDS)
+			{
+				for (uint8_t i = 0; i < this->length; i++)
+					this->records[i] = records[i];
+			}
+
+			uint16_t
+			getIndex() const;
+
+			uint16_t
+			getRecordCount() const;
+
+			uint8_t
+			getLength() const;
+
+			DiagnosticsTraceRecord
+			getRecord(uint8_t record) const;
+
+			std::unique_ptr<const uint8_t[]>
+			serialize() const;
+		private:
+			uint16_t index;
+			uint16_t recordCount;
+			uint8_t length;
+			DiagnosticsTraceRecord records[MAX_RECORDS];
+		};
+
+		class DiagnosticsRequestModuleMetricsEvent : public EventRegistrar<DiagnosticsRequestModuleMetricsEvent>
+		{
+		public:
+			static constexpr uint16_t EVENT_LENGTH = 9;
+			static constexpr uint16_t TYPE = static_cast<uint16_t> (DiagnosticsEvent::REQUEST_MODULE_METRICS);
+			static constexpr EventPriority PRIORITY = EventPriority::BULK;
+
+			DiagnosticsRequestModuleMetricsEvent(std::unique_ptr<const uint8_t[]> data, EventCallback callback = nullptr);
+
+			DiagnosticsRequestModuleMetricsEvent(uint8_t module, uint16_t causeId = Event::CAUSE_ID_GENERATE, EventCallback callback = nullptr)
+				: EventRegistrar<DiagnosticsRequestModuleMetricsEvent>(causeId, callback), module(module)
+			{
+			}
+
+			uint8_t
+			getModule() const;
+
+			std::unique_ptr<const uint8_t[]>
+			serialize() const;
+		private:
+			uint8_t module;
+		};
+
+		class DiagnosticsModuleMetricsReadyEvent : public EventRegistrar<DiagnosticsModuleMetricsReadyEvent>
+		{
+		public:
+			static constexpr uint8_t MAX_EVENT_COUNTS = 12;
+			static constexpr uint16_t EVENT_COUNT_LENGTH = 6;
+			static constexpr uint16_t EVENT_LENGTH = 0;
+			static constexpr uint16_t PREFIX_LENGTH = 34;
+			static constexpr uint16_t TYPE = static_cast<uint16_t> (DiagnosticsEvent::MODULE_METRICS_READY);
+			static constexpr EventPriority PRIORITY = EventPriority::BULK;
+
+			DiagnosticsModuleMetricsReadyEvent(std::unique_ptr<const uint8_t[]> data, EventCallback callback = nullptr);
+
+			DiagnosticsModuleMetricsReadyEvent(uint8_t module, uint8_t moduleCount, uint8_t moduleTypeId, DiagnosticsModuleMetrics metrics, uint16_t causeId = Event::CAUSE_ID_GENERATE, EventCallback callback = nullptr)
+				: EventRegistrar<DiagnosticsModuleMetricsReadyEvent>(causeId, callback), module(module), moduleCount(moduleCount), moduleTypeId(moduleTypeId), metrics(metrics), eventCountLength(0)
+			{
+			}
+
+			/**
+			 * @brief Append a per event type counter. Counters past MAX_EVENT_COUNTS are ignored.
+			 * 
+			 * @param eventCount event type and count.
+			 */
+			void
+			addEventCount(DiagnosticsEventCount eventCount);
+
+			uint8_t
+			getModule() const;
+
+			uint8_t
+			getModuleCount() const;
+
+			uint8_t
+			getModuleTypeId() const;
+
+			DiagnosticsModuleMetrics
+			getMetrics() const;
+
+			uint8_t
+			getEventCountLength() const;
+
+			DiagnosticsEventCount
+			getEventCount(uint8_t index) const;
+
+			std::unique_ptr<const uint8_t[]>
+			serialize() const;
+		private:
+			uint8_t module;
+			uint8_t moduleCount;
+			uint8_t moduleTypeId;
+			DiagnosticsModuleMetrics metrics;
+			uint8_t eventCountLength;
+			DiagnosticsEventCount eventCounts[MAX_EVENT_COUNTS];
+		};
+
+		class DiagnosticsRequestMemoryStatisticsEvent : public EventRegistrar<DiagnosticsRequestMemoryStatisticsEvent>
+		{
+		public:
+			static constexpr uint16_t EVENT_LENGTH = 8;
+			static constexpr uint16_t TYPE = static_cast<uint16_t> (DiagnosticsEvent::REQUEST_MEMORY_STATISTICS);
+			static constexpr EventPriority PRIORITY = EventPriority::BULK;
+
+			DiagnosticsRequestMemoryStatisticsEvent(std::unique_ptr<const uint8_t[]> data, EventCallback callback = nullptr);
+
+			DiagnosticsRequestMemoryStatisticsEvent(uint16_t causeId = Event::CAUSE_ID_GENERATE, EventCallback callback = nullptr)
+				: EventRegistrar<DiagnosticsRequestMemoryStatisticsEvent>(causeId, callback)
+			{
+			}
+
+			std::unique_ptr<const uint8_t[]>
+			serialize() const;
+		};
+
+		class DiagnosticsMemoryStatisticsReadyEvent : public EventRegistrar<DiagnosticsMemoryStatisticsReadyEvent>
+		{
+		public:
+			static constexpr uint16_t EVENT_LENGTH = 36;
+			static constexpr uint16_t TYPE = static_cast<uint16_t> (DiagnosticsEvent::MEMORY_STATISTICS_READY);
+			static constexpr EventPriority PRIORITY = EventPriority::BULK;
+
+			DiagnosticsMemoryStatisticsReadyEvent(std::unique_ptr<const uint8_t[]> data, EventCallback callback = nullptr);
+
+			DiagnosticsMemoryStatisticsReadyEvent(DiagnosticsMemoryStatistics statistics, uint16_t causeId = Event::CAUSE_ID_GENERATE, EventCallback callback = nullptr)
+				: EventRegistrar<DiagnosticsMemoryStatisticsReadyEvent>(causeId, callback), statistics(statistics)
+			{
+			}
+
+			DiagnosticsMemoryStatistics
+			getStatistics() const;
+
+			std::unique_ptr<const uint8_t[]>
+			serialize() const;
+		private:
+			DiagnosticsMemoryStatistics statistics;
+		};
+
+		class DiagnosticsErrorEvent : public EventRegistrar<DiagnosticsErrorEvent>
+		{
+		public:
+			static constexpr uint16_t EVENT_LENGTH = 9;
+			static constexpr uint16_t TYPE = static_cast<uint16_t> (DiagnosticsEvent::ERROR);
+			static constexpr EventPriority PRIORITY = EventPriority::BULK;
+
+			DiagnosticsErrorEvent(std::unique_ptr<const uint8_t[]> data, EventCallback callback = nullptr);
+
+			DiagnosticsErrorEvent(DiagnosticsError error, uint16_t causeId = Event::CAUSE_ID_GENERATE, EventCallback callback = nullptr)
+				: EventRegistrar<DiagnosticsErrorEvent>(causeId, callback), error(error)
+			{
+			}
+
+			DiagnosticsError
+			getError() const;
+
+			std::unique_ptr<const uint8_t[]>
+			serialize() const;
+		private:
+			DiagnosticsError error;
+		};
+	}
+}
+#endif  // OSSHS_DIAGNOSTICS_EVENT_HPP
@@ -53,8 +53,9 @@ namespace osshs
 		class EepromRequestDataEvent : public EventRegistrar<EepromRequestDataEvent>
 		{
 		public:
-			static constexpr uint16_t EVENT_LENGTH = 10;
+			static constexpr uint16_t EVENT_LENGTH = 12;
 			static constexpr uint16_t TYPE = static_cast<uint16_t> (EepromEvent::REQUEST_DATA);
+			static constexpr EventPriority PRIORITY = EventPriority::BULK;
 
 			EepromRequestDataEvent(std::unique_ptr<const uint8_t[]> data, EventCallback callback = nullptr);
 
@@ -80,7 +81,9 @@ namespace osshs
 		{
 		public:
 			static constexpr uint16_t EVENT_LENGTH = 0;
+			static constexpr uint16_t PREFIX_LENGTH = 10;
 			static constexpr uint16_t TYPE = static_cast<uint16_t> (EepromEvent::DATA_READY);
+			static constexpr EventPriority PRIORITY = EventPriority::BULK;
 
 			EepromDataReadyEvent(std::unique_ptr<const uint8_t[]> data, EventCallback callback = nullptr);
 
@@ -106,7 +109,9 @@ namespace osshs
 		{
 		public:
 			static constexpr uint16_t EVENT_LENGTH = 0;
+			static constexpr uint16_t PREFIX_LENGTH = 12;
 			static constexpr uint16_t TYPE = static_cast<uint16_t> (EepromEvent::UPDATE_DATA);
+			static constexpr EventPriority PRIORITY = EventPriority::BULK;
 
 			EepromUpdateDataEvent(std::unique_ptr<const uint8_t[]> data, EventCallback callback = nullptr);
 
@@ -135,7 +140,7 @@ namespace osshs
 		class EepromUpdateSuccessEvent : public EventRegistrar<EepromUpdateSuccessEvent>
 		{
 		public:
-			static constexpr uint16_t EVENT_LENGTH = 6;
+			static constexpr uint16_t EVENT_LENGTH = 8;
 			static constexpr uint16_t TYPE = static_cast<uint16_t> (EepromEvent::UPDATE_SUCCESS);
 
 			EepromUpdateSuccessEvent(std::unique_ptr<const uint8_t[]> data, EventCallback callback = nullptr);
@@ -152,7 +157,7 @@ namespace osshs
 		class EepromErrorEvent : public EventRegistrar<EepromErrorEvent>
 		{
 		public:
-			static constexpr uint16_t EVENT_LENGTH = 7;
+			static constexpr uint16_t EVENT_LENGTH = 9;
 			static constexpr uint16_t TYPE = static_cast<uint16_t> (EepromEvent::ERROR);
 
 			EepromErrorEvent(std::unique_ptr<const uint8_t[]> data, EventCallback callback = nullptr);
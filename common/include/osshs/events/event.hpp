@@ -25,23 +25,54 @@
 #ifndef OSSHS_EVENT_HPP
 #define OSSHS_EVENT_HPP
 
-#include <functional>
 #include <memory>
-#include <unordered_map>
+
+#include <osshs/delegate.hpp>
 
 namespace osshs
 {
+	class System;
+
 	namespace events
 	{
 		class Event;
 
-		typedef std::function<void (std::shared_ptr<Event>)> EventCallback;
+		/**
+		 * @brief Transmission priority. Lower values win CAN arbitration and leave the transmit queues first.
+		 */
+		enum class EventPriority : uint8_t
+		{
+			CONTROL,
+			NORMAL,
+			BULK
+		};
+
+		static constexpr uint8_t EVENT_PRIORITY_LEVELS = 3;
+
+		typedef Delegate<void (std::shared_ptr<Event>)> EventCallback;
 
 		class Event
 		{
 		public:
 			static constexpr uint16_t CAUSE_ID_GENERATE = static_cast<uint16_t>(-1);
 
+			/**
+			 * @brief Node addresses: 0x00-0x7f address a single node, 0x80-0xfe a multicast group
+			 * and 0xff every node on the bus.
+			 */
+			static constexpr uint8_t ADDRESS_BROADCAST = 0xff;
+			static constexpr uint8_t ADDRESS_GROUP_FLAG = 0x80;
+			static constexpr uint8_t MAX_NODE_ID = 0x7f;
+
+			/**
+			 * @brief Serialized header: length (2), type (2), cause id (2), destination (1) and source (1).
+			 * 
+			 * The destination and source bytes extended the header from 6 to 8 bytes. The header carries
+			 * no version, so this is a flag day: every node on a bus has to run firmware with the same
+			 * header layout. Events shorter than the header are rejected by EventFactory::make.
+			 */
+			static constexpr uint8_t HEADER_LENGTH = 8;
+
 			/**
 			 * @brief Construct event.
 			 * 
@@ -70,11 +101,59 @@ namespace osshs
 			/**
 			 * @brief Callback getter.
 			 * 
-			 * @return EventCallback event callback.
+			 * @return const EventCallback& event callback.
 			 */
-			EventCallback
+			const EventCallback &
 			getCallback() const;
 
+			/**
+			 * @brief Destination address getter.
+			 * 
+			 * @return uint8_t node id, group address or ADDRESS_BROADCAST.
+			 */
+			uint8_t
+			getDestination() const;
+
+			/**
+			 * @brief Destination address setter.
+			 * 
+			 * @param destination node id, group address or ADDRESS_BROADCAST.
+			 */
+			void
+			setDestination(uint8_t destination);
+
+			/**
+			 * @brief Source address getter.
+			 * 
+			 * @return uint8_t id of the node which made this event.
+			 */
+			uint8_t
+			getSource() const;
+
+			/**
+			 * @brief Priority getter.
+			 * 
+			 * @return EventPriority transmission priority.
+			 */
+			EventPriority
+			getPriority() const;
+
+			/**
+			 * @brief Priority setter, overriding the default priority of the event type.
+			 * 
+			 * @param priority transmission priority.
+			 */
+			void
+			setPriority(EventPriority priority);
+
+			/**
+			 * @brief Check whether this event was received from an interface rather than made on this node.
+			 * 
+			 * @return true if the event was made by EventFactory from serialized data.
+			 */
+			bool
+			isReceived() const;
+
 			/**
 			 * @brief Serialize this event.
 			 * 
@@ -84,9 +163,12 @@ namespace osshs
 			serialize() const = 0;
 		protected:
 			uint16_t causeId;
+			uint8_t destination;
+			uint8_t source;
+			EventPriority priority;
 		private:
-			typedef std::function<std::shared_ptr<Event> (std::unique_ptr<const uint8_t[]>, EventCallback)> EventMaker;
-			static uint16_t nextCauseId;
+			static uint8_t localNodeId;
+			bool received;
 			uint16_t type;
 			EventCallback callback;
 
@@ -95,13 +177,12 @@ namespace osshs
 			Event&
 			operator=(const Event&) = delete;
 
-			static std::unordered_map<uint16_t, EventMaker>&
-			eventRegister();
-
 			template<typename DerivedEvent>
 			friend class EventRegistrar;
 
 			friend class EventFactory;
+
+			friend class osshs::System;
 		};
 	}
 }
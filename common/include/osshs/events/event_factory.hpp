@@ -44,6 +44,40 @@ namespace osshs
 			 */
 			static std::shared_ptr<Event>
 			make(uint16_t type, std::unique_ptr<const uint8_t[]> data, EventCallback callback = nullptr);
+		private:
+			typedef std::shared_ptr<Event> (*EventMaker)(std::unique_ptr<const uint8_t[]> data, EventCallback callback);
+
+			struct MakerEntry
+			{
+				uint16_t type;
+				/**
+				 * @brief Shortest serialized event the maker can read, the fixed prefix for variable length events.
+				 */
+				uint16_t minimumLength;
+				EventMaker maker;
+			};
+
+			/**
+			 * @brief Makers of every event type, sorted by type. Constant initialized, so it lives in flash
+			 * and nothing is registered before main.
+			 */
+			static const MakerEntry makers[];
+
+			static constexpr bool
+			isSorted();
+
+			/**
+			 * @brief Look up the maker of an event type.
+			 * 
+			 * @param type event type.
+			 * @return const MakerEntry* maker entry or nullptr if the type is unknown.
+			 */
+			static const MakerEntry *
+			findMaker(uint16_t type);
+
+			template<typename DerivedEvent>
+			static constexpr MakerEntry
+			makerOf();
 		};
 	}
 }
@@ -35,13 +35,30 @@ namespace osshs
 		class EventRegistrar : public Event
 		{
 		public:
-			static bool registered;
-
-			static bool
-			registerDerivedEvent();
+			/**
+			 * @brief Deserialize the derived event. Referenced from the event factory table.
+			 * 
+			 * @param data serialized event.
+			 * @param callback event callback.
+			 * @return std::shared_ptr<Event> deserialized event.
+			 */
+			static std::shared_ptr<Event>
+			make(std::unique_ptr<const uint8_t[]> data, EventCallback callback);
 		private:
 			EventRegistrar(uint16_t causeId, EventCallback callback);
 
+			/**
+			 * @brief Default priority of the derived event: its PRIORITY constant if it declares one, NORMAL otherwise.
+			 * 
+			 */
+			template<typename Derived>
+			static constexpr auto
+			defaultPriority(int) -> decltype(Derived::PRIORITY);
+
+			template<typename Derived>
+			static constexpr EventPriority
+			defaultPriority(long);
+
 			friend DerivedEvent;
 		};
 	}
@@ -31,26 +31,33 @@ namespace osshs
 	namespace events
 	{
 		template<typename DerivedEvent>
-		bool EventRegistrar<DerivedEvent>::registered = EventRegistrar<DerivedEvent>::registerDerivedEvent();
+		std::shared_ptr<Event>
+		EventRegistrar<DerivedEvent>::make(std::unique_ptr<const uint8_t[]> data, EventCallback callback)
+		{
+			return std::make_shared<DerivedEvent>(std::move(data), callback);
+		}
 
 		template<typename DerivedEvent>
-		bool
-		EventRegistrar<DerivedEvent>::registerDerivedEvent()
+		EventRegistrar<DerivedEvent>::EventRegistrar(uint16_t causeId, EventCallback callback)
+			: Event(DerivedEvent::TYPE, causeId, callback)
 		{
-			Event::eventRegister()[DerivedEvent::TYPE] =
-				[](std::unique_ptr<const uint8_t[]> data, EventCallback callback) -> std::shared_ptr<Event>
-			{
-				return std::make_shared<DerivedEvent>(std::move(data), callback);
-			};
+			priority = defaultPriority<DerivedEvent>(0);
+		}
 
-			return true;
+		template<typename DerivedEvent>
+		template<typename Derived>
+		constexpr auto
+		EventRegistrar<DerivedEvent>::defaultPriority(int) -> decltype(Derived::PRIORITY)
+		{
+			return Derived::PRIORITY;
 		}
 
 		template<typename DerivedEvent>
-		EventRegistrar<DerivedEvent>::EventRegistrar(uint16_t causeId, EventCallback callback)
-			: Event(DerivedEvent::TYPE, causeId, callback)
+		template<typename Derived>
+		constexpr EventPriority
+		EventRegistrar<DerivedEvent>::defaultPriority(long)
 		{
-			static_cast<void>(registered);
+			return EventPriority::NORMAL;
 		}
 	}
 }
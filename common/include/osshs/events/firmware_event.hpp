@@ -0,0 +1,281 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2019 Linas Nikiperavicius
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef OSSHS_FIRMWARE_EVENT_HPP
+#define OSSHS_FIRMWARE_EVENT_HPP
+
+#include <osshs/events/event_registrar.hpp>
+
+namespace osshs
+{
+	namespace events
+	{
+		enum class FirmwareEvent : uint16_t
+		{
+			BASE = 0x04 << 8,
+
+			BEGIN,
+			READY,
+
+			BLOCK,
+			ACKNOWLEDGE,
+
+			FINISH,
+			COMPLETE,
+
+			ERROR
+		};
+
+		enum class FirmwareError : uint8_t
+		{
+			NOT_STARTED,
+			IMAGE_TOO_LARGE,
+			IMAGE_INCOMPLETE,
+			IMAGE_CRC_MISMATCH,
+			FLASH_FAILED,
+			TIMED_OUT
+		};
+
+		class FirmwareBeginEvent : public EventRegistrar<FirmwareBeginEvent>
+		{
+		public:
+			static constexpr uint16_t EVENT_LENGTH = 16;
+			static constexpr uint16_t TYPE = static_cast<uint16_t> (FirmwareEvent::BEGIN);
+
+			FirmwareBeginEvent(std::unique_ptr<const uint8_t[]> data, EventCallback callback = nullptr);
+
+			/**
+			 * @brief Construct an event starting an update. The staging area is erased before it is answered.
+			 * 
+			 * @param imageSize image size in bytes.
+			 * @param imageCrc CRC-32 of the whole image.
+			 * @param causeId event cause id.
+			 * @param callback event callback.
+			 */
+			FirmwareBeginEvent(uint32_t imageSize, uint32_t imageCrc, uint16_t causeId = Event::CAUSE_ID_GENERATE, EventCallback callback = nullptr)
+				: EventRegistrar<FirmwareBeginEvent>(causeId, callback), imageSize(imageSize), imageCrc(imageCrc)
+			{
+			}
+
+			uint32_t
+			getImageSize() const;
+
+			uint32_t
+			getImageCrc() const;
+
+			std::unique_ptr<const uint8_t[]>
+			serialize() const;
+		private:
+			uint32_t imageSize;
+			uint32_t imageCrc;
+		};
+
+		class FirmwareReadyEvent : public EventRegistrar<FirmwareReadyEvent>
+		{
+		public:
+			static constexpr uint16_t EVENT_LENGTH = 11;
+			static constexpr uint16_t TYPE = static_cast<uint16_t> (FirmwareEvent::READY);
+
+			FirmwareReadyEvent(std::unique_ptr<const uint8_t[]> data, EventCallback callback = nullptr);
+
+			/**
+			 * @brief Construct an event accepting an update.
+			 * 
+			 * @param blockSize size of every block but the last one.
+			 * @param window number of blocks which may be sent ahead of the first unacknowledged one.
+			 * @param causeId event cause id.
+			 * @param callback event callback.
+			 */
+			FirmwareReadyEvent(uint16_t blockSize, uint8_t window, uint16_t causeId = Event::CAUSE_ID_GENERATE, EventCallback callback = nullptr)
+				: EventRegistrar<FirmwareReadyEvent>(causeId, callback), blockSize(blockSize), window(window)
+			{
+			}
+
+			uint16_t
+			getBlockSize() const;
+
+			uint8_t
+			getWindow() const;
+
+			std::unique_ptr<const uint8_t[]>
+			serialize() const;
+		private:
+			uint16_t blockSize;
+			uint8_t window;
+		};
+
+		class FirmwareBlockEvent : public EventRegistrar<FirmwareBlockEvent>
+		{
+		public:
+			static constexpr uint16_t EVENT_LENGTH = 0;
+			static constexpr uint16_t PREFIX_LENGTH = 16;
+			static constexpr uint16_t TYPE = static_cast<uint16_t> (FirmwareEvent::BLOCK);
+			static constexpr EventPriority PRIORITY = EventPriority::BULK;
+
+			FirmwareBlockEvent(std::unique_ptr<const uint8_t[]> data, EventCallback callback = nullptr);
+
+			/**
+			 * @brief Construct an event carrying a block of the image.
+			 * 
+			 * @param index block index, the block is placed at index * blockSize.
+			 * @param crc CRC-32 of the block data.
+			 * @param data block data.
+			 * @param dataLen block data length.
+			 * @param causeId event cause id.
+			 * @param callback event callback.
+			 */
+			FirmwareBlockEvent(uint16_t index, uint32_t crc, const std::shared_ptr<uint8_t[]> data, uint16_t dataLen, uint16_t causeId = Event::CAUSE_ID_GENERATE, EventCallback callback = nullptr)
+				: EventRegistrar<FirmwareBlockEvent>(causeId, callback), index(index), crc(crc), data(data), dataLen(dataLen)
+			{
+			}
+
+			uint16_t
+			getIndex() const;
+
+			uint32_t
+			getCrc() const;
+
+			const std::shared_ptr<uint8_t[]>
+			getData() const;
+
+			uint16_t
+			getDataLen() const;
+
+			std::unique_ptr<const uint8_t[]>
+			serialize() const;
+		private:
+			uint16_t index;
+			uint32_t crc;
+			std::shared_ptr<uint8_t[]> data;
+			uint16_t dataLen;
+		};
+
+		class FirmwareAcknowledgeEvent : public EventRegistrar<FirmwareAcknowledgeEvent>
+		{
+		public:
+			static constexpr uint16_t EVENT_LENGTH = 11;
+			static constexpr uint16_t TYPE = static_cast<uint16_t> (FirmwareEvent::ACKNOWLEDGE);
+
+			FirmwareAcknowledgeEvent(std::unique_ptr<const uint8_t[]> data, EventCallback callback = nullptr);
+
+			/**
+			 * @brief Construct an event acknowledging all blocks before nextIndex.
+			 * 
+			 * A block which is out of order or fails its CRC check is answered
+			 * with an unchanged nextIndex, so the sender goes back to it.
+			 * 
+			 * @param nextIndex index of the first block not yet programmed.
+			 * @param window number of blocks which may be sent from nextIndex on.
+			 * @param causeId event cause id.
+			 * @param callback event callback.
+			 */
+			FirmwareAcknowledgeEvent(uint16_t nextIndex, uint8_t window, uint16_t causeId = Event::CAUSE_ID_GENERATE, EventCallback callback = nullptr)
+				: EventRegistrar<FirmwareAcknowledgeEvent>(causeId, callback), nextIndex(nextIndex), window(window)
+			{
+			}
+
+			uint16_t
+			getNextIndex() const;
+
+			uint8_t
+			getWindow() const;
+
+			std::unique_ptr<const uint8_t[]>
+			serialize() const;
+		private:
+			uint16_t nextIndex;
+			uint8_t window;
+		};
+
+		class FirmwareFinishEvent : public EventRegistrar<FirmwareFinishEvent>
+		{
+		public:
+			static constexpr uint16_t EVENT_LENGTH = 9;
+			static constexpr uint16_t TYPE = static_cast<uint16_t> (FirmwareEvent::FINISH);
+
+			FirmwareFinishEvent(std::unique_ptr<const uint8_t[]> data, EventCallback callback = nullptr);
+
+			/**
+			 * @brief Construct an event verifying the staged image and marking it for installation.
+			 * 
+			 * @param restart restart into the bootloader once the update is complete.
+			 * @param causeId event cause id.
+			 * @param callback event callback.
+			 */
+			FirmwareFinishEvent(bool restart, uint16_t causeId = Event::CAUSE_ID_GENERATE, EventCallback callback = nullptr)
+				: EventRegistrar<FirmwareFinishEvent>(causeId, callback), restart(restart)
+			{
+			}
+
+			bool
+			getRestart() const;
+
+			std::unique_ptr<const uint8_t[]>
+			serialize() const;
+		private:
+			bool restart;
+		};
+
+		class FirmwareCompleteEvent : public EventRegistrar<FirmwareCompleteEvent>
+		{
+		public:
+			static constexpr uint16_t EVENT_LENGTH = 8;
+			static constexpr uint16_t TYPE = static_cast<uint16_t> (FirmwareEvent::COMPLETE);
+
+			FirmwareCompleteEvent(std::unique_ptr<const uint8_t[]> data, EventCallback callback = nullptr);
+
+			FirmwareCompleteEvent(uint16_t causeId = Event::CAUSE_ID_GENERATE, EventCallback callback = nullptr)
+				: EventRegistrar<FirmwareCompleteEvent>(causeId, callback)
+			{
+			}
+
+			std::unique_ptr<const uint8_t[]>
+			serialize() const;
+		};
+
+		class FirmwareErrorEvent : public EventRegistrar<FirmwareErrorEvent>
+		{
+		public:
+			static constexpr uint16_t EVENT_LENGTH = 9;
+			static constexpr uint16_t TYPE = static_cast<uint16_t> (FirmwareEvent::ERROR);
+
+			FirmwareErrorEvent(std::unique_ptr<const uint8_t[]> data, EventCallback callback = nullptr);
+
+			FirmwareErrorEvent(FirmwareError error, uint16_t causeId = Event::CAUSE_ID_GENERATE, EventCallback callback = nullptr)
+				: EventRegistrar<FirmwareErrorEvent>(causeId, callback), error(error)
+			{
+			}
+
+			FirmwareError
+			getError() const;
+
+			std::unique_ptr<const uint8_t[]>
+			serialize() const;
+		private:
+			FirmwareError error;
+		};
+	}
+}
+
+#endif  // OSSHS_FIRMWARE_EVENT_HPP
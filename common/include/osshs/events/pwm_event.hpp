@@ -52,7 +52,10 @@ namespace osshs
 			UPDATE_RGBW_CHANNEL,
 
 			UPDATE_SUCCESS,
-			ERROR
+			ERROR,
+
+			STORE_SCENE,
+			RECALL_SCENE
 		};
 
 		enum class PwmStatus : uint8_t
@@ -64,7 +67,10 @@ namespace osshs
 		enum class PwmError : uint8_t
 		{
 			CHANNEL_OUT_OF_BOUNDS,
-			VALUE_OUT_OF_BOUNDS
+			VALUE_OUT_OF_BOUNDS,
+			SCENE_OUT_OF_BOUNDS,
+			SCENE_NOT_STORED,
+			STORAGE_FAILED
 		};
 
 		typedef struct PwmRgbwValue
@@ -94,8 +100,9 @@ namespace osshs
 		class PwmRequestStatusEvent : public EventRegistrar<PwmRequestStatusEvent>
 		{
 		public:
-			static constexpr uint16_t EVENT_LENGTH = 6;
+			static constexpr uint16_t EVENT_LENGTH = 8;
 			static constexpr uint16_t TYPE = static_cast<uint16_t> (PwmEvent::REQUEST_STATUS);
+			static constexpr EventPriority PRIORITY = EventPriority::CONTROL;
 
 			PwmRequestStatusEvent(std::unique_ptr<const uint8_t[]> data, EventCallback callback = nullptr);
 
@@ -111,8 +118,9 @@ namespace osshs
 		class PwmStatusReadyEvent : public EventRegistrar<PwmStatusReadyEvent>
 		{
 		public:
-			static constexpr uint16_t EVENT_LENGTH = 7;
+			static constexpr uint16_t EVENT_LENGTH = 9;
 			static constexpr uint16_t TYPE = static_cast<uint16_t> (PwmEvent::STATUS_READY);
+			static constexpr EventPriority PRIORITY = EventPriority::CONTROL;
 
 			PwmStatusReadyEvent(std::unique_ptr<const uint8_t[]> data, EventCallback callback = nullptr);
 
@@ -133,8 +141,9 @@ namespace osshs
 		class PwmEnableEvent : public EventRegistrar<PwmEnableEvent>
 		{
 		public:
-			static constexpr uint16_t EVENT_LENGTH = 6;
+			static constexpr uint16_t EVENT_LENGTH = 8;
 			static constexpr uint16_t TYPE = static_cast<uint16_t> (PwmEvent::ENABLE);
+			static constexpr EventPriority PRIORITY = EventPriority::CONTROL;
 
 			PwmEnableEvent(std::unique_ptr<const uint8_t[]> data, EventCallback callback = nullptr);
 
@@ -150,8 +159,9 @@ namespace osshs
 		class PwmDisableEvent : public EventRegistrar<PwmDisableEvent>
 		{
 		public:
-			static constexpr uint16_t EVENT_LENGTH = 6;
+			static constexpr uint16_t EVENT_LENGTH = 8;
 			static constexpr uint16_t TYPE = static_cast<uint16_t> (PwmEvent::DISABLE);
+			static constexpr EventPriority PRIORITY = EventPriority::CONTROL;
 
 			PwmDisableEvent(std::unique_ptr<const uint8_t[]> data, EventCallback callback = nullptr);
 
@@ -167,8 +177,9 @@ namespace osshs
 		class PwmRequestChannelEvent : public EventRegistrar<PwmRequestChannelEvent>
 		{
 		public:
-			static constexpr uint16_t EVENT_LENGTH = 8;
+			static constexpr uint16_t EVENT_LENGTH = 10;
 			static constexpr uint16_t TYPE = static_cast<uint16_t> (PwmEvent::REQUEST_CHANNEL);
+			static constexpr EventPriority PRIORITY = EventPriority::CONTROL;
 
 			PwmRequestChannelEvent(std::unique_ptr<const uint8_t[]> data, EventCallback callback = nullptr);
 
@@ -189,8 +200,9 @@ namespace osshs
 		class PwmChannelReadyEvent : public EventRegistrar<PwmChannelReadyEvent>
 		{
 		public:
-			static constexpr uint16_t EVENT_LENGTH = 10;
+			static constexpr uint16_t EVENT_LENGTH = 12;
 			static constexpr uint16_t TYPE = static_cast<uint16_t> (PwmEvent::CHANNEL_READY);
+			static constexpr EventPriority PRIORITY = EventPriority::CONTROL;
 
 			PwmChannelReadyEvent(std::unique_ptr<const uint8_t[]> data, EventCallback callback = nullptr);
 
@@ -215,8 +227,9 @@ namespace osshs
 		class PwmUpdateChannelEvent : public EventRegistrar<PwmUpdateChannelEvent>
 		{
 		public:
-			static constexpr uint16_t EVENT_LENGTH = 10;
+			static constexpr uint16_t EVENT_LENGTH = 12;
 			static constexpr uint16_t TYPE = static_cast<uint16_t> (PwmEvent::UPDATE_CHANNEL);
+			static constexpr EventPriority PRIORITY = EventPriority::CONTROL;
 
 			PwmUpdateChannelEvent(std::unique_ptr<const uint8_t[]> data, EventCallback callback = nullptr);
 
@@ -241,8 +254,9 @@ namespace osshs
 		class PwmRequestRgbwChannelEvent : public EventRegistrar<PwmRequestRgbwChannelEvent>
 		{
 		public:
-			static constexpr uint16_t EVENT_LENGTH = 8;
+			static constexpr uint16_t EVENT_LENGTH = 10;
 			static constexpr uint16_t TYPE = static_cast<uint16_t> (PwmEvent::REQUEST_RGBW_CHANNEL);
+			static constexpr EventPriority PRIORITY = EventPriority::CONTROL;
 
 			PwmRequestRgbwChannelEvent(std::unique_ptr<const uint8_t[]> data, EventCallback callback = nullptr);
 
@@ -263,8 +277,9 @@ namespace osshs
 		class PwmRgbwChannelReadyEvent : public EventRegistrar<PwmRgbwChannelReadyEvent>
 		{
 		public:
-			static constexpr uint16_t EVENT_LENGTH = 16;
+			static constexpr uint16_t EVENT_LENGTH = 18;
 			static constexpr uint16_t TYPE = static_cast<uint16_t> (PwmEvent::RGBW_CHANNEL_READY);
+			static constexpr EventPriority PRIORITY = EventPriority::CONTROL;
 
 			PwmRgbwChannelReadyEvent(std::unique_ptr<const uint8_t[]> data, EventCallback callback = nullptr);
 
@@ -289,8 +304,9 @@ namespace osshs
 		class PwmUpdateRgbwChannelEvent : public EventRegistrar<PwmUpdateRgbwChannelEvent>
 		{
 		public:
-			static constexpr uint16_t EVENT_LENGTH = 16;
+			static constexpr uint16_t EVENT_LENGTH = 18;
 			static constexpr uint16_t TYPE = static_cast<uint16_t> (PwmEvent::UPDATE_RGBW_CHANNEL);
+			static constexpr EventPriority PRIORITY = EventPriority::CONTROL;
 
 			PwmUpdateRgbwChannelEvent(std::unique_ptr<const uint8_t[]> data, EventCallback callback = nullptr);
 
@@ -312,11 +328,77 @@ namespace osshs
 			PwmRgbwValue value;
 		};
 
+		class PwmStoreSceneEvent : public EventRegistrar<PwmStoreSceneEvent>
+		{
+		public:
+			static constexpr uint16_t EVENT_LENGTH = 11;
+			static constexpr uint16_t TYPE = static_cast<uint16_t> (PwmEvent::STORE_SCENE);
+			static constexpr EventPriority PRIORITY = EventPriority::CONTROL;
+
+			PwmStoreSceneEvent(std::unique_ptr<const uint8_t[]> data, EventCallback callback = nullptr);
+
+			/**
+			 * @brief Construct an event storing the current output of all channels as a scene.
+			 * 
+			 * @param scene scene index.
+			 * @param fadeTime time in milliseconds to fade to the scene when it is recalled.
+			 * @param causeId event cause id.
+			 * @param callback event callback.
+			 */
+			PwmStoreSceneEvent(uint8_t scene, uint16_t fadeTime, uint16_t causeId = Event::CAUSE_ID_GENERATE, EventCallback callback = nullptr)
+				: EventRegistrar<PwmStoreSceneEvent>(causeId, callback), scene(scene), fadeTime(fadeTime)
+			{
+			}
+
+			uint8_t
+			getScene() const;
+
+			uint16_t
+			getFadeTime() const;
+
+			std::unique_ptr<const uint8_t[]>
+			serialize() const;
+		private:
+			uint8_t scene;
+			uint16_t fadeTime;
+		};
+
+		class PwmRecallSceneEvent : public EventRegistrar<PwmRecallSceneEvent>
+		{
+		public:
+			static constexpr uint16_t EVENT_LENGTH = 9;
+			static constexpr uint16_t TYPE = static_cast<uint16_t> (PwmEvent::RECALL_SCENE);
+			static constexpr EventPriority PRIORITY = EventPriority::CONTROL;
+
+			PwmRecallSceneEvent(std::unique_ptr<const uint8_t[]> data, EventCallback callback = nullptr);
+
+			/**
+			 * @brief Construct an event fading all channels to a stored scene.
+			 * 
+			 * @param scene scene index.
+			 * @param causeId event cause id.
+			 * @param callback event callback.
+			 */
+			PwmRecallSceneEvent(uint8_t scene, uint16_t causeId = Event::CAUSE_ID_GENERATE, EventCallback callback = nullptr)
+				: EventRegistrar<PwmRecallSceneEvent>(causeId, callback), scene(scene)
+			{
+			}
+
+			uint8_t
+			getScene() const;
+
+			std::unique_ptr<const uint8_t[]>
+			serialize() const;
+		private:
+			uint8_t scene;
+		};
+
 		class PwmUpdateSuccessEvent : public EventRegistrar<PwmUpdateSuccessEvent>
 		{
 		public:
-			static constexpr uint16_t EVENT_LENGTH = 6;
+			static constexpr uint16_t EVENT_LENGTH = 8;
 			static constexpr uint16_t TYPE = static_cast<uint16_t> (PwmEvent::UPDATE_SUCCESS);
+			static constexpr EventPriority PRIORITY = EventPriority::CONTROL;
 
 			PwmUpdateSuccessEvent(std::unique_ptr<const uint8_t[]> data, EventCallback callback = nullptr);
 
@@ -332,8 +414,9 @@ namespace osshs
 		class PwmErrorEvent : public EventRegistrar<PwmErrorEvent>
 		{
 		public:
-			static constexpr uint16_t EVENT_LENGTH = 7;
+			static constexpr uint16_t EVENT_LENGTH = 9;
 			static constexpr uint16_t TYPE = static_cast<uint16_t> (PwmEvent::ERROR);
+			static constexpr EventPriority PRIORITY = EventPriority::CONTROL;
 
 			PwmErrorEvent(std::unique_ptr<const uint8_t[]> data, EventCallback callback = nullptr);
 
@@ -0,0 +1,71 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2019 Linas Nikiperavicius
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef OSSHS_SYSTEM_EVENT_HPP
+#define OSSHS_SYSTEM_EVENT_HPP
+
+#include <osshs/events/event_registrar.hpp>
+
+namespace osshs
+{
+	namespace events
+	{
+		enum class SystemEvent : uint16_t
+		{
+			BASE = 0x00 << 8,
+
+			ERROR
+		};
+
+		enum class SystemError : uint8_t
+		{
+			TIMEOUT,
+			UNSUPPORTED_EVENT,
+			REJECTED
+		};
+
+		class SystemErrorEvent : public EventRegistrar<SystemErrorEvent>
+		{
+		public:
+			static constexpr uint16_t EVENT_LENGTH = 9;
+			static constexpr uint16_t TYPE = static_cast<uint16_t> (SystemEvent::ERROR);
+
+			SystemErrorEvent(std::unique_ptr<const uint8_t[]> data, EventCallback callback = nullptr);
+
+			SystemErrorEvent(SystemError error, uint16_t causeId = Event::CAUSE_ID_GENERATE, EventCallback callback = nullptr)
+				: EventRegistrar<SystemErrorEvent>(causeId, callback), error(error)
+			{
+			}
+
+			SystemError
+			getError() const;
+
+			std::unique_ptr<const uint8_t[]>
+			serialize() const;
+		private:
+			SystemError error;
+		};
+	}
+}
+#endif  // OSSHS_SYSTEM_EVENT_HPP
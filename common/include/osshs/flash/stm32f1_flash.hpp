@@ -0,0 +1,109 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2019 Linas Nikiperavicius
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef OSSHS_STM32F1_FLASH_HPP
+#define OSSHS_STM32F1_FLASH_HPP
+
+#include <cstdint>
+
+namespace osshs
+{
+	namespace flash
+	{
+		/**
+		 * @brief Internal flash of high density STM32F1 devices (2 KiB pages).
+		 * 
+		 * Operations are split into start, isBusy() and finish(), so callers can
+		 * wait in a protothread instead of spinning. The flash must be unlocked
+		 * before erasing or programming. Note that the CPU stalls on instruction
+		 * fetches while an operation is running, interrupts included.
+		 */
+		class Stm32f1Flash
+		{
+		public:
+			static constexpr uint32_t PAGE_SIZE = 2048;
+
+			/**
+			 * @brief Unlock the flash for erasing and programming.
+			 * 
+			 */
+			static void
+			unlock();
+
+			/**
+			 * @brief Lock the flash until the next unlock.
+			 * 
+			 */
+			static void
+			lock();
+
+			/**
+			 * @brief Start erasing a page.
+			 * 
+			 * @param address address within the page.
+			 */
+			static void
+			startErase(uint32_t address);
+
+			/**
+			 * @brief Start programming a half-word.
+			 * 
+			 * @param address half-word aligned address of an erased location.
+			 * @param value value to program.
+			 */
+			static void
+			startProgram(uint32_t address, uint16_t value);
+
+			/**
+			 * @brief Check if an operation is running.
+			 * 
+			 */
+			static bool
+			isBusy();
+
+			/**
+			 * @brief End the last operation once it is not busy anymore.
+			 * 
+			 * @return true operation succeeded.
+			 * @return false the location was not erased or is write protected.
+			 */
+			static bool
+			finish();
+
+			/**
+			 * @brief Get a pointer to flash contents.
+			 * 
+			 * @param address flash address.
+			 * @return const uint8_t* memory mapped contents.
+			 */
+			static const uint8_t *
+			getData(uint32_t address);
+		private:
+			static constexpr uint32_t KEY1 = 0x45670123;
+			static constexpr uint32_t KEY2 = 0xcdef89ab;
+		};
+	}
+}
+
+#endif  // OSSHS_STM32F1_FLASH_HPP
@@ -0,0 +1,103 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2019 Linas Nikiperavicius
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef OSSHS_LOG_BUFFER_HPP
+#define OSSHS_LOG_BUFFER_HPP
+
+#include <cstddef>
+#include <cstdint>
+
+#ifndef LOG_BUFFER_SIZE
+	#define LOG_BUFFER_SIZE 1024
+#endif  // LOG_BUFFER_SIZE
+
+namespace osshs
+{
+	namespace log
+	{
+		class LogBuffer
+		{
+		public:
+			static constexpr std::size_t SIZE = LOG_BUFFER_SIZE;
+
+			LogBuffer();
+
+			/**
+			 * @brief Append data to the buffer. Either all of the data is appended or none of it.
+			 * 
+			 * @param data data to append.
+			 * @param length data length.
+			 * @return true data was appended.
+			 * @return false not enough free space, nothing was appended.
+			 */
+			bool
+			write(const uint8_t *data, std::size_t length);
+
+			/**
+			 * @brief Get the oldest contiguous block of buffered data without consuming it.
+			 * 
+			 * @param data set to the start of the block.
+			 * @return std::size_t block length, 0 if the buffer is empty.
+			 */
+			std::size_t
+			peek(const uint8_t *&data) const;
+
+			/**
+			 * @brief Release data previously returned by peek.
+			 * 
+			 * @param length number of bytes to release.
+			 */
+			void
+			consume(std::size_t length);
+
+			/**
+			 * @brief Free space getter.
+			 * 
+			 * @return std::size_t number of bytes that can be written.
+			 */
+			std::size_t
+			getFree() const;
+
+			/**
+			 * @brief Check whether the buffer is empty.
+			 * 
+			 * @return true buffer is empty.
+			 * @return false buffer contains data.
+			 */
+			bool
+			isEmpty() const;
+		private:
+			uint8_t data[SIZE];
+			volatile std::size_t head;
+			volatile std::size_t tail;
+
+			LogBuffer(const LogBuffer&) = delete;
+
+			LogBuffer&
+			operator=(const LogBuffer&) = delete;
+		};
+	}
+}
+
+#endif  // OSSHS_LOG_BUFFER_HPP
@@ -0,0 +1,77 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2019 Linas Nikiperavicius
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef OSSHS_LOG_DRAIN_HPP
+#define OSSHS_LOG_DRAIN_HPP
+
+#include <osshs/log/log_buffer.hpp>
+
+namespace osshs
+{
+	namespace log
+	{
+		class LogDrain
+		{
+		public:
+			/**
+			 * @brief Move buffered log data to the output without blocking. Called from the main loop.
+			 * 
+			 * @param buffer buffer to drain.
+			 */
+			virtual void
+			update(LogBuffer &buffer) = 0;
+
+			/**
+			 * @brief Block until all buffered log data has been written.
+			 * The default implementation busy-waits by calling update() until the buffer is empty.
+			 * 
+			 * @param buffer buffer to drain.
+			 */
+			virtual void
+			flush(LogBuffer &buffer);
+		};
+
+		template<typename Uart>
+		class UartLogDrain : public LogDrain
+		{
+		public:
+			/**
+			 * @brief Copy as much buffered data into the UART transmit buffer as fits.
+			 * 
+			 * @param buffer buffer to drain.
+			 */
+			void
+			update(LogBuffer &buffer)
+			{
+				const uint8_t *data;
+				std::size_t length = buffer.peek(data);
+
+				if (length > 0)
+					buffer.consume(Uart::write(data, length));
+			}
+		};
+	}
+}
+
+#endif  // OSSHS_LOG_DRAIN_HPP
@@ -0,0 +1,89 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2019 Linas Nikiperavicius
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef OSSHS_LOG_LINE_HPP
+#define OSSHS_LOG_LINE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <modm/io/iodevice.hpp>
+
+#ifndef LOG_LINE_LENGTH
+	#define LOG_LINE_LENGTH 160
+#endif  // LOG_LINE_LENGTH
+
+namespace osshs
+{
+	namespace log
+	{
+		/**
+		 * @brief IODevice that formats a single log line into memory, so it can be
+		 * committed to the log buffer as a whole. Characters past the end are discarded.
+		 * 
+		 */
+		class LogLine : public modm::IODevice
+		{
+		public:
+			static constexpr std::size_t LENGTH = LOG_LINE_LENGTH;
+
+			LogLine();
+
+			using modm::IODevice::write;
+
+			void
+			write(char c);
+
+			void
+			flush();
+
+			bool
+			read(char &c);
+
+			/**
+			 * @brief Discard the line.
+			 * 
+			 */
+			void
+			clear();
+
+			/**
+			 * @brief Terminate the line with "\r\n", overwriting the end of a truncated line.
+			 * 
+			 */
+			void
+			terminate();
+
+			const uint8_t *
+			getData() const;
+
+			std::size_t
+			getLength() const;
+		private:
+			uint8_t data[LENGTH];
+			std::size_t length;
+		};
+	}
+}
+
+#endif  // OSSHS_LOG_LINE_HPP
@@ -25,28 +25,61 @@
 #ifndef OSSHS_LOGGER_HPP
 #define OSSHS_LOGGER_HPP
 
-#include <modm/debug/logger.hpp>
+#include <modm/io/iostream.hpp>
+#include <osshs/log/log_buffer.hpp>
+#include <osshs/log/log_drain.hpp>
+#include <osshs/log/log_line.hpp>
 
 #ifndef DISABLE_LOGGING
 	#define __FILENAME__ (__builtin_strrchr(__FILE__, '/') ? __builtin_strrchr(__FILE__, '/') + 1 : __FILE__)
 
-	#define OSSHS_ENABLE_LOGGER(device, behavior) \
-		modm::IODeviceWrapper<device, behavior> loggerDevice; \
-		modm::log::Logger osshs::log::logger(loggerDevice);
+	// Drains the log buffer into the (non-blocking) transmit buffer of a modm UART.
+	#define OSSHS_ENABLE_LOGGER(device) \
+		osshs::log::UartLogDrain<device> logDrainInstance; \
+		osshs::log::LogDrain &osshs::log::logDrain = logDrainInstance;
 
-	#define OSSHS_LOG_ERROR(format, args...)   osshs::log::Logger::log(osshs::log::Level::ERROR  , __FILENAME__, __LINE__, format, ##args);
-	#define OSSHS_LOG_WARNING(format, args...) osshs::log::Logger::log(osshs::log::Level::WARNING, __FILENAME__, __LINE__, format, ##args);
-	#define OSSHS_LOG_INFO(format, args...)    osshs::log::Logger::log(osshs::log::Level::INFO   , __FILENAME__, __LINE__, format, ##args);
-	#define OSSHS_LOG_DEBUG(format, args...)   osshs::log::Logger::log(osshs::log::Level::DEBUG  , __FILENAME__, __LINE__, format, ##args);
+	/**
+	 * Most verbose level that is compiled in. Calls above it are removed together with their
+	 * arguments. Can be set globally (e.g. -DOSSHS_LOG_COMPILE_LEVEL=INFO) or redefined in a
+	 * single file, since it is evaluated wherever a log macro is expanded.
+	 */
+	#ifndef OSSHS_LOG_COMPILE_LEVEL
+		#define OSSHS_LOG_COMPILE_LEVEL DEBUG
+	#endif  // OSSHS_LOG_COMPILE_LEVEL
 
-	#define OSSHS_LOG_FLUSH() osshs::log::Logger::flush();
-	#define OSSHS_LOG_SET_LEVEL(level) osshs::log::Logger::setLevel(level);
+	#ifdef ENABLE_TOKENIZED_LOGGING
+		#define OSSHS_LOG_WRITE(level, format, args...) osshs::log::Logger::logTokenized<osshs::log::tokenize(__FILENAME__, format)>(level, ##args)
+	#else  // ENABLE_TOKENIZED_LOGGING
+		#define OSSHS_LOG_WRITE(level, format, args...) osshs::log::Logger::log(level, __FILENAME__, __LINE__, format, ##args)
+	#endif  // ENABLE_TOKENIZED_LOGGING
+
+	// The runtime level is checked before any of the arguments are evaluated. The do-while
+	// makes every log macro a single statement, which is safe in an unbraced if/else.
+	#define OSSHS_LOG_MESSAGE(level, format, args...) \
+		do \
+		{ \
+			if constexpr (level <= osshs::log::Level::OSSHS_LOG_COMPILE_LEVEL) \
+			{ \
+				if (osshs::log::Logger::isEnabled(level)) \
+					OSSHS_LOG_WRITE(level, format, ##args); \
+			} \
+		} \
+		while (0)
+
+	#define OSSHS_LOG_ERROR(format, args...)   OSSHS_LOG_MESSAGE(osshs::log::Level::ERROR  , format, ##args)
+	#define OSSHS_LOG_WARNING(format, args...) OSSHS_LOG_MESSAGE(osshs::log::Level::WARNING, format, ##args)
+	#define OSSHS_LOG_INFO(format, args...)    OSSHS_LOG_MESSAGE(osshs::log::Level::INFO   , format, ##args)
+	#define OSSHS_LOG_DEBUG(format, args...)   OSSHS_LOG_MESSAGE(osshs::log::Level::DEBUG  , format, ##args)
+
+	#define OSSHS_LOG_FLUSH() osshs::log::Logger::flush()
+	#define OSSHS_LOG_UPDATE() osshs::log::Logger::update()
+	#define OSSHS_LOG_SET_LEVEL(level) osshs::log::Logger::setLevel(level)
 
 	namespace osshs
 	{
 		namespace log
 		{
-			extern modm::log::Logger logger;
+			extern LogDrain &logDrain;
 
 			enum class Level : uint8_t
 			{
@@ -57,9 +90,42 @@
 				DEBUG
 			};
 
+			/**
+			 * @brief Compute the token of a log message at compile time.
+			 * @note Must match the hash computed by tools/log_decoder.py.
+			 * @param filename File from which the message was logged. Usually __FILENAME__.
+			 * @param format Log message format.
+			 * @return 32-bit FNV-1a hash of "filename:format".
+			 */
+			constexpr uint32_t
+			tokenize(const char *filename, const char *format)
+			{
+				uint32_t hash = 2166136261u;
+
+				while (*filename != '\0')
+					hash = (hash ^ static_cast<uint8_t>(*filename++)) * 16777619u;
+
+				hash = (hash ^ static_cast<uint8_t>(':')) * 16777619u;
+
+				while (*format != '\0')
+					hash = (hash ^ static_cast<uint8_t>(*format++)) * 16777619u;
+
+				return hash;
+			}
+
+			/**
+			 * @brief Formats messages into a LogBuffer of LOG_BUFFER_SIZE bytes, which is emptied
+			 * by the log drain from update(). Nothing leaves the buffer before the first update(),
+			 * so messages beyond its size are dropped and counted until then. System drains the
+			 * buffer after each boot step for this reason.
+			 */
 			class Logger
 			{
 				public:
+					static constexpr uint8_t RECORD_MAGIC = 0xa5;
+					static constexpr uint8_t RECORD_HEADER_LENGTH = 11;
+					static constexpr uint32_t DROPPED_TOKEN = 0;
+
 					/**
 					 * @brief Set current logger level.
 					 * @param level One of: osshs::log::DEBUG, osshs::log::INFO, osshs::log::WARNING, osshs::log::ERROR or osshs::log::DISABLED.
@@ -67,6 +133,21 @@
 					static void
 					setLevel(Level level);
 
+					/**
+					 * @brief Get current logger level.
+					 * @return Current runtime level.
+					 */
+					static Level
+					getLevel();
+
+					/**
+					 * @brief Check whether messages of a level pass the current runtime level.
+					 * @param level One of: osshs::log::DEBUG, osshs::log::INFO, osshs::log::WARNING or osshs::log::ERROR.
+					 * @return true if messages of this level are written.
+					 */
+					static bool
+					isEnabled(Level level);
+
 					/**
 					 * @brief Write a log message.
 					 * @note Should not be called directly, instead use the predefined macros.
@@ -81,27 +162,84 @@
 					log(Level level, const char *filename, uint32_t line, const char *format, ARGS... args);
 
 					/**
-					 * @brief Flush the underlying stream.
+					 * @brief Write a tokenized log record into the log buffer.
+					 * The record is [magic][length][token][timestamp][level][arguments...],
+					 * where length counts the bytes following it and every argument is
+					 * encoded as a little-endian 32-bit word.
+					 * @note Should not be called directly, instead use the predefined macros.
+					 * @tparam token Message token, computed by tokenize().
+					 * @param level One of: osshs::log::DEBUG, osshs::log::INFO, osshs::log::WARNING, osshs::log::ERROR or osshs::log::DISABLED.
+					 * @param args Log message format arguments. Must be integers, enums or pointers.
+					 */
+					template<uint32_t token, typename... ARGS>
+					static void
+					logTokenized(Level level, ARGS... args);
+
+					/**
+					 * @brief Hand buffered log data to the log drain. Called from the main loop.
+					 */
+					static void
+					update();
+
+					/**
+					 * @brief Block until the log buffer has been drained.
+					 * @note Busy-waits on the log drain, which takes about 90 ms for a full buffer at
+					 * 115200 Bd. A DMA drain empties the buffer from its interrupt, so this must not
+					 * be called with interrupts disabled.
 					 */
 					static void
 					flush();
+
+					/**
+					 * @brief Get the number of messages dropped because the log buffer was full.
+					 * @return Messages dropped since boot.
+					 */
+					static uint32_t
+					getDroppedTotal();
+
+					/**
+					 * @brief Get the free space in the log buffer, so bulk output can wait instead of being dropped.
+					 * @return Number of bytes that can be buffered.
+					 */
+					static std::size_t
+					getFree();
 				private:
 					static Level level;
+					static LogBuffer buffer;
+					static LogLine message;
+					static modm::IOStream stream;
+					static uint32_t dropped;
+					static uint32_t droppedTotal;
+
+					/**
+					 * @brief Append a complete message to the log buffer. If messages were dropped
+					 * before, a marker carrying their count is appended first. Messages that do not
+					 * fit are dropped and counted, logging never waits for the output.
+					 * @param data Formatted message or tokenized record.
+					 * @param length Message length.
+					 */
+					static void
+					commit(const uint8_t *data, std::size_t length);
+
+					template<typename T>
+					static uint32_t
+					encodeArgument(T arg);
 			};
 		}
 	}
 
 	#include <osshs/log/logger_impl.hpp>
 #else  // DISABLE_LOGGING
-	#define OSSHS_ENABLE_LOGGER(device, behavior)
+	#define OSSHS_ENABLE_LOGGER(device)
 
-	#define OSSHS_LOG_ERROR(format, args...)
-	#define OSSHS_LOG_WARNING(format, args...)
-	#define OSSHS_LOG_INFO(format, args...)
-	#define OSSHS_LOG_DEBUG(format, args...)
+	#define OSSHS_LOG_ERROR(format, args...)   do { } while (0)
+	#define OSSHS_LOG_WARNING(format, args...) do { } while (0)
+	#define OSSHS_LOG_INFO(format, args...)    do { } while (0)
+	#define OSSHS_LOG_DEBUG(format, args...)   do { } while (0)
 
-	#define OSSHS_LOG_FLUSH()
-	#define OSSHS_LOG_SET_LEVEL(level)
+	#define OSSHS_LOG_FLUSH() do { } while (0)
+	#define OSSHS_LOG_UPDATE() do { } while (0)
+	#define OSSHS_LOG_SET_LEVEL(level) do { } while (0)
 #endif  // DISABLE_LOGGING
 
 #endif  // OSSHS_LOGGER_HPP
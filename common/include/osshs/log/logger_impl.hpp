@@ -26,13 +26,22 @@
 	#error "Don't include this file directly, use 'logger.hpp' instead!"
 #endif
 
+#include <initializer_list>
+#include <type_traits>
 #include <modm/platform.hpp>
 #include <magic_enum.hpp>
+#include <osshs/time.hpp>
 
 namespace osshs
 {
 	namespace log
 	{
+		inline bool
+		Logger::isEnabled(Level level)
+		{
+			return level <= Logger::level;
+		}
+
 		template<typename... ARGS>
 		void
 		Logger::log(Level level, const char *filename, uint32_t line, const char *format, ARGS... args)
@@ -40,16 +49,77 @@ namespace osshs
 			if (level > Logger::level)
 				return;
 
-			logger.printf(
-				"[%.3f][%s][%s:%lu] ",
-				static_cast<double>(modm::Clock::now().getTime() / 1000.0),
-				std::string(magic_enum::enum_name(level)).c_str(),
+			uint32_t timestamp = Time::getSystemTime<uint32_t, Time::Precision::Milliseconds>();
+
+			message.clear();
+
+			stream.printf(
+				"[%lu.%03lu][%s][%s:%lu] ",
+				timestamp / 1000,
+				timestamp % 1000,
+				magic_enum::enum_name(level).data(),
 				filename,
 				line
 			);
 
-			logger.printf(format, args...);
-			logger.printf("\r\n");
+			stream.printf(format, args...);
+			message.terminate();
+
+			commit(message.getData(), message.getLength());
+		}
+
+		template<uint32_t token, typename... ARGS>
+		void
+		Logger::logTokenized(Level level, ARGS... args)
+		{
+			static_assert(((std::is_integral_v<ARGS> || std::is_enum_v<ARGS> || std::is_pointer_v<ARGS>) && ...),
+				"Tokenized log arguments must be integers, enums or pointers.");
+			static_assert(((!std::is_same_v<std::remove_cv_t<std::remove_pointer_t<ARGS>>, char>) && ...),
+				"Strings can not be logged in tokenized mode.");
+			static_assert(((sizeof(ARGS) <= sizeof(uint32_t)) && ...),
+				"Tokenized log arguments must fit into 32 bits.");
+
+			if (level > Logger::level)
+				return;
+
+			uint8_t record[RECORD_HEADER_LENGTH + sizeof...(ARGS) * sizeof(uint32_t)];
+			uint32_t timestamp = Time::getSystemTime<uint32_t, Time::Precision::Milliseconds>();
+			std::size_t offset = RECORD_HEADER_LENGTH;
+
+			record[0] = RECORD_MAGIC;
+			record[1] = sizeof(record) - 2;
+
+			record[2] = token & 0xff;
+			record[3] = (token >> 8) & 0xff;
+			record[4] = (token >> 16) & 0xff;
+			record[5] = (token >> 24) & 0xff;
+
+			record[6] = timestamp & 0xff;
+			record[7] = (timestamp >> 8);
+			record[8] = (timestamp >> 16);
+			record[9] = (timestamp >> 24);
+
+			record[10] = static_cast<uint8_t>(level);
+
+			for (uint32_t argument : std::initializer_list<uint32_t>{encodeArgument(args)...})
+			{
+				record[offset++] = argument & 0xff;
+				record[offset++] = (argument >> 8);
+				record[offset++] = (argument >> 16);
+				record[offset++] = (argument >> 24);
+			}
+
+			commit(record, sizeof(record));
+		}
+
+		template<typename T>
+		uint32_t
+		Logger::encodeArgument(T arg)
+		{
+			if constexpr (std::is_pointer_v<T>)
+				return static_cast<uint32_t>(reinterpret_cast<uintptr_t>(arg));
+			else
+				return static_cast<uint32_t>(arg);
 		}
 	}
 }
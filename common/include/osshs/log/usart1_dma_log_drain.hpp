@@ -0,0 +1,82 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2019 Linas Nikiperavicius
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef OSSHS_USART1_DMA_LOG_DRAIN_HPP
+#define OSSHS_USART1_DMA_LOG_DRAIN_HPP
+
+#include <osshs/log/log_drain.hpp>
+#include <osshs/log/logger.hpp>
+
+#ifndef DISABLE_LOGGING
+	// Drains the log buffer to USART1 with DMA, see Usart1DmaLogDrain. STM32F1 only.
+	#define OSSHS_ENABLE_DMA_LOGGER() \
+		osshs::log::Usart1DmaLogDrain logDrainInstance; \
+		osshs::log::LogDrain &osshs::log::logDrain = logDrainInstance; \
+		MODM_ISR(DMA1_Channel4) \
+		{ \
+			logDrainInstance.handleInterrupt(); \
+		}
+#else  // DISABLE_LOGGING
+	#define OSSHS_ENABLE_DMA_LOGGER()
+#endif  // DISABLE_LOGGING
+
+namespace osshs
+{
+	namespace log
+	{
+		/**
+		 * @brief Drains the log buffer to USART1 with DMA1 channel 4 (STM32F1).
+		 * The next contiguous block is started from the transfer complete
+		 * interrupt, so the CPU only touches the log output to start a burst.
+		 * 
+		 */
+		class Usart1DmaLogDrain : public LogDrain
+		{
+		public:
+			Usart1DmaLogDrain();
+
+			void
+			update(LogBuffer &buffer);
+
+			/**
+			 * @brief Handle the DMA1 channel 4 interrupt.
+			 * 
+			 */
+			void
+			handleInterrupt();
+		private:
+			LogBuffer *buffer;
+			volatile std::size_t transferLength;
+			bool initialized;
+
+			void
+			initialize();
+
+			void
+			startTransfer();
+		};
+	}
+}
+
+#endif  // OSSHS_USART1_DMA_LOG_DRAIN_HPP
@@ -0,0 +1,97 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2019 Linas Nikiperavicius
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef OSSHS_MEMORY_STATISTICS_HPP
+#define OSSHS_MEMORY_STATISTICS_HPP
+
+#ifdef ENABLE_MEMORY_STATISTICS
+	#include <cstddef>
+	#include <cstdint>
+
+	#include <osshs/events/diagnostics_event.hpp>
+
+	namespace osshs
+	{
+		/**
+		 * @brief Heap and stack usage statistics.
+		 * 
+		 * The heap is tracked by wrapping malloc, free, realloc and calloc at link time
+		 * (-Wl,--wrap=malloc,... see SCons option memory_statistics=1), which also covers
+		 * operator new. The stack is painted with a pattern at initialization and the high
+		 * water mark is found by looking for the deepest overwritten word.
+		 * 
+		 * The largest free block is read from the newlib-nano free list and the space left
+		 * below the heap end, so collecting statistics never allocates.
+		 */
+		class MemoryStatistics
+		{
+		public:
+			static constexpr uint32_t STACK_PATTERN = 0xa5a5a5a5;
+
+			/**
+			 * @brief Paint the unused part of the main stack. Should be called as early as possible.
+			 * 
+			 */
+			static void
+			initialize();
+
+			/**
+			 * @brief Record an allocation. Called from the allocator wrappers.
+			 * 
+			 * @param size usable size of the allocated block, 0 if allocation failed.
+			 */
+			static void
+			recordAllocation(std::size_t size);
+
+			/**
+			 * @brief Record a release. Called from the allocator wrappers.
+			 * 
+			 * @param size usable size of the released block.
+			 */
+			static void
+			recordRelease(std::size_t size);
+
+			/**
+			 * @brief Statistics getter. Walks the heap free list for the largest free block and scans the stack.
+			 * 
+			 * @return events::DiagnosticsMemoryStatistics collected statistics.
+			 */
+			static events::DiagnosticsMemoryStatistics
+			getStatistics();
+		private:
+			static uint32_t liveBytes;
+			static uint32_t peakBytes;
+			static uint32_t allocations;
+			static uint32_t failedAllocations;
+
+			static uint32_t
+			getLargestFreeBlock();
+
+			static uint32_t
+			getStackHighWaterMark();
+		};
+	}
+#endif  // ENABLE_MEMORY_STATISTICS
+
+#endif  // OSSHS_MEMORY_STATISTICS_HPP
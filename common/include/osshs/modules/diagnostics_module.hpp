@@ -0,0 +1,72 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2019 Linas Nikiperavicius
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef OSSHS_DIAGNOSTICS_MODULE_HPP
+#define OSSHS_DIAGNOSTICS_MODULE_HPP
+
+#include <osshs/modules/dispatching_module.hpp>
+#include <osshs/events/diagnostics_event.hpp>
+
+namespace osshs
+{
+	namespace modules
+	{
+		class DiagnosticsModule : public DispatchingModule<DiagnosticsModule>, private modm::NestedResumable<1>
+		{
+		public:
+			DiagnosticsModule();
+
+			uint8_t
+			getModuleTypeId() const;
+		protected:
+			bool
+			run();
+		private:
+			friend DispatchingModule<DiagnosticsModule>;
+
+			std::shared_ptr<events::Event> currentEvent;
+
+			modm::ResumableResult<void>
+			handleRequestLockStatisticsEvent(std::shared_ptr<events::DiagnosticsRequestLockStatisticsEvent> event);
+
+			modm::ResumableResult<void>
+			handleRequestTraceEvent(std::shared_ptr<events::DiagnosticsRequestTraceEvent> event);
+
+			modm::ResumableResult<void>
+			handleRequestModuleMetricsEvent(std::shared_ptr<events::DiagnosticsRequestModuleMetricsEvent> event);
+
+			modm::ResumableResult<void>
+			handleRequestMemoryStatisticsEvent(std::shared_ptr<events::DiagnosticsRequestMemoryStatisticsEvent> event);
+
+			static constexpr HandlerEntry EVENT_HANDLERS[] = {
+				handlerOf<&DiagnosticsModule::handleRequestLockStatisticsEvent>(),
+				handlerOf<&DiagnosticsModule::handleRequestTraceEvent>(),
+				handlerOf<&DiagnosticsModule::handleRequestModuleMetricsEvent>(),
+				handlerOf<&DiagnosticsModule::handleRequestMemoryStatisticsEvent>()
+			};
+		};
+	}
+}
+
+#endif  // OSSHS_DIAGNOSTICS_MODULE_HPP
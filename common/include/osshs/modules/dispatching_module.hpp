@@ -0,0 +1,98 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2019 Linas Nikiperavicius
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef OSSHS_DISPATCHING_MODULE_HPP
+#define OSSHS_DISPATCHING_MODULE_HPP
+
+#include <array>
+#include <cstddef>
+
+#include <osshs/modules/module.hpp>
+
+namespace osshs
+{
+	namespace modules
+	{
+		/**
+		 * @brief Module base routing events to handlers through a table indexed by the low byte of the event type.
+		 * 
+		 * DerivedModule lists its handlers in a static constexpr EVENT_HANDLERS array of handlerOf() entries
+		 * and calls PT_CALL(dispatchEvent(event)) from run(). The table is built at compile time.
+		 * 
+		 * @tparam DerivedModule module deriving from this class, which must befriend it.
+		 */
+		template<typename DerivedModule>
+		class DispatchingModule : public Module
+		{
+		protected:
+			typedef modm::ResumableResult<void> (*EventHandler)(DerivedModule &module, const std::shared_ptr<events::Event> &event);
+
+			struct HandlerEntry
+			{
+				uint16_t type;
+				EventHandler handler;
+			};
+
+			/**
+			 * @brief Handler table entry for a member function taking a std::shared_ptr to a concrete event.
+			 * The entry handles the TYPE of that event.
+			 * 
+			 * @tparam handler pointer to the handler member function.
+			 */
+			template<auto handler>
+			static constexpr HandlerEntry
+			handlerOf();
+
+			/**
+			 * @brief Route an event to its handler in O(1). Meant to be called with PT_CALL, like the handler itself.
+			 * Events without a handler are answered with SystemErrorEvent(UNSUPPORTED_EVENT).
+			 * 
+			 * @param event event to dispatch.
+			 */
+			modm::ResumableResult<void>
+			dispatchEvent(const std::shared_ptr<events::Event> &event);
+		private:
+			template<typename ConcreteEvent>
+			static ConcreteEvent *
+			eventOf(modm::ResumableResult<void> (DerivedModule::*handler)(std::shared_ptr<ConcreteEvent>));
+
+			template<auto handler, typename ConcreteEvent>
+			static modm::ResumableResult<void>
+			invoke(DerivedModule &module, const std::shared_ptr<events::Event> &event);
+
+			static constexpr std::size_t
+			getTableSize();
+
+			static constexpr bool
+			isValidTable();
+
+			static constexpr auto
+			makeTable();
+		};
+	}
+}
+
+#include <osshs/modules/dispatching_module_impl.hpp>
+
+#endif  // OSSHS_DISPATCHING_MODULE_HPP
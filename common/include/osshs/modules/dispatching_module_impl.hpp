@@ -0,0 +1,113 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2019 Linas Nikiperavicius
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef OSSHS_DISPATCHING_MODULE_HPP
+	#error "Don't include this file directly, use 'dispatching_module.hpp' instead!"
+#endif
+
+#include <type_traits>
+
+namespace osshs
+{
+	namespace modules
+	{
+		template<typename DerivedModule>
+		template<auto handler>
+		constexpr typename DispatchingModule<DerivedModule>::HandlerEntry
+		DispatchingModule<DerivedModule>::handlerOf()
+		{
+			typedef std::remove_pointer_t<decltype(eventOf(handler))> ConcreteEvent;
+
+			return {ConcreteEvent::TYPE, &invoke<handler, ConcreteEvent>};
+		}
+
+		template<typename DerivedModule>
+		modm::ResumableResult<void>
+		DispatchingModule<DerivedModule>::dispatchEvent(const std::shared_ptr<events::Event> &event)
+		{
+			static_assert(isValidTable(), "Event handlers must handle distinct event types of a single module.");
+			static constexpr auto handlers = makeTable();
+
+			uint16_t type = event->getType();
+			uint8_t index = type & 0xff;
+
+			if ((type & 0xff00) == (DerivedModule::EVENT_HANDLERS[0].type & 0xff00) && index < handlers.size() && handlers[index] != nullptr)
+				return handlers[index](*static_cast<DerivedModule*>(this), event);
+
+			reportUnsupportedEvent(event);
+
+			return modm::ResumableResult<void>(modm::rf::Stop);
+		}
+
+		template<typename DerivedModule>
+		template<auto handler, typename ConcreteEvent>
+		modm::ResumableResult<void>
+		DispatchingModule<DerivedModule>::invoke(DerivedModule &module, const std::shared_ptr<events::Event> &event)
+		{
+			return (module.*handler)(std::static_pointer_cast<ConcreteEvent>(event));
+		}
+
+		template<typename DerivedModule>
+		constexpr std::size_t
+		DispatchingModule<DerivedModule>::getTableSize()
+		{
+			std::size_t size = 0;
+
+			for (const HandlerEntry &entry : DerivedModule::EVENT_HANDLERS)
+				if (static_cast<std::size_t>(entry.type & 0xff) + 1 > size)
+					size = (entry.type & 0xff) + 1;
+
+			return size;
+		}
+
+		template<typename DerivedModule>
+		constexpr bool
+		DispatchingModule<DerivedModule>::isValidTable()
+		{
+			for (const HandlerEntry &entry : DerivedModule::EVENT_HANDLERS)
+			{
+				if ((entry.type & 0xff00) != (DerivedModule::EVENT_HANDLERS[0].type & 0xff00))
+					return false;
+
+				for (const HandlerEntry &other : DerivedModule::EVENT_HANDLERS)
+					if (&other != &entry && other.type == entry.type)
+						return false;
+			}
+
+			return true;
+		}
+
+		template<typename DerivedModule>
+		constexpr auto
+		DispatchingModule<DerivedModule>::makeTable()
+		{
+			std::array<EventHandler, getTableSize()> table = {};
+
+			for (const HandlerEntry &entry : DerivedModule::EVENT_HANDLERS)
+				table[entry.type & 0xff] = entry.handler;
+
+			return table;
+		}
+	}
+}
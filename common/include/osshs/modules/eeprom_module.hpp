@@ -26,8 +26,8 @@
 #define OSSHS_EEPROM_MODULE_HPP
 
 #include <modm/driver/storage/i2c_eeprom.hpp>
-#include <modm/processing/timer.hpp>
-#include <osshs/modules/module.hpp>
+#include <osshs/modules/dispatching_module.hpp>
+#include <osshs/timer.hpp>
 #include <osshs/events/eeprom_event.hpp>
 
 namespace osshs
@@ -35,7 +35,7 @@ namespace osshs
 	namespace modules
 	{
  		template <typename I2cMaster, uint16_t writeCycleTime = 5>
-		class EepromModule : public Module, private modm::NestedResumable<1>
+		class EepromModule : public DispatchingModule<EepromModule<I2cMaster, writeCycleTime>>, private modm::NestedResumable<1>
 		{
 		public:
 			EepromModule(uint8_t address = 0x50)
@@ -46,10 +46,15 @@ namespace osshs
 			uint8_t
 			getModuleTypeId() const;
 		protected:
+			using Module::eventQueue;
+			using Module::metrics;
+
 			bool
 			run();
 		private:
-    	modm::ShortTimeout writeCycleTimeout;
+			friend DispatchingModule<EepromModule>;
+
+			Timer writeCycleTimer;
 			modm::I2cEeprom<I2cMaster> i2cEeprom;
 
 			std::shared_ptr<events::Event> currentEvent;
@@ -61,6 +66,11 @@ namespace osshs
 
 			modm::ResumableResult<void>
 			handleUpdateDataEvent(std::shared_ptr<events::EepromUpdateDataEvent> event);
+
+			static constexpr typename EepromModule::HandlerEntry EVENT_HANDLERS[] = {
+				EepromModule::template handlerOf<&EepromModule::handleRequestDataEvent>(),
+				EepromModule::template handlerOf<&EepromModule::handleUpdateDataEvent>()
+			};
 	  };
 	}
 }
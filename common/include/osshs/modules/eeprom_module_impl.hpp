@@ -27,6 +27,7 @@
 #endif
 
 #include <osshs/resource_lock.hpp>
+#include <osshs/trace_recorder.hpp>
 #include <osshs/log/logger.hpp>
 
 namespace osshs
@@ -53,15 +54,12 @@ namespace osshs
 				currentEvent = eventQueue.front();
 				eventQueue.pop();
 
-				if (currentEvent->getType() == static_cast<uint16_t>(events::EepromEvent::REQUEST_DATA))
-				{
-					PT_CALL(handleRequestDataEvent(std::static_pointer_cast<events::EepromRequestDataEvent>(currentEvent)));
-				}
-				else if (currentEvent->getType() == static_cast<uint16_t>(events::EepromEvent::UPDATE_DATA))
-				{
-					PT_CALL(handleUpdateDataEvent(std::static_pointer_cast<events::EepromUpdateDataEvent>(currentEvent)));
-				}
+				OSSHS_TRACE(DEQUEUED, currentEvent);
+				metrics.recordEvent(currentEvent->getType());
+
+				PT_CALL(this->dispatchEvent(currentEvent));
 
+				metrics.recordHandled();
 				currentEvent.reset();
 			}
 			while (true);
@@ -82,11 +80,14 @@ namespace osshs
 			if (currentData == nullptr)
 			{
 				OSSHS_LOG_ERROR("Failed to allocate memory for a buffer(bufferLength = %u).", event->getDataLen());
+				metrics.recordError();
 				RF_RETURN();
 			}
 
-			RF_WAIT_UNTIL(ResourceLock<I2cMaster>::tryLock());
+			RF_WAIT_UNTIL(ResourceLock<I2cMaster>::tryLock(this));
+			OSSHS_TRACE(LOCKED, event);
 			currentSuccess = RF_CALL(i2cEeprom.read(event->getAddress(), currentData.get(), event->getDataLen()));
+			OSSHS_TRACE(TRANSFERRED, event);
 			ResourceLock<I2cMaster>::unlock();
 
 			{
@@ -107,6 +108,7 @@ namespace osshs
 					if (successEvent == nullptr)
 					{
 						OSSHS_LOG_ERROR("Failed to allocate memory for an eeprom data ready event.");
+						metrics.recordError();
 						RF_RETURN();
 					}
 
@@ -114,6 +116,8 @@ namespace osshs
 				}
 				else
 				{
+					metrics.recordError();
+
 					events::EepromErrorEvent *errorEvent = new (std::nothrow) events::EepromErrorEvent(
 						events::EepromError::READ_FAILED,
 						event->getCauseId(),
@@ -134,6 +138,9 @@ namespace osshs
 
 				currentData.reset();
 
+				responseEvent->setDestination(event->getSource());
+				OSSHS_TRACE(RESPONDED, responseEvent);
+
 				if (event->getCallback() != nullptr)
 				{
 					event->getCallback()(responseEvent);
@@ -157,9 +164,11 @@ namespace osshs
 
 			currentData = event->getData();
 
-			RF_WAIT_UNTIL(ResourceLock<I2cMaster>::tryLock());
+			RF_WAIT_UNTIL(ResourceLock<I2cMaster>::tryLock(this));
+			OSSHS_TRACE(LOCKED, event);
 			currentSuccess = RF_CALL(i2cEeprom.write(event->getAddress(), currentData.get(), event->getDataLen()));
-			writeCycleTimeout.restart(writeCycleTime);
+			OSSHS_TRACE(TRANSFERRED, event);
+			writeCycleTimer.start(writeCycleTime);
 
 			{
 				std::shared_ptr<events::Event> responseEvent;
@@ -177,6 +186,7 @@ namespace osshs
 					if (successEvent == nullptr)
 					{
 						OSSHS_LOG_ERROR("Failed to allocate memory for an eeprom update success event.");
+						metrics.recordError();
 						RF_RETURN();
 					}
 
@@ -184,6 +194,8 @@ namespace osshs
 				}
 				else
 				{
+					metrics.recordError();
+
 					events::EepromErrorEvent *errorEvent = new (std::nothrow) events::EepromErrorEvent(
 						events::EepromError::WRITE_FAILED,
 						event->getCauseId(),
@@ -204,6 +216,9 @@ namespace osshs
 
 				currentData.reset();
 
+				responseEvent->setDestination(event->getSource());
+				OSSHS_TRACE(RESPONDED, responseEvent);
+
 				if (event->getCallback() != nullptr)
 				{
 					event->getCallback()(responseEvent);
@@ -214,8 +229,8 @@ namespace osshs
 				}
 			}
 
-			RF_WAIT_UNTIL(writeCycleTimeout.isExpired());
-			writeCycleTimeout.stop();
+			RF_WAIT_UNTIL(writeCycleTimer.isExpired());
+			writeCycleTimer.stop();
 			ResourceLock<I2cMaster>::unlock();
 
 			RF_END();
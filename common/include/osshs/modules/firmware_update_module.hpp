@@ -0,0 +1,167 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2019 Linas Nikiperavicius
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef OSSHS_FIRMWARE_UPDATE_MODULE_HPP
+#define OSSHS_FIRMWARE_UPDATE_MODULE_HPP
+
+#include <osshs/modules/dispatching_module.hpp>
+#include <osshs/timer.hpp>
+#include <osshs/events/firmware_event.hpp>
+
+namespace osshs
+{
+	namespace modules
+	{
+		/**
+		 * @brief Receives a firmware image over the bus into a flash staging area.
+		 * 
+		 * The image is streamed as CRC-checked blocks. Every programmed block is
+		 * acknowledged with the index of the next expected block and a window of
+		 * blocks the sender may keep in flight, so the next blocks arrive while
+		 * the current one is programmed. Blocks may be multicast to a group of
+		 * nodes, each node acknowledges on its own.
+		 * 
+		 * Once the whole image matches its CRC, a descriptor is written to the last
+		 * page of the staging area for the bootloader to install the image from.
+		 * 
+		 * Begin erases the pages of the image and the descriptor page before it is
+		 * answered, which stalls the node for up to 40 ms per page on an STM32F103,
+		 * about 5 s for the largest image. An update without a block for
+		 * INACTIVITY_TIMEOUT is aborted and the flash locked again.
+		 * 
+		 * @tparam Flash flash driver, e.g. flash::Stm32f1Flash.
+		 * @tparam blockSize size of every block but the last one, a multiple of 2.
+		 * @tparam window number of blocks which may be in flight.
+		 */
+		template <typename Flash, uint16_t blockSize = 256, uint8_t window = 4>
+		class FirmwareUpdateModule : public DispatchingModule<FirmwareUpdateModule<Flash, blockSize, window>>, private modm::NestedResumable<2>
+		{
+		public:
+			/**
+			 * @brief Descriptor: [0-3] DESCRIPTOR_MAGIC, [4-7] image size, [8-11] image CRC-32.
+			 */
+			static constexpr uint32_t DESCRIPTOR_MAGIC = 0x4f535355;
+			static constexpr uint32_t DESCRIPTOR_LENGTH = 12;
+
+			/**
+			 * @brief Construct firmware update module.
+			 * 
+			 * @param stagingAddress page aligned flash address of the staging area, clear of the application.
+			 * @param stagingSize staging area size in bytes, including the descriptor page.
+			 */
+			FirmwareUpdateModule(uint32_t stagingAddress = 0x08042000, uint32_t stagingSize = 0x3e000);
+
+			uint8_t
+			getModuleTypeId() const;
+		protected:
+			using Module::eventQueue;
+			using Module::metrics;
+
+			bool
+			run();
+		private:
+			friend DispatchingModule<FirmwareUpdateModule>;
+
+			static constexpr uint32_t RESTART_DELAY = 100;
+			static constexpr uint32_t INACTIVITY_TIMEOUT = 30000;
+
+			static_assert(blockSize % 2 == 0, "Blocks are programmed in half-words.");
+			static_assert(window > 0, "At least one block must be allowed in flight.");
+
+			uint32_t stagingAddress;
+			uint32_t stagingSize;
+
+			bool started;
+			bool staged;
+			uint32_t imageSize;
+			uint32_t imageCrc;
+			uint16_t nextIndex;
+
+			std::shared_ptr<events::Event> currentEvent;
+			std::shared_ptr<uint8_t[]> currentData;
+			uint32_t currentOffset;
+			uint32_t currentCrc;
+			bool currentSuccess;
+
+			Timer restartTimer;
+			Timer inactivityTimer;
+
+			modm::ResumableResult<void>
+			handleBeginEvent(std::shared_ptr<events::FirmwareBeginEvent> event);
+
+			modm::ResumableResult<void>
+			handleBlockEvent(std::shared_ptr<events::FirmwareBlockEvent> event);
+
+			modm::ResumableResult<void>
+			handleFinishEvent(std::shared_ptr<events::FirmwareFinishEvent> event);
+
+			static constexpr typename FirmwareUpdateModule::HandlerEntry EVENT_HANDLERS[] = {
+				FirmwareUpdateModule::template handlerOf<&FirmwareUpdateModule::handleBeginEvent>(),
+				FirmwareUpdateModule::template handlerOf<&FirmwareUpdateModule::handleBlockEvent>(),
+				FirmwareUpdateModule::template handlerOf<&FirmwareUpdateModule::handleFinishEvent>()
+			};
+
+			/**
+			 * @brief Erase a flash page.
+			 * 
+			 * @param address address within the page.
+			 * @return true if the page was erased.
+			 */
+			modm::ResumableResult<bool>
+			erasePage(uint32_t address);
+
+			/**
+			 * @brief Program a half-word, skipping values already in the erased state.
+			 * 
+			 * @param address half-word aligned flash address.
+			 * @param value value to program.
+			 * @return true if the half-word was programmed.
+			 */
+			modm::ResumableResult<bool>
+			programHalfWord(uint32_t address, uint16_t value);
+
+			/**
+			 * @brief Abort the running update and answer the request with an error.
+			 * 
+			 * @param request request which failed, nullptr if the update timed out.
+			 * @param error error to respond with.
+			 */
+			void
+			abortUpdate(std::shared_ptr<events::Event> request, events::FirmwareError error);
+
+			/**
+			 * @brief Send a response to the source of a request.
+			 * 
+			 * @param request request to respond to.
+			 * @param response response event, may be nullptr if its allocation failed.
+			 */
+			void
+			respond(std::shared_ptr<events::Event> request, events::Event *response);
+		};
+	}
+}
+
+#include <osshs/modules/firmware_update_module_impl.hpp>
+
+#endif  // OSSHS_FIRMWARE_UPDATE_MODULE_HPP
@@ -0,0 +1,396 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2019 Linas Nikiperavicius
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef OSSHS_FIRMWARE_UPDATE_MODULE_HPP
+	#error "Don't include this file directly, use 'firmware_update_module.hpp' instead!"
+#endif
+
+#include <algorithm>
+
+#include <modm/platform.hpp>
+#include <osshs/crc32.hpp>
+#include <osshs/system.hpp>
+#include <osshs/trace_recorder.hpp>
+#include <osshs/log/logger.hpp>
+
+namespace osshs
+{
+	namespace modules
+	{
+		template <typename Flash, uint16_t blockSize, uint8_t window>
+		FirmwareUpdateModule<Flash, blockSize, window>::FirmwareUpdateModule(uint32_t stagingAddress, uint32_t stagingSize)
+			: stagingAddress(stagingAddress), stagingSize(stagingSize), started(false), staged(false), imageSize(0), imageCrc(0), nextIndex(0)
+		{
+			OSSHS_LOG_INFO("Initializing firmware update module(stagingAddress = 0x%08lx, stagingSize = 0x%08lx).", stagingAddress, stagingSize);
+		}
+
+		template <typename Flash, uint16_t blockSize, uint8_t window>
+		uint8_t
+		FirmwareUpdateModule<Flash, blockSize, window>::getModuleTypeId() const
+		{
+			return static_cast<uint8_t>(static_cast<uint16_t> (events::FirmwareEvent::BASE) >> 8);
+		}
+
+		template <typename Flash, uint16_t blockSize, uint8_t window>
+		bool
+		FirmwareUpdateModule<Flash, blockSize, window>::run()
+		{
+			PT_BEGIN();
+
+			do
+			{
+				PT_WAIT_UNTIL(!eventQueue.empty() || restartTimer.isExpired() || inactivityTimer.isExpired());
+
+				if (restartTimer.isExpired())
+				{
+					OSSHS_LOG_INFO("Restarting to install the staged firmware.");
+					NVIC_SystemReset();
+				}
+
+				if (inactivityTimer.isExpired())
+				{
+					abortUpdate(nullptr, events::FirmwareError::TIMED_OUT);
+					continue;
+				}
+
+				currentEvent = eventQueue.front();
+				eventQueue.pop();
+
+				OSSHS_TRACE(DEQUEUED, currentEvent);
+				metrics.recordEvent(currentEvent->getType());
+
+				PT_CALL(this->dispatchEvent(currentEvent));
+
+				metrics.recordHandled();
+				currentEvent.reset();
+			}
+			while (true);
+
+			PT_END();
+		}
+
+		template <typename Flash, uint16_t blockSize, uint8_t window>
+		modm::ResumableResult<void>
+		FirmwareUpdateModule<Flash, blockSize, window>::handleBeginEvent(std::shared_ptr<events::FirmwareBeginEvent> event)
+		{
+			RF_BEGIN();
+
+			OSSHS_LOG_INFO("Handling firmware begin event(imageSize = %lu, imageCrc = 0x%08lx).", event->getImageSize(), event->getImageCrc());
+
+			// A new begin abandons the running update.
+			Flash::lock();
+			inactivityTimer.stop();
+			started = false;
+			staged = false;
+
+			if (event->getImageSize() == 0 || event->getImageSize() > stagingSize - Flash::PAGE_SIZE)
+			{
+				metrics.recordError();
+				respond(event, new (std::nothrow) events::FirmwareErrorEvent(
+					events::FirmwareError::IMAGE_TOO_LARGE,
+					event->getCauseId(),
+					[=](std::shared_ptr<osshs::events::Event> event) -> void
+					{
+						this->handleEvent(event);
+					}
+				));
+				RF_RETURN();
+			}
+
+			imageSize = event->getImageSize();
+			imageCrc = event->getImageCrc();
+			nextIndex = 0;
+
+			Flash::unlock();
+
+			// The descriptor of a previous update goes first, so a partially staged image is never installed.
+			currentSuccess = RF_CALL(erasePage(stagingAddress + stagingSize - Flash::PAGE_SIZE));
+
+			// Erasing stalls the CPU for tens of milliseconds, long enough to overrun the CAN receive
+			// FIFO. All pages are erased before the sender is answered, while the bus is quiet.
+			for (currentOffset = 0; currentSuccess && currentOffset < imageSize; currentOffset += Flash::PAGE_SIZE)
+			{
+				currentSuccess = RF_CALL(erasePage(stagingAddress + currentOffset));
+			}
+
+			if (!currentSuccess)
+			{
+				abortUpdate(event, events::FirmwareError::FLASH_FAILED);
+				RF_RETURN();
+			}
+
+			started = true;
+			inactivityTimer.start(INACTIVITY_TIMEOUT);
+
+			respond(event, new (std::nothrow) events::FirmwareReadyEvent(
+				blockSize,
+				window,
+				event->getCauseId(),
+				[=](std::shared_ptr<osshs::events::Event> event) -> void
+				{
+					this->handleEvent(event);
+				}
+			));
+
+			RF_END();
+		}
+
+		template <typename Flash, uint16_t blockSize, uint8_t window>
+		modm::ResumableResult<void>
+		FirmwareUpdateModule<Flash, blockSize, window>::handleBlockEvent(std::shared_ptr<events::FirmwareBlockEvent> event)
+		{
+			RF_BEGIN();
+
+			OSSHS_LOG_DEBUG("Handling firmware block event(index = %u, dataLength = %u).", event->getIndex(), event->getDataLen());
+
+			if (!started)
+			{
+				metrics.recordError();
+				respond(event, new (std::nothrow) events::FirmwareErrorEvent(
+					events::FirmwareError::NOT_STARTED,
+					event->getCauseId(),
+					[=](std::shared_ptr<osshs::events::Event> event) -> void
+					{
+						this->handleEvent(event);
+					}
+				));
+				RF_RETURN();
+			}
+
+			inactivityTimer.start(INACTIVITY_TIMEOUT);
+
+			currentData = event->getData();
+			currentOffset = static_cast<uint32_t>(event->getIndex()) * blockSize;
+
+			// Anything but the next block is answered with an unchanged index: duplicates after a lost
+			// acknowledgement as well as blocks following a lost or corrupted one.
+			if (event->getIndex() != nextIndex || currentData == nullptr ||
+				(event->getDataLen() != blockSize && currentOffset + event->getDataLen() != imageSize) ||
+				currentOffset + event->getDataLen() > imageSize ||
+				Crc32::update(Crc32::INITIAL, currentData.get(), event->getDataLen()) != event->getCrc())
+			{
+				if (event->getIndex() >= nextIndex)
+				{
+					OSSHS_LOG_WARNING("Discarding firmware block(index = %u, nextIndex = %u).", event->getIndex(), nextIndex);
+					metrics.recordError();
+				}
+
+				currentData.reset();
+			}
+			else
+			{
+				for (currentOffset = 0; currentOffset < event->getDataLen(); currentOffset += 2)
+				{
+					currentSuccess = RF_CALL(programHalfWord(
+						stagingAddress + static_cast<uint32_t>(nextIndex) * blockSize + currentOffset,
+						currentData[currentOffset] | ((currentOffset + 1 < event->getDataLen() ? currentData[currentOffset + 1] : 0xff) << 8)
+					));
+
+					if (!currentSuccess)
+						break;
+				}
+
+				currentData.reset();
+
+				if (!currentSuccess || Crc32::update(Crc32::INITIAL, Flash::getData(stagingAddress + static_cast<uint32_t>(nextIndex) * blockSize), event->getDataLen()) != event->getCrc())
+				{
+					abortUpdate(event, events::FirmwareError::FLASH_FAILED);
+					RF_RETURN();
+				}
+
+				nextIndex++;
+			}
+
+			respond(event, new (std::nothrow) events::FirmwareAcknowledgeEvent(
+				nextIndex,
+				window,
+				event->getCauseId(),
+				[=](std::shared_ptr<osshs::events::Event> event) -> void
+				{
+					this->handleEvent(event);
+				}
+			));
+
+			RF_END();
+		}
+
+		template <typename Flash, uint16_t blockSize, uint8_t window>
+		modm::ResumableResult<void>
+		FirmwareUpdateModule<Flash, blockSize, window>::handleFinishEvent(std::shared_ptr<events::FirmwareFinishEvent> event)
+		{
+			RF_BEGIN();
+
+			OSSHS_LOG_INFO("Handling firmware finish event(restart = %u).", event->getRestart());
+
+			// A repeated finish, e.g. after a lost response, is answered again without touching the flash.
+			if (!staged)
+			{
+				if (!started || static_cast<uint32_t>(nextIndex) * blockSize < imageSize)
+				{
+					metrics.recordError();
+					respond(event, new (std::nothrow) events::FirmwareErrorEvent(
+						started ? events::FirmwareError::IMAGE_INCOMPLETE : events::FirmwareError::NOT_STARTED,
+						event->getCauseId(),
+						[=](std::shared_ptr<osshs::events::Event> event) -> void
+						{
+							this->handleEvent(event);
+						}
+					));
+					RF_RETURN();
+				}
+
+				// Checksum the staged image a block at a time, so events keep flowing meanwhile.
+				currentCrc = Crc32::INITIAL;
+
+				for (currentOffset = 0; currentOffset < imageSize; currentOffset += blockSize)
+				{
+					currentCrc = Crc32::update(currentCrc, Flash::getData(stagingAddress + currentOffset), std::min<uint32_t>(blockSize, imageSize - currentOffset));
+					RF_YIELD();
+				}
+
+				if (currentCrc != imageCrc)
+				{
+					OSSHS_LOG_WARNING("Staged firmware image is corrupted(crc = 0x%08lx, imageCrc = 0x%08lx).", currentCrc, imageCrc);
+					abortUpdate(event, events::FirmwareError::IMAGE_CRC_MISMATCH);
+					RF_RETURN();
+				}
+
+				currentSuccess = true;
+
+				for (currentOffset = 0; currentSuccess && currentOffset < DESCRIPTOR_LENGTH; currentOffset += 2)
+				{
+					currentSuccess = RF_CALL(programHalfWord(
+						stagingAddress + stagingSize - Flash::PAGE_SIZE + currentOffset,
+						((currentOffset < 4) ? DESCRIPTOR_MAGIC : ((currentOffset < 8) ? imageSize : imageCrc)) >> (8 * (currentOffset & 2))
+					));
+				}
+
+				if (!currentSuccess)
+				{
+					abortUpdate(event, events::FirmwareError::FLASH_FAILED);
+					RF_RETURN();
+				}
+
+				Flash::lock();
+				inactivityTimer.stop();
+				started = false;
+				staged = true;
+
+				OSSHS_LOG_INFO("Firmware image staged(imageSize = %lu).", imageSize);
+			}
+
+			respond(event, new (std::nothrow) events::FirmwareCompleteEvent(
+				event->getCauseId(),
+				[=](std::shared_ptr<osshs::events::Event> event) -> void
+				{
+					this->handleEvent(event);
+				}
+			));
+
+			// Leave the response some time to get onto the bus.
+			if (event->getRestart())
+				restartTimer.start(RESTART_DELAY);
+
+			RF_END();
+		}
+
+		template <typename Flash, uint16_t blockSize, uint8_t window>
+		modm::ResumableResult<bool>
+		FirmwareUpdateModule<Flash, blockSize, window>::erasePage(uint32_t address)
+		{
+			RF_BEGIN();
+
+			Flash::startErase(address);
+			RF_WAIT_WHILE(Flash::isBusy());
+
+			RF_END_RETURN(Flash::finish());
+		}
+
+		template <typename Flash, uint16_t blockSize, uint8_t window>
+		modm::ResumableResult<bool>
+		FirmwareUpdateModule<Flash, blockSize, window>::programHalfWord(uint32_t address, uint16_t value)
+		{
+			RF_BEGIN();
+
+			if (value == 0xffff)
+				RF_RETURN(true);
+
+			Flash::startProgram(address, value);
+			RF_WAIT_WHILE(Flash::isBusy());
+
+			RF_END_RETURN(Flash::finish());
+		}
+
+		template <typename Flash, uint16_t blockSize, uint8_t window>
+		void
+		FirmwareUpdateModule<Flash, blockSize, window>::abortUpdate(std::shared_ptr<events::Event> request, events::FirmwareError error)
+		{
+			OSSHS_LOG_ERROR("Aborting firmware update(error = %u, nextIndex = %u).", static_cast<uint8_t>(error), nextIndex);
+
+			Flash::lock();
+			inactivityTimer.stop();
+			started = false;
+
+			metrics.recordError();
+
+			if (request == nullptr)
+				return;
+
+			respond(request, new (std::nothrow) events::FirmwareErrorEvent(
+				error,
+				request->getCauseId(),
+				[=](std::shared_ptr<osshs::events::Event> event) -> void
+				{
+					this->handleEvent(event);
+				}
+			));
+		}
+
+		template <typename Flash, uint16_t blockSize, uint8_t window>
+		void
+		FirmwareUpdateModule<Flash, blockSize, window>::respond(std::shared_ptr<events::Event> request, events::Event *response)
+		{
+			if (response == nullptr)
+			{
+				OSSHS_LOG_ERROR("Failed to allocate memory for a firmware response event.");
+				metrics.recordError();
+				return;
+			}
+
+			std::shared_ptr<events::Event> responseEvent(response);
+
+			responseEvent->setDestination(request->getSource());
+			OSSHS_TRACE(RESPONDED, responseEvent);
+
+			if (request->getCallback() != nullptr)
+			{
+				request->getCallback()(responseEvent);
+			}
+			else
+			{
+				System::reportEvent(responseEvent);
+			}
+		}
+	}
+}
@@ -31,6 +31,7 @@
 #include <modm/processing/protothread.hpp>
 #include <modm/processing/resumable.hpp>
 #include <osshs/events/event.hpp>
+#include <osshs/modules/module_metrics.hpp>
 
 namespace osshs
 {
@@ -52,8 +53,17 @@ namespace osshs
 			 */
 			virtual uint8_t
 			getModuleTypeId() const = 0;
+
+			/**
+			 * @brief Runtime metrics getter.
+			 * 
+			 * @return const ModuleMetrics& metrics collected while handling events.
+			 */
+			const ModuleMetrics &
+			getMetrics() const;
 		protected:
 			std::queue<std::shared_ptr<events::Event>> eventQueue;
+			ModuleMetrics metrics;
 
 			/**
 			 * @brief Initialize the module. Should only be called from ModuleManager.
@@ -76,6 +86,15 @@ namespace osshs
 			 */
 			void
 			handleEvent(std::shared_ptr<events::Event> event);
+
+			/**
+			 * @brief Answer an event the module has no handler for with SystemErrorEvent(UNSUPPORTED_EVENT).
+			 * Only events addressed to this node are answered, so broadcasts and stray responses do not cause error storms.
+			 * 
+			 * @param event unsupported event.
+			 */
+			void
+			reportUnsupportedEvent(const std::shared_ptr<events::Event> &event);
 		private:
 			Module(const Module&) = delete;
 
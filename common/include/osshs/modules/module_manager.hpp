@@ -56,6 +56,23 @@ namespace osshs
 			 */
 			static void
 			update();
+
+			/**
+			 * @brief Registered module count getter.
+			 * 
+			 * @return uint8_t number of registered modules.
+			 */
+			static uint8_t
+			getModuleCount();
+
+			/**
+			 * @brief Look up a module by index.
+			 * 
+			 * @param module module index, in registration order.
+			 * @return Module or nullptr if index is out of bounds.
+			 */
+			static const modules::Module *
+			getModule(uint8_t module);
 		private:
 			static std::vector<modules::Module*> modules;
 		};
@@ -0,0 +1,103 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2019 Linas Nikiperavicius
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef OSSHS_MODULE_METRICS_HPP
+#define OSSHS_MODULE_METRICS_HPP
+
+#include <cstdint>
+#include <osshs/events/diagnostics_event.hpp>
+
+namespace osshs
+{
+	namespace modules
+	{
+		class ModuleMetrics
+		{
+		public:
+			ModuleMetrics();
+
+			/**
+			 * @brief Record that an event was taken from the queue and is being handled.
+			 * 
+			 * @param type event type id.
+			 */
+			void
+			recordEvent(uint16_t type);
+
+			/**
+			 * @brief Record that handling of the current event has finished.
+			 * 
+			 */
+			void
+			recordHandled();
+
+			/**
+			 * @brief Record an error, either an error response or a failure to respond.
+			 * 
+			 */
+			void
+			recordError();
+
+			/**
+			 * @brief Record the event queue length after an event was queued.
+			 * 
+			 * @param length event queue length.
+			 */
+			void
+			recordQueueLength(std::size_t length);
+
+			/**
+			 * @brief Metrics getter.
+			 * 
+			 * @return events::DiagnosticsModuleMetrics collected metrics.
+			 */
+			events::DiagnosticsModuleMetrics
+			getMetrics() const;
+
+			/**
+			 * @brief Event type count getter.
+			 * 
+			 * @return uint8_t number of event types with a separate counter.
+			 */
+			uint8_t
+			getEventTypeCount() const;
+
+			/**
+			 * @brief Event type counter getter.
+			 * 
+			 * @param index counter index, less than getEventTypeCount().
+			 * @return events::DiagnosticsEventCount event type and number of handled events of that type.
+			 */
+			events::DiagnosticsEventCount
+			getEventCount(uint8_t index) const;
+		private:
+			events::DiagnosticsModuleMetrics metrics;
+			events::DiagnosticsEventCount eventCounts[events::DiagnosticsModuleMetricsReadyEvent::MAX_EVENT_COUNTS];
+			uint8_t eventTypeCount;
+			uint32_t handleStartTime;
+		};
+	}
+}
+
+#endif  // OSSHS_MODULE_METRICS_HPP
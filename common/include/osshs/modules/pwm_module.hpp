@@ -26,28 +26,108 @@
 #define OSSHS_PWM_MODULE_HPP
 
 #include <modm/driver/pwm/tlc594x.hpp>
-#include <osshs/modules/module.hpp>
+#include <osshs/modules/dispatching_module.hpp>
+#include <osshs/timer.hpp>
+#include <osshs/events/eeprom_event.hpp>
 #include <osshs/events/pwm_event.hpp>
 
 namespace osshs
 {
 	namespace modules
 	{
- 		template <uint16_t channels, typename SpiMaster, typename Xlat, typename Xblank>
-		class PwmModule : public Module, private modm::NestedResumable<1>
+ 		template <uint16_t channels, typename SpiMaster, typename Xlat, typename Xblank, uint8_t sceneCount = 8>
+		class PwmModule : public DispatchingModule<PwmModule<channels, SpiMaster, Xlat, Xblank, sceneCount>>, private modm::NestedResumable<2>
 		{
 		public:
-			PwmModule();
+			/**
+			 * @brief Construct PWM module.
+			 * 
+			 * @param sceneAddress EEPROM address of the first scene slot. Scenes are stored through the EEPROM module,
+			 * the output snapshot slots follow the last scene slot.
+			 */
+			PwmModule(uint16_t sceneAddress = 0x0100);
 
 			uint8_t
 			getModuleTypeId() const;
 		protected:
+			using Module::eventQueue;
+			using Module::metrics;
+
 			bool
 			run();
 		private:
+			friend DispatchingModule<PwmModule>;
+
+			/**
+			 * @brief Serialized scene: [0] SCENE_MAGIC, [1-2] fade time, [3-...] channel values.
+			 * Slots are page aligned, so each chunk of a write stays within one EEPROM page.
+			 */
+			static constexpr uint8_t SCENE_MAGIC = 0x5c;
+			static constexpr uint16_t SCENE_LENGTH = 3 + channels * 2;
+			static constexpr uint16_t SCENE_PAGE_SIZE = 16;
+			static constexpr uint16_t SCENE_SLOT_LENGTH = (SCENE_LENGTH + SCENE_PAGE_SIZE - 1) / SCENE_PAGE_SIZE * SCENE_PAGE_SIZE;
+			static constexpr uint32_t STORAGE_TIMEOUT = 100;
+			static constexpr uint32_t FADE_INTERVAL = 20;
+
+			/**
+			 * @brief Serialized output snapshot: [0] SNAPSHOT_MAGIC, [1-2] sequence, [3] enabled,
+			 * [4-...] channel values, [last 4] CRC-32 of the preceding bytes.
+			 * Snapshots rotate over SNAPSHOT_SLOTS slots by sequence, the newest valid one is restored at boot.
+			 * A torn write fails the CRC and leaves the previous slot in charge.
+			 */
+			static constexpr uint8_t SNAPSHOT_MAGIC = 0x5d;
+			static constexpr uint8_t SNAPSHOT_SLOTS = 4;
+			static constexpr uint16_t SNAPSHOT_LENGTH = 8 + channels * 2;
+			static constexpr uint16_t SNAPSHOT_SLOT_LENGTH = (SNAPSHOT_LENGTH + SCENE_PAGE_SIZE - 1) / SCENE_PAGE_SIZE * SCENE_PAGE_SIZE;
+
+			/**
+			 * @brief A snapshot is written SNAPSHOT_DELAY after the last output change,
+			 * but no later than SNAPSHOT_MAX_DELAY after the first unsaved one.
+			 */
+			static constexpr uint32_t SNAPSHOT_DELAY = 2000;
+			static constexpr uint32_t SNAPSHOT_MAX_DELAY = 30000;
+
+			struct Snapshot
+			{
+				bool valid;
+				uint16_t sequence;
+				bool enabled;
+				uint16_t values[channels];
+			};
+
+			struct Scene
+			{
+				bool loaded;
+				bool stored;
+				uint16_t fadeTime;
+				uint16_t values[channels];
+			};
+
 			modm::TLC594X<channels, SpiMaster, Xlat, Xblank> tlc594x;
 
 			std::shared_ptr<events::Event> currentEvent;
+			bool currentSuccess;
+
+			uint16_t sceneAddress;
+			Scene scenes[sceneCount];
+
+			Timer storageTimer;
+			std::shared_ptr<events::Event> storageResponse;
+			std::shared_ptr<uint8_t[]> storageData;
+			uint16_t storageCauseId;
+			uint16_t storageOffset;
+
+			Timer fadeTimer;
+			uint32_t fadeStart;
+			uint16_t fadeTime;
+			uint16_t fadeFrom[channels];
+			uint16_t fadeTo[channels];
+
+			uint16_t snapshotAddress;
+			Snapshot snapshot;
+			uint32_t snapshotRestoreStart;
+			Timer snapshotTimer;
+			Timer snapshotDeadlineTimer;
 
 			modm::ResumableResult<void>
 			handleRequestStatusEvent(std::shared_ptr<events::PwmRequestStatusEvent> event);
@@ -69,6 +149,80 @@ namespace osshs
 
 			modm::ResumableResult<void>
 			handleUpdateRgbwChannelEvent(std::shared_ptr<events::PwmUpdateRgbwChannelEvent> event);
+
+			modm::ResumableResult<void>
+			handleStoreSceneEvent(std::shared_ptr<events::PwmStoreSceneEvent> event);
+
+			modm::ResumableResult<void>
+			handleRecallSceneEvent(std::shared_ptr<events::PwmRecallSceneEvent> event);
+
+			static constexpr typename PwmModule::HandlerEntry EVENT_HANDLERS[] = {
+				PwmModule::template handlerOf<&PwmModule::handleRequestStatusEvent>(),
+				PwmModule::template handlerOf<&PwmModule::handleEnableEvent>(),
+				PwmModule::template handlerOf<&PwmModule::handleDisableEvent>(),
+				PwmModule::template handlerOf<&PwmModule::handleRequestChannelEvent>(),
+				PwmModule::template handlerOf<&PwmModule::handleUpdateChannelEvent>(),
+				PwmModule::template handlerOf<&PwmModule::handleRequestRgbwChannelEvent>(),
+				PwmModule::template handlerOf<&PwmModule::handleUpdateRgbwChannelEvent>(),
+				PwmModule::template handlerOf<&PwmModule::handleStoreSceneEvent>(),
+				PwmModule::template handlerOf<&PwmModule::handleRecallSceneEvent>()
+			};
+
+			/**
+			 * @brief Write storageData through the EEPROM module, one page at a time.
+			 * 
+			 * @param address page aligned EEPROM address.
+			 * @param length number of bytes to write.
+			 * @return true if every page was written.
+			 */
+			modm::ResumableResult<bool>
+			writeStorage(uint16_t address, uint16_t length);
+
+			/**
+			 * @brief Read a scene slot through the EEPROM module into the scene cache.
+			 * 
+			 * @param scene scene index.
+			 * @return true if the slot was read, whether or not it holds a scene.
+			 */
+			modm::ResumableResult<bool>
+			readScene(uint8_t scene);
+
+			/**
+			 * @brief Step the running fade and write the interpolated values to the driver.
+			 * 
+			 */
+			modm::ResumableResult<void>
+			updateFade();
+
+			/**
+			 * @brief Read every snapshot slot and load the newest valid one into the driver.
+			 * The outputs stay blanked until this is done, and are enabled as they were snapshotted.
+			 * 
+			 */
+			modm::ResumableResult<void>
+			restoreSnapshot();
+
+			/**
+			 * @brief Write the current output to the next snapshot slot, unless it matches the last snapshot.
+			 * 
+			 */
+			modm::ResumableResult<void>
+			writeSnapshot();
+
+			/**
+			 * @brief Note an output change, so the next snapshot is written once the output settles.
+			 * 
+			 */
+			void
+			scheduleSnapshot();
+
+			/**
+			 * @brief Report a request to the local EEPROM module and collect its response in storageResponse.
+			 * 
+			 * @param request EEPROM request event.
+			 */
+			void
+			reportStorageRequest(events::Event *request);
 	  };
 	}
 }
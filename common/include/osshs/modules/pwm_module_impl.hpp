@@ -26,70 +26,70 @@
 	#error "Don't include this file directly, use 'pwm_module.hpp' instead!"
 #endif
 
+#include <algorithm>
+
+#include <osshs/crc32.hpp>
+#include <osshs/events/cause_id_allocator.hpp>
 #include <osshs/resource_lock.hpp>
+#include <osshs/system.hpp>
+#include <osshs/time.hpp>
+#include <osshs/trace_recorder.hpp>
 #include <osshs/log/logger.hpp>
 
 namespace osshs
 {
 	namespace modules
 	{
- 		template <uint16_t channels, typename SpiMaster, typename Xlat, typename Xblank>
-		PwmModule<channels, SpiMaster, Xlat, Xblank>::PwmModule()
+ 		template <uint16_t channels, typename SpiMaster, typename Xlat, typename Xblank, uint8_t sceneCount>
+		PwmModule<channels, SpiMaster, Xlat, Xblank, sceneCount>::PwmModule(uint16_t sceneAddress)
+			: sceneAddress(sceneAddress), scenes(), storageCauseId(events::Event::CAUSE_ID_GENERATE), snapshotAddress(sceneAddress + sceneCount * SCENE_SLOT_LENGTH), snapshot()
 		{
 			OSSHS_LOG_INFO("Initializing PWM module.");
 
-			tlc594x.initialize(0x000, -1, true, false, true);
+			// Keep the outputs blanked until restoreSnapshot() has loaded the previous state.
+			tlc594x.initialize(0x000, -1, true, false, false);
 		}
 
-		template <uint16_t channels, typename SpiMaster, typename Xlat, typename Xblank>
+		template <uint16_t channels, typename SpiMaster, typename Xlat, typename Xblank, uint8_t sceneCount>
 		uint8_t
-		PwmModule<channels, SpiMaster, Xlat, Xblank>::getModuleTypeId() const
+		PwmModule<channels, SpiMaster, Xlat, Xblank, sceneCount>::getModuleTypeId() const
 		{
 			return static_cast<uint8_t>(static_cast<uint16_t> (events::PwmEvent::BASE) >> 8);
 		}
 
- 		template <uint16_t channels, typename SpiMaster, typename Xlat, typename Xblank>
+ 		template <uint16_t channels, typename SpiMaster, typename Xlat, typename Xblank, uint8_t sceneCount>
 		bool
-		PwmModule<channels, SpiMaster, Xlat, Xblank>::run()
+		PwmModule<channels, SpiMaster, Xlat, Xblank, sceneCount>::run()
 		{
 			PT_BEGIN();
 
+			PT_CALL(restoreSnapshot());
+
 			do
 			{
-				PT_WAIT_WHILE(eventQueue.empty());
+				PT_WAIT_UNTIL(!eventQueue.empty() || fadeTimer.isExpired() || snapshotTimer.isExpired() || snapshotDeadlineTimer.isExpired());
 
-				currentEvent = eventQueue.front();
-				eventQueue.pop();
-
-				if (currentEvent->getType() == static_cast<uint16_t>(events::PwmEvent::REQUEST_STATUS))
-				{
-					PT_CALL(handleRequestStatusEvent(std::static_pointer_cast<events::PwmRequestStatusEvent>(currentEvent)));
-				}
-				else if (currentEvent->getType() == static_cast<uint16_t>(events::PwmEvent::ENABLE))
-				{
-					PT_CALL(handleEnableEvent(std::static_pointer_cast<events::PwmEnableEvent>(currentEvent)));
-				}
-				else if (currentEvent->getType() == static_cast<uint16_t>(events::PwmEvent::DISABLE))
-				{
-					PT_CALL(handleDisableEvent(std::static_pointer_cast<events::PwmDisableEvent>(currentEvent)));
-				}
-				else if (currentEvent->getType() == static_cast<uint16_t>(events::PwmEvent::REQUEST_CHANNEL))
-				{
-					PT_CALL(handleRequestChannelEvent(std::static_pointer_cast<events::PwmRequestChannelEvent>(currentEvent)));
-				}
-				else if (currentEvent->getType() == static_cast<uint16_t>(events::PwmEvent::UPDATE_CHANNEL))
+				if (fadeTimer.isExpired())
 				{
-					PT_CALL(handleUpdateChannelEvent(std::static_pointer_cast<events::PwmUpdateChannelEvent>(currentEvent)));
+					PT_CALL(updateFade());
+					continue;
 				}
-				else if (currentEvent->getType() == static_cast<uint16_t>(events::PwmEvent::REQUEST_RGBW_CHANNEL))
-				{
-					PT_CALL(handleRequestRgbwChannelEvent(std::static_pointer_cast<events::PwmRequestRgbwChannelEvent>(currentEvent)));
-				}
-				else if (currentEvent->getType() == static_cast<uint16_t>(events::PwmEvent::UPDATE_RGBW_CHANNEL))
+
+				if (snapshotTimer.isExpired() || snapshotDeadlineTimer.isExpired())
 				{
-					PT_CALL(handleUpdateRgbwChannelEvent(std::static_pointer_cast<events::PwmUpdateRgbwChannelEvent>(currentEvent)));
+					PT_CALL(writeSnapshot());
+					continue;
 				}
 
+				currentEvent = eventQueue.front();
+				eventQueue.pop();
+
+				OSSHS_TRACE(DEQUEUED, currentEvent);
+				metrics.recordEvent(currentEvent->getType());
+
+				PT_CALL(this->dispatchEvent(currentEvent));
+
+				metrics.recordHandled();
 				currentEvent.reset();
 			}
 			while (true);
@@ -97,9 +97,9 @@ namespace osshs
       		PT_END();
 		}
 
- 		template <uint16_t channels, typename SpiMaster, typename Xlat, typename Xblank>
+ 		template <uint16_t channels, typename SpiMaster, typename Xlat, typename Xblank, uint8_t sceneCount>
 		modm::ResumableResult<void>
-		PwmModule<channels, SpiMaster, Xlat, Xblank>::handleRequestStatusEvent(std::shared_ptr<events::PwmRequestStatusEvent> event)
+		PwmModule<channels, SpiMaster, Xlat, Xblank, sceneCount>::handleRequestStatusEvent(std::shared_ptr<events::PwmRequestStatusEvent> event)
 		{
 			RF_BEGIN();
 
@@ -118,9 +118,13 @@ namespace osshs
 				if (responseEvent == nullptr)
 				{
 					OSSHS_LOG_ERROR("Failed to allocate memory for a pwm status ready event.");
+					metrics.recordError();
 					RF_RETURN();
 				}
 
+				responseEvent->setDestination(event->getSource());
+				OSSHS_TRACE(RESPONDED, responseEvent);
+
 				if (event->getCallback() != nullptr)
 				{
 					event->getCallback()(responseEvent);
@@ -134,15 +138,16 @@ namespace osshs
 			RF_END();
 		}
 
- 		template <uint16_t channels, typename SpiMaster, typename Xlat, typename Xblank>
+ 		template <uint16_t channels, typename SpiMaster, typename Xlat, typename Xblank, uint8_t sceneCount>
 		modm::ResumableResult<void>
-		PwmModule<channels, SpiMaster, Xlat, Xblank>::handleEnableEvent(std::shared_ptr<events::PwmEnableEvent> event)
+		PwmModule<channels, SpiMaster, Xlat, Xblank, sceneCount>::handleEnableEvent(std::shared_ptr<events::PwmEnableEvent> event)
 		{
 			RF_BEGIN();
 
 			OSSHS_LOG_DEBUG("Handling pwm enable event.");
 
 			tlc594x.enable();
+			scheduleSnapshot();
 
 			{
 				std::shared_ptr<events::Event> responseEvent(static_cast<events::Event*> (new (std::nothrow) events::PwmStatusReadyEvent(
@@ -157,9 +162,13 @@ namespace osshs
 				if (responseEvent == nullptr)
 				{
 					OSSHS_LOG_ERROR("Failed to allocate memory for a pwm status ready event.");
+					metrics.recordError();
 					RF_RETURN();
 				}
 
+				responseEvent->setDestination(event->getSource());
+				OSSHS_TRACE(RESPONDED, responseEvent);
+
 				if (event->getCallback() != nullptr)
 				{
 					event->getCallback()(responseEvent);
@@ -173,15 +182,16 @@ namespace osshs
 			RF_END();
 		}
 
- 		template <uint16_t channels, typename SpiMaster, typename Xlat, typename Xblank>
+ 		template <uint16_t channels, typename SpiMaster, typename Xlat, typename Xblank, uint8_t sceneCount>
 		modm::ResumableResult<void>
-		PwmModule<channels, SpiMaster, Xlat, Xblank>::handleDisableEvent(std::shared_ptr<events::PwmDisableEvent> event)
+		PwmModule<channels, SpiMaster, Xlat, Xblank, sceneCount>::handleDisableEvent(std::shared_ptr<events::PwmDisableEvent> event)
 		{
 			RF_BEGIN();
 
 			OSSHS_LOG_DEBUG("Handling pwm disable event.");
 
 			tlc594x.disable();
+			scheduleSnapshot();
 
 			{
 				std::shared_ptr<events::Event> responseEvent(static_cast<events::Event*> (new (std::nothrow) events::PwmStatusReadyEvent(
@@ -196,9 +206,13 @@ namespace osshs
 				if (responseEvent == nullptr)
 				{
 					OSSHS_LOG_ERROR("Failed to allocate memory for a pwm status ready event.");
+					metrics.recordError();
 					RF_RETURN();
 				}
 
+				responseEvent->setDestination(event->getSource());
+				OSSHS_TRACE(RESPONDED, responseEvent);
+
 				if (event->getCallback() != nullptr)
 				{
 					event->getCallback()(responseEvent);
@@ -212,9 +226,9 @@ namespace osshs
 			RF_END();
 		}
 
- 		template <uint16_t channels, typename SpiMaster, typename Xlat, typename Xblank>
+ 		template <uint16_t channels, typename SpiMaster, typename Xlat, typename Xblank, uint8_t sceneCount>
 		modm::ResumableResult<void>
-		PwmModule<channels, SpiMaster, Xlat, Xblank>::handleRequestChannelEvent(std::shared_ptr<events::PwmRequestChannelEvent> event)
+		PwmModule<channels, SpiMaster, Xlat, Xblank, sceneCount>::handleRequestChannelEvent(std::shared_ptr<events::PwmRequestChannelEvent> event)
 		{
 			RF_BEGIN();
 
@@ -239,6 +253,7 @@ namespace osshs
 					if (successEvent == nullptr)
 					{
 						OSSHS_LOG_ERROR("Failed to allocate memory for a pwm channel ready event.");
+						metrics.recordError();
 						RF_RETURN();
 					}
 
@@ -246,6 +261,8 @@ namespace osshs
 				}
 				else
 				{
+					metrics.recordError();
+
 					events::PwmErrorEvent *errorEvent = new (std::nothrow) events::PwmErrorEvent(
 						events::PwmError::CHANNEL_OUT_OF_BOUNDS,
 						event->getCauseId(),
@@ -264,6 +281,9 @@ namespace osshs
 					responseEvent.reset(static_cast<events::Event*> (errorEvent));
 				}
 
+				responseEvent->setDestination(event->getSource());
+				OSSHS_TRACE(RESPONDED, responseEvent);
+
 				if (event->getCallback() != nullptr)
 				{
 					event->getCallback()(responseEvent);
@@ -277,9 +297,9 @@ namespace osshs
 			RF_END();
 		}
 
- 		template <uint16_t channels, typename SpiMaster, typename Xlat, typename Xblank>
+ 		template <uint16_t channels, typename SpiMaster, typename Xlat, typename Xblank, uint8_t sceneCount>
 		modm::ResumableResult<void>
-		PwmModule<channels, SpiMaster, Xlat, Xblank>::handleUpdateChannelEvent(std::shared_ptr<events::PwmUpdateChannelEvent> event)
+		PwmModule<channels, SpiMaster, Xlat, Xblank, sceneCount>::handleUpdateChannelEvent(std::shared_ptr<events::PwmUpdateChannelEvent> event)
 		{
 			RF_BEGIN();
 
@@ -287,11 +307,16 @@ namespace osshs
 
 			if (event->getChannel() <channels && event->getValue() <= 0xfff)
 			{
+				fadeTimer.stop();
 				tlc594x.setChannel(event->getChannel(), event->getValue());
 
-				RF_WAIT_UNTIL(ResourceLock<SpiMaster>::tryLock());
+				RF_WAIT_UNTIL(ResourceLock<SpiMaster>::tryLock(this));
+				OSSHS_TRACE(LOCKED, event);
 				RF_CALL(tlc594x.writeChannels());
+				OSSHS_TRACE(TRANSFERRED, event);
 				ResourceLock<SpiMaster>::unlock();
+
+				scheduleSnapshot();
 			}
 
 			{
@@ -312,6 +337,7 @@ namespace osshs
 						if (successEvent == nullptr)
 						{
 							OSSHS_LOG_ERROR("Failed to allocate memory for a pwm udpate success event.");
+							metrics.recordError();
 							RF_RETURN();
 						}
 
@@ -319,6 +345,8 @@ namespace osshs
 					}
 					else
 					{
+						metrics.recordError();
+
 						events::PwmErrorEvent *errorEvent = new (std::nothrow) events::PwmErrorEvent(
 							events::PwmError::VALUE_OUT_OF_BOUNDS,
 							event->getCauseId(),
@@ -339,6 +367,8 @@ namespace osshs
 				}
 				else
 				{
+					metrics.recordError();
+
 					events::PwmErrorEvent *errorEvent = new (std::nothrow) events::PwmErrorEvent(
 						events::PwmError::CHANNEL_OUT_OF_BOUNDS,
 						event->getCauseId(),
@@ -357,6 +387,9 @@ namespace osshs
 					responseEvent.reset(static_cast<events::Event*> (errorEvent));
 				}
 
+				responseEvent->setDestination(event->getSource());
+				OSSHS_TRACE(RESPONDED, responseEvent);
+
 				if (event->getCallback() != nullptr)
 				{
 					event->getCallback()(responseEvent);
@@ -370,9 +403,9 @@ namespace osshs
 			RF_END();
 		}
 
- 		template <uint16_t channels, typename SpiMaster, typename Xlat, typename Xblank>
+ 		template <uint16_t channels, typename SpiMaster, typename Xlat, typename Xblank, uint8_t sceneCount>
 		modm::ResumableResult<void>
-		PwmModule<channels, SpiMaster, Xlat, Xblank>::handleRequestRgbwChannelEvent(std::shared_ptr<events::PwmRequestRgbwChannelEvent> event)
+		PwmModule<channels, SpiMaster, Xlat, Xblank, sceneCount>::handleRequestRgbwChannelEvent(std::shared_ptr<events::PwmRequestRgbwChannelEvent> event)
 		{
 			RF_BEGIN();
 
@@ -404,6 +437,7 @@ namespace osshs
 					if (successEvent == nullptr)
 					{
 						OSSHS_LOG_ERROR("Failed to allocate memory for a pwm rgbw channel ready event.");
+						metrics.recordError();
 						RF_RETURN();
 					}
 
@@ -411,6 +445,8 @@ namespace osshs
 				}
 				else
 				{
+					metrics.recordError();
+
 					events::PwmErrorEvent *errorEvent = new (std::nothrow) events::PwmErrorEvent(
 						events::PwmError::CHANNEL_OUT_OF_BOUNDS,
 						event->getCauseId(),
@@ -429,6 +465,9 @@ namespace osshs
 					responseEvent.reset(static_cast<events::Event*> (errorEvent));
 				}
 
+				responseEvent->setDestination(event->getSource());
+				OSSHS_TRACE(RESPONDED, responseEvent);
+
 				if (event->getCallback() != nullptr)
 				{
 					event->getCallback()(responseEvent);
@@ -442,9 +481,9 @@ namespace osshs
 			RF_END();
 		}
 
- 		template <uint16_t channels, typename SpiMaster, typename Xlat, typename Xblank>
+ 		template <uint16_t channels, typename SpiMaster, typename Xlat, typename Xblank, uint8_t sceneCount>
 		modm::ResumableResult<void>
-		PwmModule<channels, SpiMaster, Xlat, Xblank>::handleUpdateRgbwChannelEvent(std::shared_ptr<events::PwmUpdateRgbwChannelEvent> event)
+		PwmModule<channels, SpiMaster, Xlat, Xblank, sceneCount>::handleUpdateRgbwChannelEvent(std::shared_ptr<events::PwmUpdateRgbwChannelEvent> event)
 		{
 			RF_BEGIN();
 
@@ -463,6 +502,8 @@ namespace osshs
 					event->getValue().blue 	<= 0xfff &&
 					event->getValue().white <= 0xfff)
 			{
+				fadeTimer.stop();
+
 				{
 					uint16_t channel = event->getChannel() * 4;
 					events::PwmRgbwValue value = event->getValue();
@@ -473,9 +514,13 @@ namespace osshs
 					tlc594x.setChannel(channel + 3, value.white);
 				}
 
-				RF_WAIT_UNTIL(ResourceLock<SpiMaster>::tryLock());
+				RF_WAIT_UNTIL(ResourceLock<SpiMaster>::tryLock(this));
+				OSSHS_TRACE(LOCKED, event);
 				RF_CALL(tlc594x.writeChannels());
+				OSSHS_TRACE(TRANSFERRED, event);
 				ResourceLock<SpiMaster>::unlock();
+
+				scheduleSnapshot();
 			}
 
 			{
@@ -497,6 +542,7 @@ namespace osshs
 						if (successEvent == nullptr)
 						{
 							OSSHS_LOG_ERROR("Failed to allocate memory for a pwm update success event.");
+							metrics.recordError();
 							RF_RETURN();
 						}
 
@@ -504,6 +550,8 @@ namespace osshs
 					}
 					else
 					{
+						metrics.recordError();
+
 						events::PwmErrorEvent *errorEvent = new (std::nothrow) events::PwmErrorEvent(
 							events::PwmError::VALUE_OUT_OF_BOUNDS,
 							event->getCauseId(),
@@ -524,6 +572,8 @@ namespace osshs
 				}
 				else
 				{
+					metrics.recordError();
+
 					events::PwmErrorEvent *errorEvent = new (std::nothrow) events::PwmErrorEvent(
 						events::PwmError::CHANNEL_OUT_OF_BOUNDS,
 						event->getCauseId(),
@@ -542,6 +592,281 @@ namespace osshs
 					responseEvent.reset(static_cast<events::Event*> (errorEvent));
 				}
 
+				responseEvent->setDestination(event->getSource());
+				OSSHS_TRACE(RESPONDED, responseEvent);
+
+				if (event->getCallback() != nullptr)
+				{
+					event->getCallback()(responseEvent);
+				}
+				else
+				{
+					System::reportEvent(responseEvent);
+				}
+			}
+
+			RF_END();
+		}
+
+ 		template <uint16_t channels, typename SpiMaster, typename Xlat, typename Xblank, uint8_t sceneCount>
+		modm::ResumableResult<void>
+		PwmModule<channels, SpiMaster, Xlat, Xblank, sceneCount>::handleStoreSceneEvent(std::shared_ptr<events::PwmStoreSceneEvent> event)
+		{
+			RF_BEGIN();
+
+			OSSHS_LOG_DEBUG("Handling pwm store scene event(scene = %u, fadeTime = %u).", event->getScene(), event->getFadeTime());
+
+			currentSuccess = false;
+
+			if (event->getScene() < sceneCount)
+			{
+				storageData.reset(new (std::nothrow) uint8_t[SCENE_LENGTH]);
+
+				if (storageData == nullptr)
+				{
+					OSSHS_LOG_ERROR("Failed to allocate memory for a buffer(bufferLength = %u).", SCENE_LENGTH);
+					metrics.recordError();
+					RF_RETURN();
+				}
+
+				{
+					Scene &scene = scenes[event->getScene()];
+					bool fading = fadeTimer.isArmed() || fadeTimer.isExpired();
+
+					scene.loaded = true;
+					scene.stored = true;
+					scene.fadeTime = event->getFadeTime();
+
+					storageData[0] = SCENE_MAGIC;
+					storageData[1] = scene.fadeTime & 0xff;
+					storageData[2] = (scene.fadeTime >> 8);
+
+					for (uint16_t i = 0; i < channels; i++)
+					{
+						scene.values[i] = fading ? fadeTo[i] : tlc594x.getChannel(i);
+
+						storageData[3 + i * 2] = scene.values[i] & 0xff;
+						storageData[4 + i * 2] = (scene.values[i] >> 8);
+					}
+				}
+
+				currentSuccess = RF_CALL(writeStorage(sceneAddress + event->getScene() * SCENE_SLOT_LENGTH, SCENE_LENGTH));
+				storageData.reset();
+
+				// Keep the cache in step with the EEPROM, so a failed write is not recalled until it succeeds.
+				if (!currentSuccess)
+				{
+					scenes[event->getScene()].loaded = false;
+				}
+			}
+
+			{
+				std::shared_ptr<events::Event> responseEvent;
+
+				if (event->getScene() >= sceneCount)
+				{
+					metrics.recordError();
+
+					events::PwmErrorEvent *errorEvent = new (std::nothrow) events::PwmErrorEvent(
+						events::PwmError::SCENE_OUT_OF_BOUNDS,
+						event->getCauseId(),
+						[=](std::shared_ptr<osshs::events::Event> event) -> void
+						{
+							this->handleEvent(event);
+						}
+					);
+
+					if (errorEvent == nullptr)
+					{
+						OSSHS_LOG_ERROR("Failed to allocate memory for a pwm error event.");
+						RF_RETURN();
+					}
+
+					responseEvent.reset(static_cast<events::Event*> (errorEvent));
+				}
+				else if (!currentSuccess)
+				{
+					metrics.recordError();
+
+					events::PwmErrorEvent *errorEvent = new (std::nothrow) events::PwmErrorEvent(
+						events::PwmError::STORAGE_FAILED,
+						event->getCauseId(),
+						[=](std::shared_ptr<osshs::events::Event> event) -> void
+						{
+							this->handleEvent(event);
+						}
+					);
+
+					if (errorEvent == nullptr)
+					{
+						OSSHS_LOG_ERROR("Failed to allocate memory for a pwm error event.");
+						RF_RETURN();
+					}
+
+					responseEvent.reset(static_cast<events::Event*> (errorEvent));
+				}
+				else
+				{
+					events::PwmUpdateSuccessEvent *successEvent = new (std::nothrow) events::PwmUpdateSuccessEvent(
+						event->getCauseId(),
+						[=](std::shared_ptr<osshs::events::Event> event) -> void
+						{
+							this->handleEvent(event);
+						}
+					);
+
+					if (successEvent == nullptr)
+					{
+						OSSHS_LOG_ERROR("Failed to allocate memory for a pwm update success event.");
+						metrics.recordError();
+						RF_RETURN();
+					}
+
+					responseEvent.reset(static_cast<events::Event*> (successEvent));
+				}
+
+				responseEvent->setDestination(event->getSource());
+				OSSHS_TRACE(RESPONDED, responseEvent);
+
+				if (event->getCallback() != nullptr)
+				{
+					event->getCallback()(responseEvent);
+				}
+				else
+				{
+					System::reportEvent(responseEvent);
+				}
+			}
+
+			RF_END();
+		}
+
+ 		template <uint16_t channels, typename SpiMaster, typename Xlat, typename Xblank, uint8_t sceneCount>
+		modm::ResumableResult<void>
+		PwmModule<channels, SpiMaster, Xlat, Xblank, sceneCount>::handleRecallSceneEvent(std::shared_ptr<events::PwmRecallSceneEvent> event)
+		{
+			RF_BEGIN();
+
+			OSSHS_LOG_DEBUG("Handling pwm recall scene event(scene = %u).", event->getScene());
+
+			currentSuccess = true;
+
+			if (event->getScene() < sceneCount)
+			{
+				if (!scenes[event->getScene()].loaded)
+				{
+					currentSuccess = RF_CALL(readScene(event->getScene()));
+				}
+
+				if (currentSuccess && scenes[event->getScene()].stored)
+				{
+					{
+						const Scene &scene = scenes[event->getScene()];
+
+						fadeStart = Time::getSystemTime<uint32_t, Time::Precision::Milliseconds>();
+						fadeTime = scene.fadeTime;
+
+						for (uint16_t i = 0; i < channels; i++)
+						{
+							fadeFrom[i] = tlc594x.getChannel(i);
+							fadeTo[i] = scene.values[i];
+						}
+					}
+
+					RF_CALL(updateFade());
+					scheduleSnapshot();
+				}
+			}
+
+			{
+				std::shared_ptr<events::Event> responseEvent;
+
+				if (event->getScene() >= sceneCount)
+				{
+					metrics.recordError();
+
+					events::PwmErrorEvent *errorEvent = new (std::nothrow) events::PwmErrorEvent(
+						events::PwmError::SCENE_OUT_OF_BOUNDS,
+						event->getCauseId(),
+						[=](std::shared_ptr<osshs::events::Event> event) -> void
+						{
+							this->handleEvent(event);
+						}
+					);
+
+					if (errorEvent == nullptr)
+					{
+						OSSHS_LOG_ERROR("Failed to allocate memory for a pwm error event.");
+						RF_RETURN();
+					}
+
+					responseEvent.reset(static_cast<events::Event*> (errorEvent));
+				}
+				else if (!currentSuccess)
+				{
+					metrics.recordError();
+
+					events::PwmErrorEvent *errorEvent = new (std::nothrow) events::PwmErrorEvent(
+						events::PwmError::STORAGE_FAILED,
+						event->getCauseId(),
+						[=](std::shared_ptr<osshs::events::Event> event) -> void
+						{
+							this->handleEvent(event);
+						}
+					);
+
+					if (errorEvent == nullptr)
+					{
+						OSSHS_LOG_ERROR("Failed to allocate memory for a pwm error event.");
+						RF_RETURN();
+					}
+
+					responseEvent.reset(static_cast<events::Event*> (errorEvent));
+				}
+				else if (!scenes[event->getScene()].stored)
+				{
+					metrics.recordError();
+
+					events::PwmErrorEvent *errorEvent = new (std::nothrow) events::PwmErrorEvent(
+						events::PwmError::SCENE_NOT_STORED,
+						event->getCauseId(),
+						[=](std::shared_ptr<osshs::events::Event> event) -> void
+						{
+							this->handleEvent(event);
+						}
+					);
+
+					if (errorEvent == nullptr)
+					{
+						OSSHS_LOG_ERROR("Failed to allocate memory for a pwm error event.");
+						RF_RETURN();
+					}
+
+					responseEvent.reset(static_cast<events::Event*> (errorEvent));
+				}
+				else
+				{
+					events::PwmUpdateSuccessEvent *successEvent = new (std::nothrow) events::PwmUpdateSuccessEvent(
+						event->getCauseId(),
+						[=](std::shared_ptr<osshs::events::Event> event) -> void
+						{
+							this->handleEvent(event);
+						}
+					);
+
+					if (successEvent == nullptr)
+					{
+						OSSHS_LOG_ERROR("Failed to allocate memory for a pwm update success event.");
+						metrics.recordError();
+						RF_RETURN();
+					}
+
+					responseEvent.reset(static_cast<events::Event*> (successEvent));
+				}
+
+				responseEvent->setDestination(event->getSource());
+				OSSHS_TRACE(RESPONDED, responseEvent);
+
 				if (event->getCallback() != nullptr)
 				{
 					event->getCallback()(responseEvent);
@@ -554,5 +879,330 @@ namespace osshs
 
 			RF_END();
 		}
+
+ 		template <uint16_t channels, typename SpiMaster, typename Xlat, typename Xblank, uint8_t sceneCount>
+		modm::ResumableResult<bool>
+		PwmModule<channels, SpiMaster, Xlat, Xblank, sceneCount>::writeStorage(uint16_t address, uint16_t length)
+		{
+			RF_BEGIN();
+
+			for (storageOffset = 0; storageOffset < length; storageOffset += SCENE_PAGE_SIZE)
+			{
+				reportStorageRequest(new (std::nothrow) events::EepromUpdateDataEvent(
+					address + storageOffset,
+					std::shared_ptr<uint8_t[]>(storageData, storageData.get() + storageOffset),
+					std::min<uint16_t>(SCENE_PAGE_SIZE, length - storageOffset),
+					events::Event::CAUSE_ID_GENERATE,
+					[=](std::shared_ptr<osshs::events::Event> event) -> void
+					{
+						if (event->getCauseId() == this->storageCauseId)
+							this->storageResponse = event;
+					}
+				));
+
+				RF_WAIT_UNTIL(storageResponse != nullptr || storageTimer.isExpired());
+				storageTimer.stop();
+
+				if (storageResponse == nullptr || storageResponse->getType() != events::EepromUpdateSuccessEvent::TYPE)
+				{
+					OSSHS_LOG_WARNING("Failed to write pwm storage(address = 0x%04x, offset = %u).", address, storageOffset);
+					storageResponse.reset();
+					RF_RETURN(false);
+				}
+
+				storageResponse.reset();
+			}
+
+			RF_END_RETURN(true);
+		}
+
+ 		template <uint16_t channels, typename SpiMaster, typename Xlat, typename Xblank, uint8_t sceneCount>
+		modm::ResumableResult<bool>
+		PwmModule<channels, SpiMaster, Xlat, Xblank, sceneCount>::readScene(uint8_t scene)
+		{
+			RF_BEGIN();
+
+			reportStorageRequest(new (std::nothrow) events::EepromRequestDataEvent(
+				sceneAddress + scene * SCENE_SLOT_LENGTH,
+				SCENE_LENGTH,
+				events::Event::CAUSE_ID_GENERATE,
+				[=](std::shared_ptr<osshs::events::Event> event) -> void
+				{
+					if (event->getCauseId() == this->storageCauseId)
+						this->storageResponse = event;
+				}
+			));
+
+			RF_WAIT_UNTIL(storageResponse != nullptr || storageTimer.isExpired());
+			storageTimer.stop();
+
+			if (storageResponse == nullptr || storageResponse->getType() != events::EepromDataReadyEvent::TYPE)
+			{
+				OSSHS_LOG_WARNING("Failed to read pwm scene(scene = %u).", scene);
+				storageResponse.reset();
+				RF_RETURN(false);
+			}
+
+			{
+				std::shared_ptr<events::EepromDataReadyEvent> response = std::static_pointer_cast<events::EepromDataReadyEvent>(storageResponse);
+				std::shared_ptr<uint8_t[]> data = response->getData();
+				Scene &cached = scenes[scene];
+
+				cached.loaded = true;
+				cached.stored = response->getDataLen() == SCENE_LENGTH && data[0] == SCENE_MAGIC;
+
+				if (cached.stored)
+				{
+					cached.fadeTime = data[1] | (data[2] << 8);
+
+					for (uint16_t i = 0; i < channels; i++)
+					{
+						cached.values[i] = data[3 + i * 2] | (data[4 + i * 2] << 8);
+						cached.stored = cached.stored && cached.values[i] <= 0xfff;
+					}
+				}
+
+				storageResponse.reset();
+			}
+
+			RF_END_RETURN(true);
+		}
+
+ 		template <uint16_t channels, typename SpiMaster, typename Xlat, typename Xblank, uint8_t sceneCount>
+		modm::ResumableResult<void>
+		PwmModule<channels, SpiMaster, Xlat, Xblank, sceneCount>::updateFade()
+		{
+			RF_BEGIN();
+
+			{
+				uint32_t elapsed = Time::getSystemTime<uint32_t, Time::Precision::Milliseconds>() - fadeStart;
+
+				if (elapsed < fadeTime)
+				{
+					fadeTimer.start(FADE_INTERVAL);
+				}
+				else
+				{
+					elapsed = fadeTime;
+					fadeTimer.stop();
+				}
+
+				for (uint16_t i = 0; i < channels; i++)
+				{
+					int32_t delta = static_cast<int32_t>(fadeTo[i]) - fadeFrom[i];
+					tlc594x.setChannel(i, (fadeTime == 0) ? fadeTo[i] : fadeFrom[i] + delta * static_cast<int32_t>(elapsed) / fadeTime);
+				}
+			}
+
+			RF_WAIT_UNTIL(ResourceLock<SpiMaster>::tryLock(this));
+			RF_CALL(tlc594x.writeChannels());
+			ResourceLock<SpiMaster>::unlock();
+
+			RF_END();
+		}
+
+ 		template <uint16_t channels, typename SpiMaster, typename Xlat, typename Xblank, uint8_t sceneCount>
+		modm::ResumableResult<void>
+		PwmModule<channels, SpiMaster, Xlat, Xblank, sceneCount>::restoreSnapshot()
+		{
+			RF_BEGIN();
+
+			snapshotRestoreStart = Time::getSystemTime<uint32_t, Time::Precision::Microseconds>();
+
+			// All slots in one read, so the restore costs a single EEPROM transaction.
+			reportStorageRequest(new (std::nothrow) events::EepromRequestDataEvent(
+				snapshotAddress,
+				SNAPSHOT_SLOTS * SNAPSHOT_SLOT_LENGTH,
+				events::Event::CAUSE_ID_GENERATE,
+				[=](std::shared_ptr<osshs::events::Event> event) -> void
+				{
+					if (event->getCauseId() == this->storageCauseId)
+						this->storageResponse = event;
+				}
+			));
+
+			RF_WAIT_UNTIL(storageResponse != nullptr || storageTimer.isExpired());
+			storageTimer.stop();
+
+			if (storageResponse == nullptr || storageResponse->getType() != events::EepromDataReadyEvent::TYPE ||
+				std::static_pointer_cast<events::EepromDataReadyEvent>(storageResponse)->getDataLen() != SNAPSHOT_SLOTS * SNAPSHOT_SLOT_LENGTH)
+			{
+				OSSHS_LOG_WARNING("Failed to read pwm snapshots.");
+				metrics.recordError();
+			}
+			else
+			{
+				std::shared_ptr<uint8_t[]> data = std::static_pointer_cast<events::EepromDataReadyEvent>(storageResponse)->getData();
+
+				for (uint8_t slot = 0; slot < SNAPSHOT_SLOTS; slot++)
+				{
+					const uint8_t *slotData = data.get() + slot * SNAPSHOT_SLOT_LENGTH;
+					const uint8_t *crcData = slotData + SNAPSHOT_LENGTH - 4;
+					uint16_t sequence = slotData[1] | (slotData[2] << 8);
+					uint32_t crc = crcData[0] | (crcData[1] << 8) | (crcData[2] << 16) | (static_cast<uint32_t>(crcData[3]) << 24);
+
+					if (slotData[0] != SNAPSHOT_MAGIC || Crc32::update(Crc32::INITIAL, slotData, SNAPSHOT_LENGTH - 4) != crc)
+					{
+						continue;
+					}
+
+					// Sequence numbers wrap, so newer means ahead by less than half the range.
+					if (snapshot.valid && static_cast<int16_t>(sequence - snapshot.sequence) <= 0)
+					{
+						continue;
+					}
+
+					snapshot.valid = true;
+					snapshot.sequence = sequence;
+					snapshot.enabled = slotData[3] != 0;
+
+					for (uint16_t i = 0; i < channels; i++)
+					{
+						snapshot.values[i] = std::min<uint16_t>(slotData[4 + i * 2] | (slotData[5 + i * 2] << 8), 0xfff);
+					}
+				}
+			}
+
+			storageResponse.reset();
+
+			if (snapshot.valid)
+			{
+				for (uint16_t i = 0; i < channels; i++)
+				{
+					tlc594x.setChannel(i, snapshot.values[i]);
+				}
+
+				RF_WAIT_UNTIL(ResourceLock<SpiMaster>::tryLock(this));
+				RF_CALL(tlc594x.writeChannels());
+				ResourceLock<SpiMaster>::unlock();
+			}
+
+			if (!snapshot.valid || snapshot.enabled)
+			{
+				tlc594x.enable();
+			}
+
+			OSSHS_LOG_INFO("Restored pwm snapshot(valid = %u, sequence = %u, restoredAt = %lu us, restoreTime = %lu us).",
+				snapshot.valid, snapshot.sequence,
+				Time::getSystemTime<uint32_t, Time::Precision::Microseconds>(),
+				Time::getSystemTime<uint32_t, Time::Precision::Microseconds>() - snapshotRestoreStart);
+
+			RF_END();
+		}
+
+ 		template <uint16_t channels, typename SpiMaster, typename Xlat, typename Xblank, uint8_t sceneCount>
+		modm::ResumableResult<void>
+		PwmModule<channels, SpiMaster, Xlat, Xblank, sceneCount>::writeSnapshot()
+		{
+			RF_BEGIN();
+
+			snapshotTimer.stop();
+			snapshotDeadlineTimer.stop();
+
+			{
+				bool fading = fadeTimer.isArmed() || fadeTimer.isExpired();
+				bool changed = !snapshot.valid || snapshot.enabled != tlc594x.isEnabled();
+
+				for (uint16_t i = 0; i < channels; i++)
+				{
+					uint16_t value = fading ? fadeTo[i] : tlc594x.getChannel(i);
+
+					changed = changed || snapshot.values[i] != value;
+					snapshot.values[i] = value;
+				}
+
+				// Unchanged output costs no EEPROM write cycle.
+				if (!changed)
+				{
+					RF_RETURN();
+				}
+
+				storageData.reset(new (std::nothrow) uint8_t[SNAPSHOT_LENGTH]);
+
+				if (storageData == nullptr)
+				{
+					OSSHS_LOG_ERROR("Failed to allocate memory for a buffer(bufferLength = %u).", SNAPSHOT_LENGTH);
+					metrics.recordError();
+					RF_RETURN();
+				}
+
+				snapshot.sequence++;
+				snapshot.enabled = tlc594x.isEnabled();
+
+				storageData[0] = SNAPSHOT_MAGIC;
+				storageData[1] = snapshot.sequence & 0xff;
+				storageData[2] = (snapshot.sequence >> 8);
+				storageData[3] = snapshot.enabled;
+
+				for (uint16_t i = 0; i < channels; i++)
+				{
+					storageData[4 + i * 2] = snapshot.values[i] & 0xff;
+					storageData[5 + i * 2] = (snapshot.values[i] >> 8);
+				}
+
+				uint32_t crc = Crc32::update(Crc32::INITIAL, storageData.get(), SNAPSHOT_LENGTH - 4);
+
+				storageData[SNAPSHOT_LENGTH - 4] = crc & 0xff;
+				storageData[SNAPSHOT_LENGTH - 3] = (crc >> 8) & 0xff;
+				storageData[SNAPSHOT_LENGTH - 2] = (crc >> 16) & 0xff;
+				storageData[SNAPSHOT_LENGTH - 1] = (crc >> 24);
+			}
+
+			OSSHS_LOG_DEBUG("Writing pwm snapshot(sequence = %u).", snapshot.sequence);
+
+			snapshot.valid = RF_CALL(writeStorage(snapshotAddress + (snapshot.sequence % SNAPSHOT_SLOTS) * SNAPSHOT_SLOT_LENGTH, SNAPSHOT_LENGTH));
+			storageData.reset();
+
+			// Retry a failed write, but not often enough to flood the log while the EEPROM is gone.
+			if (!snapshot.valid)
+			{
+				metrics.recordError();
+				snapshotDeadlineTimer.start(SNAPSHOT_MAX_DELAY);
+			}
+
+			RF_END();
+		}
+
+ 		template <uint16_t channels, typename SpiMaster, typename Xlat, typename Xblank, uint8_t sceneCount>
+		void
+		PwmModule<channels, SpiMaster, Xlat, Xblank, sceneCount>::scheduleSnapshot()
+		{
+			snapshotTimer.start(SNAPSHOT_DELAY);
+
+			if (!snapshotDeadlineTimer.isArmed())
+			{
+				snapshotDeadlineTimer.start(SNAPSHOT_MAX_DELAY);
+			}
+		}
+
+ 		template <uint16_t channels, typename SpiMaster, typename Xlat, typename Xblank, uint8_t sceneCount>
+		void
+		PwmModule<channels, SpiMaster, Xlat, Xblank, sceneCount>::reportStorageRequest(events::Event *request)
+		{
+			storageResponse.reset();
+			storageTimer.start(STORAGE_TIMEOUT);
+
+			if (request == nullptr)
+			{
+				OSSHS_LOG_ERROR("Failed to allocate memory for an eeprom request event.");
+				metrics.recordError();
+				return;
+			}
+
+			std::shared_ptr<events::Event> requestEvent(request);
+
+			// The id of the last request stays reserved until the next one has its own id,
+			// so a late response to it is never taken for the answer to a later request.
+			events::CauseIdAllocator::release(storageCauseId);
+			storageCauseId = requestEvent->getCauseId();
+
+			if (!events::CauseIdAllocator::reserve(storageCauseId))
+			{
+				OSSHS_LOG_WARNING("Failed to reserve pwm storage cause id(causeId = 0x%04x).", storageCauseId);
+			}
+
+			requestEvent->setDestination(System::getNodeId());
+			System::reportEvent(requestEvent);
+		}
 	}
 }
@@ -25,29 +25,124 @@
 #ifndef OSSHS_RESOURCE_LOCK_HPP
 #define OSSHS_RESOURCE_LOCK_HPP
 
+#include <cstddef>
+#include <cstdint>
+
+#include <osshs/resource_lock_statistics.hpp>
+
 namespace osshs
 {
 	template<typename Resource>
 	class ResourceLock
 	{
 	public:
+		static constexpr std::size_t MAX_WAITERS = 8;
+		static constexpr uint32_t CLAIM_TIMEOUT = 100;
+
 		/**
 		 * @brief Try to acquire a lock on the resource specified in the template.
 		 * 
+		 * Contenders that pass an owner are queued in FIFO order. When the lock
+		 * is released, ownership is handed directly to the oldest waiter, which
+		 * claims it with its next poll. A waiter that gives up must call cancel();
+		 * a hand-off not claimed within CLAIM_TIMEOUT milliseconds is passed on by
+		 * the next contender. Contenders beyond MAX_WAITERS are not queued and
+		 * counted in getQueueOverflowCount().
+		 * An anonymous contender (nullptr owner) is never queued and only gets
+		 * the lock when it is free and nobody is waiting for it.
+		 * 
+		 * @param owner unique identifier of the contender, usually `this`.
 		 * @return true lock was acquired.
 		 * @return false lock was not acquired.
 		 */
 		static bool
-		tryLock();
+		tryLock(const void *owner = nullptr);
 
 		/**
-		 * @brief Release a previously acquired lock.
+		 * @brief Release a previously acquired lock and hand it off to the next waiter.
 		 * 
 		 */
 		static void
 		unlock();
+
+		/**
+		 * @brief Stop waiting for the lock. A hand-off to the owner which it has not
+		 * claimed yet is passed on to the next waiter.
+		 * 
+		 * @param owner contender which gives up.
+		 */
+		static void
+		cancel(const void *owner);
+
+		/**
+		 * @brief Check whether the resource is currently locked.
+		 * 
+		 * @return true resource is locked.
+		 * @return false resource is free.
+		 */
+		static bool
+		isLocked();
+
+		/**
+		 * @brief Queue overflow count getter.
+		 * 
+		 * @return uint32_t number of tryLock calls which found the wait queue full.
+		 */
+		static uint32_t
+		getQueueOverflowCount();
+
+	#ifdef ENABLE_LOCK_STATISTICS
+		/**
+		 * @brief Contention and hold time statistics getter.
+		 * 
+		 * @return const ResourceLockStatistics& statistics of this lock.
+		 */
+		static const ResourceLockStatistics&
+		getStatistics();
+	#endif  // ENABLE_LOCK_STATISTICS
 	private:
 		static bool locked;
+		static bool claimed;
+		static const void *owner;
+		static uint32_t handOffTime;
+		static uint32_t queueOverflows;
+		static bool queueFull;
+
+		static const void *waiters[MAX_WAITERS];
+		static std::size_t waitersHead;
+		static std::size_t waitersCount;
+
+	#ifdef ENABLE_LOCK_STATISTICS
+		static ResourceLockStatistics statistics;
+		static uint32_t waitersSince[MAX_WAITERS];
+
+		/**
+		 * @brief Signature naming the resource type, the statistics are identified by it.
+		 * 
+		 * @return const char* __PRETTY_FUNCTION__ of this function.
+		 */
+		static const char *
+		getSignature();
+	#endif  // ENABLE_LOCK_STATISTICS
+
+		static bool
+		isWaiting(const void *owner);
+
+		static bool
+		enqueueWaiter(const void *owner);
+
+		static const void *
+		dequeueWaiter();
+
+		static void
+		removeWaiter(const void *owner);
+
+		/**
+		 * @brief Hand the lock to the oldest waiter, or release it if nobody waits.
+		 * 
+		 */
+		static void
+		handOff();
   };
 }
 
@@ -26,19 +26,98 @@
 	#error "Don't include this file directly, use 'resource_lock.hpp' instead!"
 #endif
 
+#include <osshs/time.hpp>
+#include <osshs/log/logger.hpp>
+
 namespace osshs
 {
 	template<typename Resource>
 	bool ResourceLock<Resource>::locked = false;
 
+	template<typename Resource>
+	bool ResourceLock<Resource>::claimed = false;
+
+	template<typename Resource>
+	const void *ResourceLock<Resource>::owner = nullptr;
+
+	template<typename Resource>
+	uint32_t ResourceLock<Resource>::handOffTime = 0;
+
+	template<typename Resource>
+	uint32_t ResourceLock<Resource>::queueOverflows = 0;
+
+	template<typename Resource>
+	bool ResourceLock<Resource>::queueFull = false;
+
+	template<typename Resource>
+	const void *ResourceLock<Resource>::waiters[ResourceLock<Resource>::MAX_WAITERS];
+
+	template<typename Resource>
+	std::size_t ResourceLock<Resource>::waitersHead = 0;
+
+	template<typename Resource>
+	std::size_t ResourceLock<Resource>::waitersCount = 0;
+
+#ifdef ENABLE_LOCK_STATISTICS
+	template<typename Resource>
+	ResourceLockStatistics ResourceLock<Resource>::statistics(ResourceLock<Resource>::getSignature());
+
+	template<typename Resource>
+	uint32_t ResourceLock<Resource>::waitersSince[ResourceLock<Resource>::MAX_WAITERS];
+#endif  // ENABLE_LOCK_STATISTICS
+
 	template<typename Resource>
 	bool
-	ResourceLock<Resource>::tryLock()
+	ResourceLock<Resource>::tryLock(const void *owner)
 	{
+		// The new owner no longer polls, e.g. its resumable was aborted without cancel().
+		if (ResourceLock<Resource>::locked && !claimed && ResourceLock<Resource>::owner != owner &&
+			Time::getSystemTime<uint32_t, Time::Precision::Milliseconds>() - handOffTime >= CLAIM_TIMEOUT)
+		{
+			OSSHS_LOG_WARNING("Passing on an unclaimed resource lock(waiters = %u).", static_cast<unsigned int>(waitersCount));
+			handOff();
+		}
+
 		if (ResourceLock<Resource>::locked)
+		{
+			// Ownership might have been handed off to us by unlock().
+			if (owner != nullptr && ResourceLock<Resource>::owner == owner)
+			{
+				claimed = true;
+				return true;
+			}
+
+			if (owner == nullptr)
+				return false;
+
+			if (!isWaiting(owner))
+				enqueueWaiter(owner);
+
+		#ifdef ENABLE_LOCK_STATISTICS
+			statistics.recordFailedTryLock();
+		#endif  // ENABLE_LOCK_STATISTICS
+			return false;
+		}
+
+		// Lock is free, but older waiters are served first.
+		if (waitersCount > 0)
+		{
+			if (owner != nullptr && !isWaiting(owner))
+				enqueueWaiter(owner);
+
+		#ifdef ENABLE_LOCK_STATISTICS
+			statistics.recordFailedTryLock();
+		#endif  // ENABLE_LOCK_STATISTICS
 			return false;
+		}
 
 		ResourceLock<Resource>::locked = true;
+		ResourceLock<Resource>::owner = owner;
+		claimed = true;
+
+	#ifdef ENABLE_LOCK_STATISTICS
+		statistics.recordAcquisition(0);
+	#endif  // ENABLE_LOCK_STATISTICS
 		return true;
 	}
 
@@ -46,6 +125,155 @@ namespace osshs
 	void
 	ResourceLock<Resource>::unlock()
 	{
+	#ifdef ENABLE_LOCK_STATISTICS
+		statistics.recordRelease();
+	#endif  // ENABLE_LOCK_STATISTICS
+
+		handOff();
+	}
+
+	template<typename Resource>
+	void
+	ResourceLock<Resource>::cancel(const void *owner)
+	{
+		if (owner == nullptr)
+			return;
+
+		if (ResourceLock<Resource>::locked && !claimed && ResourceLock<Resource>::owner == owner)
+		{
+			handOff();
+			return;
+		}
+
+		removeWaiter(owner);
+	}
+
+	template<typename Resource>
+	bool
+	ResourceLock<Resource>::isLocked()
+	{
+		return ResourceLock<Resource>::locked;
+	}
+
+	template<typename Resource>
+	uint32_t
+	ResourceLock<Resource>::getQueueOverflowCount()
+	{
+		return queueOverflows;
+	}
+
+#ifdef ENABLE_LOCK_STATISTICS
+	template<typename Resource>
+	const ResourceLockStatistics&
+	ResourceLock<Resource>::getStatistics()
+	{
+		return statistics;
+	}
+
+	template<typename Resource>
+	const char *
+	ResourceLock<Resource>::getSignature()
+	{
+		return __PRETTY_FUNCTION__;
+	}
+#endif  // ENABLE_LOCK_STATISTICS
+
+	template<typename Resource>
+	bool
+	ResourceLock<Resource>::isWaiting(const void *owner)
+	{
+		for (std::size_t i = 0; i < waitersCount; i++)
+			if (waiters[(waitersHead + i) % MAX_WAITERS] == owner)
+				return true;
+
+		return false;
+	}
+
+	template<typename Resource>
+	bool
+	ResourceLock<Resource>::enqueueWaiter(const void *owner)
+	{
+		// When the queue is full the contender simply retries on its next poll, out of order.
+		if (waitersCount == MAX_WAITERS)
+		{
+			if (!queueFull)
+			{
+				queueFull = true;
+				OSSHS_LOG_WARNING("Resource lock wait queue is full(waiters = %u).", static_cast<unsigned int>(MAX_WAITERS));
+			}
+
+			queueOverflows++;
+			return false;
+		}
+
+		waiters[(waitersHead + waitersCount) % MAX_WAITERS] = owner;
+
+	#ifdef ENABLE_LOCK_STATISTICS
+		waitersSince[(waitersHead + waitersCount) % MAX_WAITERS] = Time::getSystemTime<uint32_t, Time::Precision::Microseconds>();
+	#endif  // ENABLE_LOCK_STATISTICS
+
+		waitersCount++;
+		return true;
+	}
+
+	template<typename Resource>
+	const void *
+	ResourceLock<Resource>::dequeueWaiter()
+	{
+		const void *waiter = waiters[waitersHead];
+
+		waitersHead = (waitersHead + 1) % MAX_WAITERS;
+		waitersCount--;
+		queueFull = false;
+		return waiter;
+	}
+
+	template<typename Resource>
+	void
+	ResourceLock<Resource>::removeWaiter(const void *owner)
+	{
+		std::size_t kept = 0;
+
+		for (std::size_t i = 0; i < waitersCount; i++)
+		{
+			std::size_t from = (waitersHead + i) % MAX_WAITERS;
+			std::size_t to = (waitersHead + kept) % MAX_WAITERS;
+
+			if (waiters[from] == owner)
+				continue;
+
+			waiters[to] = waiters[from];
+
+		#ifdef ENABLE_LOCK_STATISTICS
+			waitersSince[to] = waitersSince[from];
+		#endif  // ENABLE_LOCK_STATISTICS
+
+			kept++;
+		}
+
+		if (kept < waitersCount)
+			queueFull = false;
+
+		waitersCount = kept;
+	}
+
+	template<typename Resource>
+	void
+	ResourceLock<Resource>::handOff()
+	{
+		if (waitersCount > 0)
+		{
+		#ifdef ENABLE_LOCK_STATISTICS
+			statistics.recordAcquisition(Time::getSystemTime<uint32_t, Time::Precision::Microseconds>() - waitersSince[waitersHead]);
+		#endif  // ENABLE_LOCK_STATISTICS
+
+			ResourceLock<Resource>::owner = dequeueWaiter();
+			claimed = false;
+			handOffTime = Time::getSystemTime<uint32_t, Time::Precision::Milliseconds>();
+			return;
+		}
+
 		ResourceLock<Resource>::locked = false;
+		ResourceLock<Resource>::owner = nullptr;
 	}
 }
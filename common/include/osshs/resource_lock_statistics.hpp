@@ -0,0 +1,130 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2019 Linas Nikiperavicius
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef OSSHS_RESOURCE_LOCK_STATISTICS_HPP
+#define OSSHS_RESOURCE_LOCK_STATISTICS_HPP
+
+#ifdef ENABLE_LOCK_STATISTICS
+	#include <cstdint>
+	#include <vector>
+
+	namespace osshs
+	{
+		namespace events
+		{
+			struct DiagnosticsLockStatistics;
+		}
+
+		/**
+		 * @brief Contention and hold time statistics of one ResourceLock.
+		 * 
+		 * Every lock is identified by the CRC-32 of its resource type name (e.g.
+		 * zlib.crc32(b"modm::platform::SpiMaster1")), which does not depend on the
+		 * order of static initialization. Locks are enumerated in order of their id.
+		 */
+		class ResourceLockStatistics
+		{
+		public:
+			/**
+			 * @brief Construct statistics and register them, so they can be looked up by index.
+			 * 
+			 * @param signature __PRETTY_FUNCTION__ of a ResourceLock member, the resource type name is taken from it.
+			 */
+			explicit ResourceLockStatistics(const char *signature);
+
+			/**
+			 * @brief Lock id getter.
+			 * 
+			 * @return uint32_t CRC-32 of the resource type name.
+			 */
+			uint32_t
+			getId() const;
+
+			/**
+			 * @brief Record a successful acquisition.
+			 * 
+			 * @param waitTime time in microseconds the new owner spent waiting for the lock.
+			 */
+			void
+			recordAcquisition(uint32_t waitTime);
+
+			/**
+			 * @brief Record a failed tryLock call.
+			 * 
+			 */
+			void
+			recordFailedTryLock();
+
+			/**
+			 * @brief Record a release of the lock.
+			 * 
+			 */
+			void
+			recordRelease();
+
+			/**
+			 * @brief Statistics getter.
+			 * 
+			 * @return events::DiagnosticsLockStatistics collected statistics.
+			 */
+			events::DiagnosticsLockStatistics
+			getStatistics() const;
+
+			/**
+			 * @brief Registered lock count getter.
+			 * 
+			 * @return uint8_t number of locks that collect statistics.
+			 */
+			static uint8_t
+			getLockCount();
+
+			/**
+			 * @brief Look up statistics by index.
+			 * 
+			 * @param lock index in order of lock id, so it only depends on which locks are linked in.
+			 * @return Statistics or nullptr if index is out of bounds.
+			 */
+			static const ResourceLockStatistics *
+			get(uint8_t lock);
+		private:
+			uint32_t id;
+			uint32_t acquisitions;
+			uint32_t failedTryLocks;
+			uint32_t maxHoldTime;
+			uint64_t totalHoldTime;
+			uint32_t maxWaitTime;
+			uint32_t acquireTime;
+
+			ResourceLockStatistics(const ResourceLockStatistics&) = delete;
+
+			ResourceLockStatistics&
+			operator=(const ResourceLockStatistics&) = delete;
+
+			static std::vector<const ResourceLockStatistics*>&
+			registry();
+		};
+	}
+#endif  // ENABLE_LOCK_STATISTICS
+
+#endif  // OSSHS_RESOURCE_LOCK_STATISTICS_HPP
@@ -0,0 +1,202 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2019 Linas Nikiperavicius
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef OSSHS_RPC_HPP
+#define OSSHS_RPC_HPP
+
+#include <cstdint>
+#include <memory>
+
+#include <osshs/timer.hpp>
+#include <osshs/events/event.hpp>
+#include <osshs/events/system_event.hpp>
+
+#ifndef RPC_MAX_PENDING
+	#define RPC_MAX_PENDING 8
+#endif  // RPC_MAX_PENDING
+
+#ifndef RPC_MAX_QUEUED
+	#define RPC_MAX_QUEUED 16
+#endif  // RPC_MAX_QUEUED
+
+namespace osshs
+{
+	/**
+	 * @brief Correlates responses with requests by cause id.
+	 * 
+	 * Every outstanding request occupies a slot of a fixed-size pending-request
+	 * table and carries a deadline on the shared timer wheel. A response is any
+	 * reported event with the request's cause id but a different type; it is
+	 * passed to the request's callback instead of the event subscriptions.
+	 * Requests which are not answered in time get a SystemErrorEvent(TIMEOUT).
+	 * Queued requests which call() refuses once their turn comes, e.g. because
+	 * their cause id is already pending, get a SystemErrorEvent(REJECTED).
+	 * Requests must be made without an event callback: a module answers through
+	 * the request's callback when it has one, so the response would never reach
+	 * handleResponse() and the request would time out. call() and pipeline()
+	 * reject such requests.
+	 */
+	class Rpc
+	{
+	public:
+		static constexpr uint32_t DEFAULT_TIMEOUT = 500;
+
+		/**
+		 * @brief Report a request and wait for its response.
+		 * 
+		 * @param request request event.
+		 * @param callback callback to call with the response or a timeout error.
+		 * @param timeout timeout in milliseconds.
+		 * @return true request was reported.
+		 * @return false request has an event callback, concurrency limit is reached or the cause id is already pending.
+		 */
+		static bool
+		call(std::shared_ptr<events::Event> request, events::EventCallback callback, uint32_t timeout = DEFAULT_TIMEOUT);
+
+		/**
+		 * @brief Queue a request to be reported as soon as the concurrency limit allows.
+		 * Meant for bulk operations, which keep up to the concurrency limit of requests in flight.
+		 * 
+		 * @param request request event.
+		 * @param callback callback to call with the response, a timeout error or a rejected error.
+		 * @param timeout timeout in milliseconds, counted from when the request is reported.
+		 * @return true request was queued.
+		 * @return false request has an event callback or queue is full.
+		 */
+		static bool
+		pipeline(std::shared_ptr<events::Event> request, events::EventCallback callback, uint32_t timeout = DEFAULT_TIMEOUT);
+
+		/**
+		 * @brief Limit the number of requests in flight.
+		 * 
+		 * @param limit limit between 1 and RPC_MAX_PENDING.
+		 */
+		static void
+		setConcurrencyLimit(uint8_t limit);
+
+		/**
+		 * @brief Concurrency limit getter.
+		 * 
+		 * @return uint8_t maximum number of requests in flight.
+		 */
+		static uint8_t
+		getConcurrencyLimit();
+
+		/**
+		 * @brief Pending request count getter.
+		 * 
+		 * @return uint8_t number of requests in flight.
+		 */
+		static uint8_t
+		getPendingCount();
+
+		/**
+		 * @brief Check whether a request with a cause id is waiting for its response.
+		 * 
+		 * @param causeId cause id.
+		 * @return true request is pending.
+		 */
+		static bool
+		isPending(uint16_t causeId);
+
+		/**
+		 * @brief Pass a reported event to the callback of the request it answers.
+		 * Should only be called from System.
+		 * 
+		 * @param event reported event.
+		 * @return true event was a response and has been consumed.
+		 * @return false event is not a response to a pending request.
+		 */
+		static bool
+		handleResponse(std::shared_ptr<events::Event> event);
+
+		/**
+		 * @brief Report queued requests while the concurrency limit allows. Called from the main loop.
+		 * 
+		 */
+		static void
+		update();
+	private:
+		struct PendingRequest
+		{
+			bool active;
+			uint16_t causeId;
+			uint16_t type;
+			uint8_t destination;
+			events::EventCallback callback;
+			Timer timer;
+		};
+
+		struct QueuedRequest
+		{
+			std::shared_ptr<events::Event> request;
+			events::EventCallback callback;
+			uint32_t timeout;
+		};
+
+		static PendingRequest pending[RPC_MAX_PENDING];
+		static QueuedRequest queue[RPC_MAX_QUEUED];
+		static uint8_t queueHead;
+		static uint8_t queueLength;
+		static uint8_t pendingCount;
+		static uint8_t concurrencyLimit;
+
+		/**
+		 * @brief Find the pending request with a cause id. The table is probed from causeId % RPC_MAX_PENDING.
+		 * 
+		 * @param causeId cause id.
+		 * @return PendingRequest* pending request or nullptr if none is pending.
+		 */
+		static PendingRequest *
+		find(uint16_t causeId);
+
+		/**
+		 * @brief Release a pending request slot.
+		 * 
+		 * @param request pending request.
+		 */
+		static void
+		release(PendingRequest *request);
+
+		/**
+		 * @brief Fail a pending request whose deadline has passed.
+		 * 
+		 * @param request pending request.
+		 */
+		static void
+		expire(PendingRequest *request);
+
+		/**
+		 * @brief Answer a request with a SystemErrorEvent, so its callback always runs exactly once.
+		 * 
+		 * @param callback request callback.
+		 * @param causeId request cause id.
+		 * @param error error to report.
+		 */
+		static void
+		fail(events::EventCallback callback, uint16_t causeId, events::SystemError error);
+	};
+}
+
+#endif  // OSSHS_RPC_HPP
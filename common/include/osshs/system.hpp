@@ -25,17 +25,32 @@
 #ifndef OSSHS_SYSTEM_HPP
 #define OSSHS_SYSTEM_HPP
 
+#include <unordered_map>
+#include <vector>
+
+#include <osshs/delegate.hpp>
 #include <osshs/protocol/interfaces/interface.hpp>
 #include <osshs/modules/module.hpp>
 #include <osshs/events/event_selector.hpp>
 
+/**
+ * Id of this node, set per node with node_id=<id>. Nodes sharing an id take each other's
+ * events for their own, so there is no default: an unset id keeps System::loop from starting.
+ */
+#ifndef OSSHS_NODE_ID
+	#define OSSHS_NODE_ID osshs::events::Event::ADDRESS_BROADCAST
+#endif  // OSSHS_NODE_ID
+
 namespace osshs
 {
+	typedef Delegate<void ()> SubscriptionHandler;
+
 	class System
 	{
 	public:
 		/**
-		 * @brief Initialize system.
+		 * @brief Initialize system. The log output must be set up before, since boot
+		 * messages are drained from here on without waiting for loop().
 		 * 
 		 */
 		static void
@@ -67,21 +82,83 @@ namespace osshs
 		subscribeEvent(events::EventSelector selector, events::EventCallback subscription);
 
 		/**
-		 * @brief Report event to system.
+		 * @brief Set the handler called whenever a subscription adds a new selector,
+		 * e.g. to reprogram CAN acceptance filters. Replaces the previous handler.
+		 * 
+		 * @param handler handler to call, nullptr to remove it.
+		 */
+		static void
+		setSubscriptionHandler(SubscriptionHandler handler);
+
+		/**
+		 * @brief Report event to system. Events addressed to this node are delivered to the
+		 * subscribers directly; events made on this node for other nodes are passed to the interfaces.
 		 * 
 		 * @param event event to report.
 		 */
 		static void
 		reportEvent(std::shared_ptr<events::Event> event);
 
+		/**
+		 * @brief Set the id of this node. Events made afterwards carry it as their source address.
+		 * 
+		 * @param nodeId node id in range 0x00-0x7f.
+		 */
+		static void
+		setNodeId(uint8_t nodeId);
+
+		/**
+		 * @brief Node id getter.
+		 * 
+		 * @return uint8_t id of this node.
+		 */
+		static uint8_t
+		getNodeId();
+
+		/**
+		 * @brief Join a multicast group, so events addressed to it are delivered to this node.
+		 * 
+		 * @param group group address in range 0x80-0xfe.
+		 */
+		static void
+		joinGroup(uint8_t group);
+
+		/**
+		 * @brief Leave a multicast group.
+		 * 
+		 * @param group group address in range 0x80-0xfe.
+		 */
+		static void
+		leaveGroup(uint8_t group);
+
+		/**
+		 * @brief Check whether an event destination address refers to this node.
+		 * 
+		 * @param destination destination address.
+		 * @return true if destination is broadcast, this node's id or a joined group.
+		 */
+		static bool
+		isAddressed(uint8_t destination);
+
+		/**
+		 * @brief Get the selectors of all event subscriptions, e.g. to derive CAN acceptance filters.
+		 * 
+		 * @return std::vector<events::EventSelector> subscribed event selectors.
+		 */
+		static std::vector<events::EventSelector>
+		getEventSelectors();
+
 		/**
 		 * @brief Enter main system loop. Does not return.
+		 * If no node id was set, only the log is drained and no events are handled.
 		 * 
 		 */
 		static void
 		loop();
 	private:
+		static uint32_t groups[4];
 		static std::unordered_map<events::EventSelector, std::vector<events::EventCallback>> eventSubscriptions;
+		static SubscriptionHandler subscriptionHandler;
 	};
 }
 
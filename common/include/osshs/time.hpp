@@ -35,6 +35,7 @@ namespace osshs
 		enum class
 		Precision
 		{
+			Microseconds,
 			Milliseconds,
 			Seconds
 		};
@@ -49,15 +50,28 @@ namespace osshs
 		/**
 		 * @brief System time getter.
 		 * 
+		 * Does not disable interrupts. Microsecond precision is derived from the
+		 * current SysTick counter value and must not be requested from an interrupt
+		 * that has a higher priority than SysTick.
+		 * 
 		 * @tparam T return type.
-		 * @tparam precision Either Precision::Milliseconds or Precision::Seconds.
+		 * @tparam precision One of Precision::Microseconds, Precision::Milliseconds or Precision::Seconds.
 		 * @return T system time.
 		 */
 		template<typename T, Precision precision>
 		static T
 		getSystemTime();
 	private:
-		static uint64_t systemTime;
+		static volatile uint32_t systemTimeLow;
+		static volatile uint32_t systemTimeHigh;
+
+		/**
+		 * @brief Read the 64-bit millisecond counter without locking.
+		 * 
+		 * @return uint64_t system time in milliseconds.
+		 */
+		static uint64_t
+		readSystemTime();
 
 		/**
 		 * @brief Increment system time. Called from interrupt.
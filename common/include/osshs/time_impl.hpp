@@ -34,12 +34,50 @@ namespace osshs
 	T
 	Time::getSystemTime()
 	{
-		modm::atomic::Lock lock;
+		if constexpr (precision == Precision::Microseconds)
+		{
+			uint64_t milliseconds;
+			uint32_t ticks;
+
+			// Retry if the millisecond tick happened while SysTick was sampled.
+			do
+			{
+				milliseconds = readSystemTime();
+				ticks = SysTick->LOAD - SysTick->VAL;
+			}
+			while (milliseconds != readSystemTime());
+
+			return static_cast<T>(milliseconds * 1000 + (ticks * 1000) / (SysTick->LOAD + 1));
+		}
 
 		if constexpr (precision == Precision::Milliseconds)
-			return static_cast<T>(systemTime);
+		{
+			// A single word read is atomic, no need to assemble the high half.
+			if constexpr (sizeof(T) <= sizeof(uint32_t))
+				return static_cast<T>(systemTimeLow);
+			else
+				return static_cast<T>(readSystemTime());
+		}
 
 		if constexpr (precision == Precision::Seconds)
-			return static_cast<T>(systemTime) / 1000;
+			return static_cast<T>(readSystemTime() / 1000);
+	}
+
+	inline uint64_t
+	Time::readSystemTime()
+	{
+		uint32_t high;
+		uint32_t low;
+
+		// tick() can only interrupt us, never the other way round, so a stable
+		// high word guarantees that both halves belong to the same value.
+		do
+		{
+			high = systemTimeHigh;
+			low = systemTimeLow;
+		}
+		while (high != systemTimeHigh);
+
+		return (static_cast<uint64_t>(high) << 32) | low;
 	}
 }
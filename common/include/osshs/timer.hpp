@@ -0,0 +1,120 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2019 Linas Nikiperavicius
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef OSSHS_TIMER_HPP
+#define OSSHS_TIMER_HPP
+
+#include <cstdint>
+
+#include <osshs/delegate.hpp>
+
+namespace osshs
+{
+	class TimerWheel;
+
+	typedef Delegate<void ()> TimerCallback;
+
+	/**
+	 * @brief Timer on the shared TimerWheel.
+	 * 
+	 * Expiry does not wake anything: modules still run on every pass of the main
+	 * loop, and a protothread waits for a timer by polling isExpired(), which only
+	 * reads a flag instead of the system time. The callback is meant for code that
+	 * is not polled, like Rpc deadlines.
+	 */
+	class Timer
+	{
+	public:
+		/**
+		 * @brief Construct a stopped timer.
+		 * 
+		 * @param callback callback to call from the main loop when the timer expires.
+		 */
+		Timer(TimerCallback callback = nullptr);
+
+		/**
+		 * @brief Destroy the timer, cancelling it if it is armed.
+		 * 
+		 */
+		~Timer();
+
+		/**
+		 * @brief Arm or re-arm the timer. O(1).
+		 * 
+		 * @param timeout timeout in milliseconds.
+		 */
+		void
+		start(uint32_t timeout);
+
+		/**
+		 * @brief Cancel the timer and clear its expired flag. O(1).
+		 * 
+		 */
+		void
+		stop();
+
+		/**
+		 * @brief Check whether the timer is armed.
+		 * 
+		 * @return true timer is armed and has not expired yet.
+		 * @return false timer is stopped or expired.
+		 */
+		bool
+		isArmed() const;
+
+		/**
+		 * @brief Check whether the timer has expired since it was last started.
+		 * 
+		 * @return true timer has expired.
+		 * @return false timer is stopped or still armed.
+		 */
+		bool
+		isExpired() const;
+
+		/**
+		 * @brief Callback setter.
+		 * 
+		 * @param callback callback to call from the main loop when the timer expires.
+		 */
+		void
+		setCallback(TimerCallback callback);
+	private:
+		Timer *next;
+		Timer *previous;
+		Timer **slot;
+		uint32_t expiry;
+		bool armed;
+		bool expired;
+		TimerCallback callback;
+
+		Timer(const Timer&) = delete;
+
+		Timer&
+		operator=(const Timer&) = delete;
+
+		friend TimerWheel;
+	};
+}
+
+#endif  // OSSHS_TIMER_HPP
@@ -0,0 +1,111 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2019 Linas Nikiperavicius
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef OSSHS_TIMER_WHEEL_HPP
+#define OSSHS_TIMER_WHEEL_HPP
+
+#include <cstdint>
+#include <osshs/timer.hpp>
+
+namespace osshs
+{
+	/**
+	 * @brief Hierarchical timer wheel, four levels with 1 ms root slots.
+	 * 
+	 * Arming and cancelling a Timer is O(1), and each update() only visits the
+	 * slots of the milliseconds that passed. Expired timers get their flag set
+	 * and their callback called; the modules which poll them are not notified.
+	 */
+	class TimerWheel
+	{
+	public:
+		/**
+		 * @brief Longest timeout in milliseconds a timer can be armed with.
+		 * 
+		 */
+		static constexpr uint32_t MAX_TIMEOUT = (1ul << 26) - 1;
+
+		/**
+		 * @brief Initialize the timer wheel. Must be called before any timer is armed.
+		 * 
+		 */
+		static void
+		initialize();
+
+		/**
+		 * @brief Advance the wheel up to the current system time and expire due timers.
+		 * Called from the main loop, so timer callbacks never run in interrupt context.
+		 * 
+		 */
+		static void
+		update();
+	private:
+		static constexpr uint8_t ROOT_BITS = 8;
+		static constexpr uint8_t LEVEL_BITS = 6;
+		static constexpr uint8_t LEVELS = 4;
+
+		static constexpr uint16_t ROOT_SIZE = 1 << ROOT_BITS;
+		static constexpr uint16_t LEVEL_SIZE = 1 << LEVEL_BITS;
+
+		static Timer *root[ROOT_SIZE];
+		static Timer *levels[LEVELS - 1][LEVEL_SIZE];
+		static uint32_t currentTime;
+
+		/**
+		 * @brief Insert timer into the slot matching its expiry time.
+		 * 
+		 * @param timer timer to insert.
+		 */
+		static void
+		schedule(Timer *timer);
+
+		/**
+		 * @brief Remove timer from the slot it is linked into.
+		 * 
+		 * @param timer timer to remove.
+		 */
+		static void
+		unschedule(Timer *timer);
+
+		/**
+		 * @brief Move all timers of a higher level slot into lower levels.
+		 * 
+		 * @param level level of the slot.
+		 * @param index slot index.
+		 */
+		static void
+		cascade(uint8_t level, uint8_t index);
+
+		/**
+		 * @brief Advance the wheel by one millisecond.
+		 * 
+		 */
+		static void
+		advance();
+
+		friend Timer;
+	};
+}
+
+#endif  // OSSHS_TIMER_WHEEL_HPP
@@ -0,0 +1,120 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2019 Linas Nikiperavicius
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef OSSHS_TRACE_RECORDER_HPP
+#define OSSHS_TRACE_RECORDER_HPP
+
+#ifdef ENABLE_TRACE
+	#include <cstdint>
+
+	#include <osshs/events/event.hpp>
+	#include <osshs/events/diagnostics_event.hpp>
+
+	#ifndef TRACE_BUFFER_SIZE
+		#define TRACE_BUFFER_SIZE 128
+	#endif  // TRACE_BUFFER_SIZE
+
+	#define OSSHS_TRACE(stage, event) do { osshs::TraceRecorder::record(osshs::events::DiagnosticsTraceStage::stage, (event).get()); } while (0)
+
+	namespace osshs
+	{
+		class TraceRecorder
+		{
+		public:
+			static constexpr uint16_t SIZE = TRACE_BUFFER_SIZE;
+			static constexpr uint32_t READOUT_TIMEOUT = 2000;
+
+			/**
+			 * @brief Record that an event reached a stage of its lifecycle.
+			 * When the buffer is full, the oldest record is overwritten.
+			 * 
+			 * @param stage lifecycle stage.
+			 * @param event event that reached the stage, ignored if nullptr.
+			 */
+			static void
+			record(events::DiagnosticsTraceStage stage, const events::Event *event);
+
+			/**
+			 * @brief Stop recording, so the buffer can be read out consistently.
+			 * 
+			 * @param timeout milliseconds after which recording resumes by itself, e.g. when
+			 * a paged read out is abandoned, 0 to pause until resume().
+			 */
+			static void
+			pause(uint32_t timeout = 0);
+
+			/**
+			 * @brief Continue recording.
+			 * 
+			 */
+			static void
+			resume();
+
+			/**
+			 * @brief Record count getter.
+			 * 
+			 * @return uint16_t number of records in the buffer.
+			 */
+			static uint16_t
+			getRecordCount();
+
+			/**
+			 * @brief Record getter.
+			 * 
+			 * @param index record index, 0 is the oldest record.
+			 * @return events::DiagnosticsTraceRecord record or an empty record if index is out of bounds.
+			 */
+			static events::DiagnosticsTraceRecord
+			getRecord(uint16_t index);
+
+			/**
+			 * @brief Start writing all records to the log. The records are written from update(),
+			 * recording stops until the last one is written. The output is understood by tools/trace_report.py.
+			 * 
+			 */
+			static void
+			dump();
+
+			/**
+			 * @brief Write dumped records while the log buffer is at least half empty. Called from the main loop.
+			 * 
+			 */
+			static void
+			update();
+		private:
+			static events::DiagnosticsTraceRecord records[SIZE];
+			static uint16_t head;
+			static uint16_t recordCount;
+			static bool paused;
+			static uint32_t pauseStart;
+			static uint32_t pauseTimeout;
+			static bool dumping;
+			static uint16_t dumpIndex;
+		};
+	}
+#else  // ENABLE_TRACE
+	#define OSSHS_TRACE(stage, event) do { } while (0)
+#endif  // ENABLE_TRACE
+
+#endif  // OSSHS_TRACE_RECORDER_HPP
@@ -0,0 +1,115 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2019 Linas Nikiperavicius
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef OSSHS_SEGMENTED_CAN_INTERFACE_HPP
+#define OSSHS_SEGMENTED_CAN_INTERFACE_HPP
+
+#include <cstdint>
+#include <memory>
+
+#include <osshs/protocol/interfaces/interface.hpp>
+#include <osshs/transport/segmented_transport.hpp>
+
+#ifndef TRANSPORT_PENDING_EVENTS
+	#define TRANSPORT_PENDING_EVENTS 8
+#endif  // TRANSPORT_PENDING_EVENTS
+
+namespace osshs
+{
+	namespace transport
+	{
+		/**
+		 * @brief CAN interface sending events through SegmentedTransport.
+		 * 
+		 * Events are sent with can::makeIdentifier, so their priority decides both the
+		 * transport's transmit queue and bus arbitration. Events the transport cannot
+		 * start yet wait in a queue of PENDING_EVENTS serialized events and are retried
+		 * from run(), in order within each priority level.
+		 * 
+		 * @tparam Can modm CAN driver.
+		 */
+		template<typename Can>
+		class SegmentedCanInterface : public protocol::interfaces::Interface
+		{
+		public:
+			static constexpr uint8_t PENDING_EVENTS = TRANSPORT_PENDING_EVENTS;
+
+			/**
+			 * @brief Construct interface.
+			 * 
+			 * @param blockSize consecutive frames a sender may send before waiting for flow control, 0 for no limit.
+			 * @param separationTime minimum gap between consecutive frames requested from senders.
+			 */
+			SegmentedCanInterface(uint8_t blockSize = 8, uint8_t separationTime = 0);
+
+			/**
+			 * @brief Receive frames, advance transfers and retry pending events.
+			 * 
+			 */
+			void
+			run() override;
+
+			/**
+			 * @brief Serialize an event and start sending it.
+			 * 
+			 * @param event event to send.
+			 */
+			void
+			reportEvent(std::shared_ptr<events::Event> event) override;
+		private:
+			struct PendingEvent
+			{
+				uint32_t identifier = 0;
+				std::unique_ptr<const uint8_t[]> data;
+				uint16_t length = 0;
+			};
+
+			SegmentedTransport<Can> transport;
+			PendingEvent pendingEvents[PENDING_EVENTS];
+			uint8_t pendingLength;
+
+			/**
+			 * @brief Hand pending events to the transport. An event the transport refuses
+			 * holds back the later events of its priority level.
+			 * 
+			 */
+			void
+			sendPendingEvents();
+
+			/**
+			 * @brief Make an event from a completely received transfer and report it.
+			 * 
+			 * @param identifier CAN identifier the event was received with.
+			 * @param data serialized event, valid until the call returns.
+			 * @param length data length.
+			 */
+			void
+			handleReceive(uint32_t identifier, const uint8_t *data, uint16_t length);
+		};
+	}
+}
+
+#include <osshs/transport/segmented_can_interface_impl.hpp>
+
+#endif  // OSSHS_SEGMENTED_CAN_INTERFACE_HPP
@@ -0,0 +1,159 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2019 Linas Nikiperavicius
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef OSSHS_SEGMENTED_CAN_INTERFACE_HPP
+	#error "Don't include this file directly, use 'segmented_can_interface.hpp' instead!"
+#endif
+
+#include <algorithm>
+
+#include <osshs/system.hpp>
+#include <osshs/can/can_identifier.hpp>
+#include <osshs/events/event_factory.hpp>
+#include <osshs/log/logger.hpp>
+
+namespace osshs
+{
+	namespace transport
+	{
+		template<typename Can>
+		SegmentedCanInterface<Can>::SegmentedCanInterface(uint8_t blockSize, uint8_t separationTime)
+			: transport(blockSize, separationTime), pendingLength(0)
+		{
+			transport.setReceiveHandler(
+				[this](uint32_t identifier, const uint8_t *data, uint16_t length) -> void
+				{
+					handleReceive(identifier, data, length);
+				}
+			);
+
+			transport.setAddressFilter(
+				[](uint8_t destination) -> bool
+				{
+					return System::isAddressed(destination);
+				}
+			);
+		}
+
+		template<typename Can>
+		void
+		SegmentedCanInterface<Can>::run()
+		{
+			modm::can::Message message;
+
+			while (Can::isMessageAvailable() && Can::getMessage(message))
+				transport.handleFrame(message);
+
+			transport.update();
+			sendPendingEvents();
+		}
+
+		template<typename Can>
+		void
+		SegmentedCanInterface<Can>::reportEvent(std::shared_ptr<events::Event> event)
+		{
+			if (pendingLength >= PENDING_EVENTS)
+			{
+				OSSHS_LOG_WARNING("Dropping event, transmit queue is full(type = 0x%04x).", event->getType());
+				return;
+			}
+
+			std::unique_ptr<const uint8_t[]> data = event->serialize();
+
+			if (data == nullptr)
+			{
+				OSSHS_LOG_ERROR("Failed to serialize event(type = 0x%04x).", event->getType());
+				return;
+			}
+
+			uint16_t length = data[0] | (data[1] << 8);
+
+			if (length > SegmentedTransport<Can>::MAX_LENGTH)
+			{
+				OSSHS_LOG_WARNING("Dropping event longer than the transport allows(type = 0x%04x, length = %u).", event->getType(), length);
+				return;
+			}
+
+			PendingEvent &pending = pendingEvents[pendingLength++];
+			pending.identifier = can::makeIdentifier(*event);
+			pending.data = std::move(data);
+			pending.length = length;
+
+			sendPendingEvents();
+		}
+
+		template<typename Can>
+		void
+		SegmentedCanInterface<Can>::sendPendingEvents()
+		{
+			bool blocked[events::EVENT_PRIORITY_LEVELS] = {};
+			uint8_t kept = 0;
+
+			for (uint8_t i = 0; i < pendingLength; i++)
+			{
+				PendingEvent &pending = pendingEvents[i];
+				uint8_t level = std::min<uint8_t>(can::getPriorityLevel(pending.identifier), events::EVENT_PRIORITY_LEVELS - 1);
+
+				if (!blocked[level] && transport.send(pending.identifier, pending.data, pending.length))
+					continue;
+
+				blocked[level] = true;
+
+				if (kept != i)
+					pendingEvents[kept] = std::move(pending);
+
+				kept++;
+			}
+
+			pendingLength = kept;
+		}
+
+		template<typename Can>
+		void
+		SegmentedCanInterface<Can>::handleReceive(uint32_t identifier, const uint8_t *data, uint16_t length)
+		{
+			if (length < events::Event::HEADER_LENGTH || (data[0] | (data[1] << 8)) != length)
+			{
+				OSSHS_LOG_WARNING("Dropping malformed event(identifier = 0x%08lx, length = %u).", identifier, length);
+				return;
+			}
+
+			// EventFactory takes ownership of the serialized event, the transport buffer goes back to the pool.
+			uint8_t *buffer = new (std::nothrow) uint8_t[length];
+
+			if (buffer == nullptr)
+			{
+				OSSHS_LOG_ERROR("Failed to allocate memory for a buffer(bufferLength = %u).", length);
+				return;
+			}
+
+			std::copy(data, data + length, buffer);
+
+			std::shared_ptr<events::Event> event = events::EventFactory::make(data[2] | (data[3] << 8), std::unique_ptr<const uint8_t[]>(buffer));
+
+			if (event != nullptr)
+				System::reportEvent(event);
+		}
+	}
+}
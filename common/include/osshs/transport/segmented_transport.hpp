@@ -0,0 +1,301 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2019 Linas Nikiperavicius
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef OSSHS_SEGMENTED_TRANSPORT_HPP
+#define OSSHS_SEGMENTED_TRANSPORT_HPP
+
+#include <cstdint>
+#include <memory>
+
+#include <modm/architecture/interface/can_message.hpp>
+#include <osshs/delegate.hpp>
+#include <osshs/timer.hpp>
+#include <osshs/events/event.hpp>
+
+#ifndef TRANSPORT_MAX_SESSIONS
+	#define TRANSPORT_MAX_SESSIONS 4
+#endif  // TRANSPORT_MAX_SESSIONS
+
+#ifndef TRANSPORT_TX_QUEUE_SIZE
+	#define TRANSPORT_TX_QUEUE_SIZE 4
+#endif  // TRANSPORT_TX_QUEUE_SIZE
+
+// Fits a FirmwareBlockEvent with the default block size of 256 bytes.
+#ifndef TRANSPORT_BUFFER_SIZE
+	#define TRANSPORT_BUFFER_SIZE 288
+#endif  // TRANSPORT_BUFFER_SIZE
+
+namespace osshs
+{
+	namespace transport
+	{
+		/**
+		 * @brief Receive handler.
+		 * 
+		 * @param identifier CAN identifier the event was received with.
+		 * @param data reassembled serialized event, valid until the handler returns.
+		 * @param length data length.
+		 */
+		typedef Delegate<void (uint32_t identifier, const uint8_t *data, uint16_t length)> ReceiveHandler;
+
+		/**
+		 * @brief Address filter.
+		 * 
+		 * @param destination destination address of a transfer.
+		 * @return true transfer is addressed to this node and should be received.
+		 */
+		typedef Delegate<bool (uint8_t destination)> AddressFilter;
+
+		/**
+		 * @brief ISO-TP style segmentation of serialized events into CAN frames.
+		 * 
+		 * Frame formats (first byte is the protocol control information):
+		 *   single      [0x0, length][data 0..6]
+		 *   first       [0x1, length 11..8][length 7..0][tag][destination][data 0..3]
+		 *   consecutive [0x2, sequence][tag][data 0..5]
+		 *   flow control[0x3, status][tag][block size][separation time]
+		 * 
+		 * The tag is the low byte of the event cause id, so transfers with the same CAN
+		 * identifier run concurrently. A transfer is keyed by its identifier, which carries
+		 * the source node (see can::makeIdentifier), and its tag. Separation time uses the
+		 * ISO-TP encoding: 0x00 - 0x7f milliseconds, 0xf1 - 0xf9 100 - 900 microseconds.
+		 * 
+		 * The first frame carries the event's destination address, so nodes the address
+		 * filter rejects ignore the transfer without answering. Only a transfer to a single
+		 * node is flow controlled, by that node alone, with the data identifier and
+		 * can::FLOW_CONTROL_FLAG set. A sender runs one such transfer per identifier at a
+		 * time, so two nodes never send flow control with the same identifier. Group and
+		 * broadcast transfers are sent without flow control, in one block with this
+		 * transport's own separation time; a receiver without a free session misses them.
+		 * 
+		 * Outgoing frames wait in one transmit queue per priority level (see
+		 * can::getPriorityLevel) and are handed to the driver most urgent first,
+		 * so a bulk transfer can never hold back a control event by more than the
+		 * frames already in the driver. The driver's own transmit buffer must be disabled
+		 * (modm:platform:can:buffer.tx = 0), so only the hardware mailboxes hold frames.
+		 * 
+		 * Transfers are reassembled into a fixed pool of MAX_SESSIONS buffers of
+		 * BUFFER_SIZE bytes, longer transfers are refused with an overflow. Nothing
+		 * is allocated per transfer.
+		 * 
+		 * @tparam Can modm CAN driver.
+		 */
+		template<typename Can>
+		class SegmentedTransport
+		{
+		public:
+			static constexpr uint8_t MAX_SESSIONS = TRANSPORT_MAX_SESSIONS;
+			static constexpr uint8_t TX_QUEUE_SIZE = TRANSPORT_TX_QUEUE_SIZE;
+			static constexpr uint16_t BUFFER_SIZE = TRANSPORT_BUFFER_SIZE;
+			static constexpr uint16_t MAX_LENGTH = 0xfff;
+			static constexpr uint32_t TIMEOUT = 1000;
+
+			/**
+			 * @brief Construct transport.
+			 * 
+			 * @param blockSize consecutive frames a sender may send before waiting for flow control, 0 for no limit.
+			 * @param separationTime minimum gap between consecutive frames requested from senders.
+			 */
+			SegmentedTransport(uint8_t blockSize = 8, uint8_t separationTime = 0);
+
+			/**
+			 * @brief Receive handler setter.
+			 * 
+			 * @param handler handler to call with every completely received event.
+			 */
+			void
+			setReceiveHandler(ReceiveHandler handler);
+
+			/**
+			 * @brief Address filter setter. Without a filter every transfer is received and
+			 * flow controlled, as on a bus of two nodes.
+			 * 
+			 * @param filter filter to decide from a transfer's destination whether it is received.
+			 */
+			void
+			setAddressFilter(AddressFilter filter);
+
+			/**
+			 * @brief Start sending a serialized event. Events that fit a single frame are sent
+			 * immediately, larger events are sent from update().
+			 * 
+			 * @param identifier CAN identifier.
+			 * @param data serialized event, taken over by the transport when the transfer was started
+			 * and left with the caller otherwise, so the send can be retried.
+			 * @param length data length.
+			 * @return true transfer was started.
+			 * @return false event is too long, the transmit queue of its priority is full, all sessions are
+			 * in use or a flow controlled transfer with the same identifier is in progress.
+			 */
+			bool
+			send(uint32_t identifier, std::unique_ptr<const uint8_t[]> &data, uint16_t length);
+
+			/**
+			 * @brief Handle a received frame.
+			 * 
+			 * @param message received CAN frame.
+			 */
+			void
+			handleFrame(const modm::can::Message &message);
+
+			/**
+			 * @brief Send pending frames and expire stalled transfers. Called from the interface's run().
+			 * 
+			 */
+			void
+			update();
+		private:
+			enum class
+			FrameType : uint8_t
+			{
+				SINGLE = 0x00,
+				FIRST = 0x10,
+				CONSECUTIVE = 0x20,
+				FLOW_CONTROL = 0x30
+			};
+
+			enum class
+			FlowStatus : uint8_t
+			{
+				CONTINUE = 0x00,
+				WAIT = 0x01,
+				OVERFLOW = 0x02
+			};
+
+			enum class
+			State : uint8_t
+			{
+				IDLE,
+				SEND_FIRST,
+				WAIT_FLOW_CONTROL,
+				SEND_CONSECUTIVE,
+				RECEIVE
+			};
+
+			struct Session
+			{
+				State state = State::IDLE;
+				uint32_t identifier = 0;
+				uint8_t tag = 0;
+				uint16_t length = 0;
+				uint16_t offset = 0;
+				uint8_t sequence = 0;
+				uint8_t blockCounter = 0;
+				uint8_t blockSize = 0;
+				uint32_t separationTime = 0;
+				uint32_t lastFrameTime = 0;
+				bool flowControl = false;
+				bool flowControlPending = false;
+				FlowStatus flowStatus = FlowStatus::CONTINUE;
+				std::unique_ptr<const uint8_t[]> transmitData;
+				Timer timer;
+			};
+
+			struct TransmitQueue
+			{
+				modm::can::Message frames[TX_QUEUE_SIZE];
+				uint8_t head = 0;
+				uint8_t length = 0;
+			};
+
+			uint8_t blockSize;
+			uint8_t separationTime;
+			ReceiveHandler receiveHandler;
+			AddressFilter addressFilter;
+			TransmitQueue transmitQueues[events::EVENT_PRIORITY_LEVELS];
+			Session transmitSessions[MAX_SESSIONS];
+			Session receiveSessions[MAX_SESSIONS];
+			uint8_t receiveBuffers[MAX_SESSIONS][BUFFER_SIZE];
+
+			Session *
+			findSession(Session *sessions, uint32_t identifier, uint8_t tag);
+
+			Session *
+			findFreeSession(Session *sessions);
+
+			void
+			releaseSession(Session &session);
+
+			/**
+			 * @brief Get the reassembly buffer of a receive session.
+			 * 
+			 * @param session receive session.
+			 * @return uint8_t* BUFFER_SIZE bytes owned by the session.
+			 */
+			uint8_t *
+			getReceiveBuffer(const Session &session);
+
+			void
+			handleFirstFrame(const modm::can::Message &message);
+
+			void
+			handleConsecutiveFrame(const modm::can::Message &message);
+
+			void
+			handleFlowControlFrame(const modm::can::Message &message);
+
+			void
+			updateTransmitSession(Session &session);
+
+			void
+			updateReceiveSession(Session &session);
+
+			bool
+			sendFlowControl(uint32_t identifier, uint8_t tag, FlowStatus status);
+
+			/**
+			 * @brief Get the transmit queue of an identifier's priority level.
+			 * 
+			 * @param identifier CAN identifier.
+			 * @return TransmitQueue& transmit queue, the least urgent one for unknown levels.
+			 */
+			TransmitQueue &
+			getTransmitQueue(uint32_t identifier);
+
+			/**
+			 * @brief Queue a frame for transmission.
+			 * 
+			 * @param message frame to send.
+			 * @return true frame was queued.
+			 * @return false transmit queue of the frame's priority is full.
+			 */
+			bool
+			queueFrame(const modm::can::Message &message);
+
+			/**
+			 * @brief Hand queued frames to the driver, most urgent first, while it accepts them.
+			 * 
+			 */
+			void
+			flushFrames();
+
+			static uint32_t
+			decodeSeparationTime(uint8_t separationTime);
+		};
+	}
+}
+
+#include <osshs/transport/segmented_transport_impl.hpp>
+
+#endif  // OSSHS_SEGMENTED_TRANSPORT_HPP
@@ -0,0 +1,540 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2019 Linas Nikiperavicius
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef OSSHS_SEGMENTED_TRANSPORT_HPP
+	#error "Don't include this file directly, use 'segmented_transport.hpp' instead!"
+#endif
+
+#include <algorithm>
+
+#include <osshs/can/can_identifier.hpp>
+#include <osshs/time.hpp>
+#include <osshs/log/logger.hpp>
+
+namespace osshs
+{
+	namespace transport
+	{
+		template<typename Can>
+		SegmentedTransport<Can>::SegmentedTransport(uint8_t blockSize, uint8_t separationTime)
+			: blockSize(blockSize), separationTime(separationTime)
+		{
+		}
+
+		template<typename Can>
+		void
+		SegmentedTransport<Can>::setReceiveHandler(ReceiveHandler handler)
+		{
+			receiveHandler = handler;
+		}
+
+		template<typename Can>
+		void
+		SegmentedTransport<Can>::setAddressFilter(AddressFilter filter)
+		{
+			addressFilter = filter;
+		}
+
+		template<typename Can>
+		bool
+		SegmentedTransport<Can>::send(uint32_t identifier, std::unique_ptr<const uint8_t[]> &data, uint16_t length)
+		{
+			if (data == nullptr || length == 0 || length > MAX_LENGTH)
+				return false;
+
+			if (length <= 7)
+			{
+				if (getTransmitQueue(identifier).length >= TX_QUEUE_SIZE)
+					return false;
+
+				modm::can::Message message(identifier, length + 1);
+				message.setExtended(true);
+				message.data[0] = static_cast<uint8_t>(FrameType::SINGLE) | length;
+				std::copy(&data[0], &data[length], &message.data[1]);
+				data.reset();
+
+				queueFrame(message);
+				flushFrames();
+
+				return true;
+			}
+
+			// The tag is the low byte of the cause id in the event header.
+			uint8_t tag = data[4];
+			uint8_t destination = data[6];
+			bool flowControl = !(destination & events::Event::ADDRESS_GROUP_FLAG);
+
+			if (findSession(transmitSessions, identifier, tag) != nullptr)
+			{
+				OSSHS_LOG_WARNING("Transfer already in progress(identifier = 0x%08lx, tag = 0x%02x).", identifier, tag);
+				return false;
+			}
+
+			// Flow control of a second transfer would come from another node with the same identifier.
+			if (flowControl)
+				for (const Session &other : transmitSessions)
+					if (other.state != State::IDLE && other.identifier == identifier && other.flowControl)
+						return false;
+
+			Session *session = findFreeSession(transmitSessions);
+
+			if (session == nullptr)
+				return false;
+
+			session->state = State::SEND_FIRST;
+			session->identifier = identifier;
+			session->tag = tag;
+			session->length = length;
+			session->offset = 0;
+			session->flowControl = flowControl;
+			session->transmitData = std::move(data);
+
+			updateTransmitSession(*session);
+			flushFrames();
+
+			return true;
+		}
+
+		template<typename Can>
+		void
+		SegmentedTransport<Can>::handleFrame(const modm::can::Message &message)
+		{
+			if (message.getLength() == 0)
+				return;
+
+			FrameType type = static_cast<FrameType>(message.data[0] & 0xf0);
+
+			if (type == FrameType::SINGLE)
+			{
+				uint8_t length = message.data[0] & 0x0f;
+
+				if (length == 0 || length + 1 > message.getLength())
+					return;
+
+				if (receiveHandler != nullptr)
+					receiveHandler(message.getIdentifier(), &message.data[1], length);
+			}
+			else if (type == FrameType::FIRST)
+			{
+				handleFirstFrame(message);
+			}
+			else if (type == FrameType::CONSECUTIVE)
+			{
+				handleConsecutiveFrame(message);
+			}
+			else if (type == FrameType::FLOW_CONTROL)
+			{
+				handleFlowControlFrame(message);
+			}
+
+			flushFrames();
+		}
+
+		template<typename Can>
+		void
+		SegmentedTransport<Can>::update()
+		{
+			// Flow control goes first, as it unblocks the remote sender.
+			for (Session &session : receiveSessions)
+				if (session.state != State::IDLE)
+					updateReceiveSession(session);
+
+			// Urgent transfers take the free queue slots before bulk ones.
+			for (uint8_t level = 0; level < events::EVENT_PRIORITY_LEVELS; level++)
+				for (Session &session : transmitSessions)
+					if (session.state != State::IDLE && &getTransmitQueue(session.identifier) == &transmitQueues[level])
+						updateTransmitSession(session);
+
+			flushFrames();
+		}
+
+		template<typename Can>
+		typename SegmentedTransport<Can>::Session *
+		SegmentedTransport<Can>::findSession(Session *sessions, uint32_t identifier, uint8_t tag)
+		{
+			for (uint8_t i = 0; i < MAX_SESSIONS; i++)
+				if (sessions[i].state != State::IDLE && sessions[i].identifier == identifier && sessions[i].tag == tag)
+					return &sessions[i];
+
+			return nullptr;
+		}
+
+		template<typename Can>
+		typename SegmentedTransport<Can>::Session *
+		SegmentedTransport<Can>::findFreeSession(Session *sessions)
+		{
+			for (uint8_t i = 0; i < MAX_SESSIONS; i++)
+				if (sessions[i].state == State::IDLE)
+					return &sessions[i];
+
+			return nullptr;
+		}
+
+		template<typename Can>
+		void
+		SegmentedTransport<Can>::releaseSession(Session &session)
+		{
+			session.state = State::IDLE;
+			session.flowControl = false;
+			session.flowControlPending = false;
+			session.transmitData.reset();
+			session.timer.stop();
+		}
+
+		template<typename Can>
+		uint8_t *
+		SegmentedTransport<Can>::getReceiveBuffer(const Session &session)
+		{
+			return receiveBuffers[&session - receiveSessions];
+		}
+
+		template<typename Can>
+		void
+		SegmentedTransport<Can>::handleFirstFrame(const modm::can::Message &message)
+		{
+			if (message.getLength() < 8)
+				return;
+
+			uint32_t identifier = message.getIdentifier();
+			uint16_t length = ((message.data[0] & 0x0f) << 8) | message.data[1];
+			uint8_t tag = message.data[2];
+			uint8_t destination = message.data[3];
+			bool flowControl = !(destination & events::Event::ADDRESS_GROUP_FLAG);
+
+			if (length <= 7)
+				return;
+
+			// Bystanders stay silent, only the addressed node may answer with flow control.
+			if (addressFilter != nullptr && !addressFilter(destination))
+				return;
+
+			if (length > BUFFER_SIZE)
+			{
+				OSSHS_LOG_WARNING("Refusing transfer longer than the transport buffer(identifier = 0x%08lx, tag = 0x%02x, length = %u).", identifier, tag, length);
+
+				if (flowControl)
+					sendFlowControl(identifier, tag, FlowStatus::OVERFLOW);
+
+				return;
+			}
+
+			Session *session = findSession(receiveSessions, identifier, tag);
+
+			if (session != nullptr)
+			{
+				OSSHS_LOG_WARNING("Restarting transfer(identifier = 0x%08lx, tag = 0x%02x).", identifier, tag);
+				releaseSession(*session);
+			}
+			else
+			{
+				session = findFreeSession(receiveSessions);
+			}
+
+			if (session == nullptr)
+			{
+				OSSHS_LOG_WARNING("No free transport session(identifier = 0x%08lx, tag = 0x%02x).", identifier, tag);
+
+				if (flowControl)
+					sendFlowControl(identifier, tag, FlowStatus::OVERFLOW);
+
+				return;
+			}
+
+			// The event is reassembled in place and handed to the receive handler from the pool.
+			std::copy(&message.data[4], &message.data[8], getReceiveBuffer(*session));
+
+			session->state = State::RECEIVE;
+			session->identifier = identifier;
+			session->tag = tag;
+			session->length = length;
+			session->offset = 4;
+			session->sequence = 1;
+			session->blockCounter = 0;
+			session->flowControl = flowControl;
+			session->flowControlPending = flowControl;
+			session->flowStatus = FlowStatus::CONTINUE;
+			session->timer.start(TIMEOUT);
+
+			updateReceiveSession(*session);
+		}
+
+		template<typename Can>
+		void
+		SegmentedTransport<Can>::handleConsecutiveFrame(const modm::can::Message &message)
+		{
+			if (message.getLength() < 3)
+				return;
+
+			Session *session = findSession(receiveSessions, message.getIdentifier(), message.data[1]);
+
+			if (session == nullptr)
+				return;
+
+			if ((message.data[0] & 0x0f) != session->sequence)
+			{
+				OSSHS_LOG_WARNING("Aborting transfer, unexpected sequence number(identifier = 0x%08lx, tag = 0x%02x).", session->identifier, session->tag);
+				releaseSession(*session);
+				return;
+			}
+
+			uint16_t length = std::min<uint16_t>(message.getLength() - 2, session->length - session->offset);
+
+			std::copy(&message.data[2], &message.data[2 + length], &getReceiveBuffer(*session)[session->offset]);
+
+			session->offset += length;
+			session->sequence = (session->sequence + 1) & 0x0f;
+
+			if (session->offset >= session->length)
+			{
+				// The session is released afterwards, so its buffer is not reused while the handler runs.
+				if (receiveHandler != nullptr)
+					receiveHandler(session->identifier, getReceiveBuffer(*session), session->length);
+
+				releaseSession(*session);
+				return;
+			}
+
+			if (session->flowControl && blockSize != 0 && ++session->blockCounter >= blockSize)
+			{
+				session->blockCounter = 0;
+				session->flowControlPending = true;
+				session->flowStatus = FlowStatus::CONTINUE;
+			}
+
+			session->timer.start(TIMEOUT);
+			updateReceiveSession(*session);
+		}
+
+		template<typename Can>
+		void
+		SegmentedTransport<Can>::handleFlowControlFrame(const modm::can::Message &message)
+		{
+			if (message.getLength() < 4)
+				return;
+
+			Session *session = findSession(transmitSessions, message.getIdentifier() & ~can::FLOW_CONTROL_FLAG, message.data[1]);
+
+			if (session == nullptr || session->state != State::WAIT_FLOW_CONTROL)
+				return;
+
+			FlowStatus status = static_cast<FlowStatus>(message.data[0] & 0x0f);
+
+			if (status == FlowStatus::CONTINUE)
+			{
+				session->state = State::SEND_CONSECUTIVE;
+				session->blockSize = message.data[2];
+				session->blockCounter = 0;
+				session->separationTime = decodeSeparationTime(message.data[3]);
+				session->timer.stop();
+
+				updateTransmitSession(*session);
+			}
+			else if (status == FlowStatus::WAIT)
+			{
+				session->timer.start(TIMEOUT);
+			}
+			else
+			{
+				OSSHS_LOG_WARNING("Transfer rejected by receiver(identifier = 0x%08lx, tag = 0x%02x).", session->identifier, session->tag);
+				releaseSession(*session);
+			}
+		}
+
+		template<typename Can>
+		void
+		SegmentedTransport<Can>::updateTransmitSession(Session &session)
+		{
+			if (session.state == State::SEND_FIRST)
+			{
+				if (getTransmitQueue(session.identifier).length >= TX_QUEUE_SIZE)
+					return;
+
+				modm::can::Message message(session.identifier, 8);
+				message.setExtended(true);
+				message.data[0] = static_cast<uint8_t>(FrameType::FIRST) | (session.length >> 8);
+				message.data[1] = session.length & 0xff;
+				message.data[2] = session.tag;
+				message.data[3] = session.transmitData[6];
+				std::copy(&session.transmitData[0], &session.transmitData[4], &message.data[4]);
+
+				if (!queueFrame(message))
+					return;
+
+				session.offset = 4;
+				session.sequence = 1;
+
+				if (session.flowControl)
+				{
+					session.state = State::WAIT_FLOW_CONTROL;
+					session.timer.start(TIMEOUT);
+				}
+				else
+				{
+					session.state = State::SEND_CONSECUTIVE;
+					session.blockSize = 0;
+					session.blockCounter = 0;
+					session.separationTime = decodeSeparationTime(separationTime);
+				}
+			}
+			else if (session.state == State::WAIT_FLOW_CONTROL)
+			{
+				if (session.timer.isExpired())
+				{
+					OSSHS_LOG_WARNING("Transfer timed out waiting for flow control(identifier = 0x%08lx, tag = 0x%02x).", session.identifier, session.tag);
+					releaseSession(session);
+				}
+			}
+			else if (session.state == State::SEND_CONSECUTIVE)
+			{
+				TransmitQueue &queue = getTransmitQueue(session.identifier);
+
+				while (queue.length < TX_QUEUE_SIZE)
+				{
+					uint32_t now = Time::getSystemTime<uint32_t, Time::Precision::Microseconds>();
+
+					// With a separation time, frames are queued one at a time and flushed right away.
+					if (session.separationTime != 0 && (queue.length != 0 || now - session.lastFrameTime < session.separationTime))
+						return;
+
+					uint16_t length = std::min<uint16_t>(6, session.length - session.offset);
+
+					modm::can::Message message(session.identifier, length + 2);
+					message.setExtended(true);
+					message.data[0] = static_cast<uint8_t>(FrameType::CONSECUTIVE) | session.sequence;
+					message.data[1] = session.tag;
+					std::copy(&session.transmitData[session.offset], &session.transmitData[session.offset + length], &message.data[2]);
+
+					if (!queueFrame(message))
+						return;
+
+					if (session.separationTime != 0)
+						flushFrames();
+
+					session.offset += length;
+					session.sequence = (session.sequence + 1) & 0x0f;
+					session.lastFrameTime = now;
+
+					if (session.offset >= session.length)
+					{
+						releaseSession(session);
+						return;
+					}
+
+					if (session.blockSize != 0 && ++session.blockCounter >= session.blockSize)
+					{
+						session.state = State::WAIT_FLOW_CONTROL;
+						session.timer.start(TIMEOUT);
+						return;
+					}
+				}
+			}
+		}
+
+		template<typename Can>
+		void
+		SegmentedTransport<Can>::updateReceiveSession(Session &session)
+		{
+			if (session.flowControlPending && sendFlowControl(session.identifier, session.tag, session.flowStatus))
+			{
+				session.flowControlPending = false;
+				session.timer.start(TIMEOUT);
+			}
+
+			if (session.timer.isExpired())
+			{
+				OSSHS_LOG_WARNING("Transfer timed out waiting for consecutive frame(identifier = 0x%08lx, tag = 0x%02x).", session.identifier, session.tag);
+				releaseSession(session);
+			}
+		}
+
+		template<typename Can>
+		bool
+		SegmentedTransport<Can>::sendFlowControl(uint32_t identifier, uint8_t tag, FlowStatus status)
+		{
+			modm::can::Message message(identifier | can::FLOW_CONTROL_FLAG, 4);
+			message.setExtended(true);
+			message.data[0] = static_cast<uint8_t>(FrameType::FLOW_CONTROL) | static_cast<uint8_t>(status);
+			message.data[1] = tag;
+			message.data[2] = blockSize;
+			message.data[3] = separationTime;
+
+			return queueFrame(message);
+		}
+
+		template<typename Can>
+		typename SegmentedTransport<Can>::TransmitQueue &
+		SegmentedTransport<Can>::getTransmitQueue(uint32_t identifier)
+		{
+			uint8_t level = can::getPriorityLevel(identifier);
+
+			return transmitQueues[(level < events::EVENT_PRIORITY_LEVELS) ? level : events::EVENT_PRIORITY_LEVELS - 1];
+		}
+
+		template<typename Can>
+		bool
+		SegmentedTransport<Can>::queueFrame(const modm::can::Message &message)
+		{
+			TransmitQueue &queue = getTransmitQueue(message.getIdentifier());
+
+			if (queue.length >= TX_QUEUE_SIZE)
+				return false;
+
+			queue.frames[(queue.head + queue.length) % TX_QUEUE_SIZE] = message;
+			queue.length++;
+
+			return true;
+		}
+
+		template<typename Can>
+		void
+		SegmentedTransport<Can>::flushFrames()
+		{
+			for (TransmitQueue &queue : transmitQueues)
+			{
+				while (queue.length > 0)
+				{
+					if (!Can::isReadyToSend() || !Can::sendMessage(queue.frames[queue.head]))
+						return;
+
+					queue.head = (queue.head + 1) % TX_QUEUE_SIZE;
+					queue.length--;
+				}
+			}
+		}
+
+		template<typename Can>
+		uint32_t
+		SegmentedTransport<Can>::decodeSeparationTime(uint8_t separationTime)
+		{
+			if (separationTime <= 0x7f)
+				return separationTime * 1000;
+
+			if (separationTime >= 0xf1 && separationTime <= 0xf9)
+				return (separationTime - 0xf0) * 100;
+
+			// Reserved values are treated as the maximum.
+			return 0x7f * 1000;
+		}
+	}
+}
@@ -0,0 +1,294 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2019 Linas Nikiperavicius
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <osshs/benchmark.hpp>
+
+#ifdef ENABLE_BENCHMARK
+	#include <algorithm>
+
+	#include <osshs/system.hpp>
+	#include <osshs/time.hpp>
+	#include <osshs/can/can_identifier.hpp>
+	#include <osshs/events/event_factory.hpp>
+	#include <osshs/events/system_event.hpp>
+	#include <osshs/log/logger.hpp>
+	#include <osshs/transport/segmented_transport.hpp>
+
+	#ifndef BENCHMARK_TRANSFER_LENGTH
+		#define BENCHMARK_TRANSFER_LENGTH 256
+	#endif  // BENCHMARK_TRANSFER_LENGTH
+
+	namespace osshs
+	{
+		/**
+		 * @brief Bus without a controller. Frames queue in sending order;
+		 * nominal frame lengths are summed up to estimate the bus time.
+		 */
+		struct Benchmark::LoopbackCan
+		{
+			static constexpr uint8_t SIZE = 8;
+
+			static modm::can::Message frames[SIZE];
+			static uint8_t head;
+			static uint8_t length;
+			static uint32_t frameCount;
+			static uint32_t bitCount;
+
+			static bool
+			isReadyToSend()
+			{
+				return length < SIZE;
+			}
+
+			static bool
+			sendMessage(const modm::can::Message &message)
+			{
+				if (length >= SIZE)
+					return false;
+
+				frames[(head + length) % SIZE] = message;
+				length++;
+
+				// Extended data frame without stuffing bits: 67 bits of framing and the data.
+				frameCount++;
+				bitCount += 67 + 8 * message.getLength();
+
+				return true;
+			}
+
+			static bool
+			getMessage(modm::can::Message &message)
+			{
+				if (length == 0)
+					return false;
+
+				message = frames[head];
+				head = (head + 1) % SIZE;
+				length--;
+
+				return true;
+			}
+		};
+
+		modm::can::Message Benchmark::LoopbackCan::frames[SIZE];
+		uint8_t Benchmark::LoopbackCan::head = 0;
+		uint8_t Benchmark::LoopbackCan::length = 0;
+		uint32_t Benchmark::LoopbackCan::frameCount = 0;
+		uint32_t Benchmark::LoopbackCan::bitCount = 0;
+
+		void
+		Benchmark::run()
+		{
+			// Debug messages on the measured paths would be measured as well.
+			log::Level level = log::Logger::getLevel();
+
+			if (level > log::Level::INFO)
+				log::Logger::setLevel(log::Level::INFO);
+
+			runLocalDelivery();
+			runSegmentedTransport();
+
+			log::Logger::setLevel(level);
+		}
+
+		void
+		Benchmark::runLocalDelivery()
+		{
+			static uint32_t delivered = 0;
+
+			System::subscribeEvent(events::EventSelector(0xffff, events::SystemErrorEvent::TYPE),
+				[](std::shared_ptr<events::Event> event) -> void
+				{
+					delivered++;
+				}
+			);
+
+			uint32_t start = Time::getSystemTime<uint32_t, Time::Precision::Microseconds>();
+
+			for (uint16_t i = 0; i < ITERATIONS; i++)
+			{
+				std::shared_ptr<events::Event> event(new (std::nothrow) events::SystemErrorEvent(events::SystemError::UNSUPPORTED_EVENT));
+
+				if (event == nullptr)
+				{
+					OSSHS_LOG_ERROR("Failed to allocate memory for a system error event.");
+					return;
+				}
+
+				event->setDestination(System::getNodeId());
+				System::reportEvent(event);
+			}
+
+			uint32_t direct = getTimePerIteration(start);
+
+			start = Time::getSystemTime<uint32_t, Time::Precision::Microseconds>();
+
+			for (uint16_t i = 0; i < ITERATIONS; i++)
+			{
+				events::SystemErrorEvent event(events::SystemError::UNSUPPORTED_EVENT);
+				event.setDestination(System::getNodeId());
+
+				std::unique_ptr<const uint8_t[]> data = event.serialize();
+
+				if (data == nullptr)
+				{
+					OSSHS_LOG_ERROR("Failed to serialize a system error event.");
+					return;
+				}
+
+				std::shared_ptr<events::Event> received = events::EventFactory::make(events::SystemErrorEvent::TYPE, std::move(data));
+
+				if (received != nullptr)
+					System::reportEvent(received);
+			}
+
+			uint32_t serialized = getTimePerIteration(start);
+
+			OSSHS_LOG_INFO("Benchmark local delivery(events = %lu, direct = %lu ns, serialized = %lu ns).",
+				delivered, direct, serialized);
+		}
+
+		void
+		Benchmark::runSegmentedTransport()
+		{
+			// Bitrate the nodes initialize the CAN controller with.
+			static constexpr uint32_t BITRATE = 50000;
+			static constexpr uint16_t LENGTH = BENCHMARK_TRANSFER_LENGTH;
+			static constexpr uint8_t RECEIVER = 0x01;
+			static constexpr uint8_t BYSTANDER = 0x02;
+
+			static uint32_t received = 0;
+			static uint32_t overheard = 0;
+
+			// Static, the reassembly buffers are too large for the main stack.
+			static transport::SegmentedTransport<LoopbackCan> sender;
+			static transport::SegmentedTransport<LoopbackCan> receiver;
+			static transport::SegmentedTransport<LoopbackCan> bystander;
+
+			receiver.setReceiveHandler(
+				[](uint32_t identifier, const uint8_t *data, uint16_t length) -> void
+				{
+					received += length;
+				}
+			);
+
+			receiver.setAddressFilter(
+				[](uint8_t destination) -> bool
+				{
+					return destination == RECEIVER || (destination & events::Event::ADDRESS_GROUP_FLAG);
+				}
+			);
+
+			bystander.setReceiveHandler(
+				[](uint32_t identifier, const uint8_t *data, uint16_t length) -> void
+				{
+					overheard += length;
+				}
+			);
+
+			bystander.setAddressFilter(
+				[](uint8_t destination) -> bool
+				{
+					return destination == BYSTANDER || (destination & events::Event::ADDRESS_GROUP_FLAG);
+				}
+			);
+
+			// A transfer to the receiver must not be answered by the bystander, a broadcast by nobody.
+			for (uint8_t destination : {RECEIVER, events::Event::ADDRESS_BROADCAST})
+			{
+				uint32_t flowControlFrames = 0;
+
+				received = 0;
+				overheard = 0;
+				LoopbackCan::frameCount = 0;
+				LoopbackCan::bitCount = 0;
+
+				uint32_t start = Time::getSystemTime<uint32_t, Time::Precision::Microseconds>();
+
+				for (uint16_t i = 0; i < ITERATIONS; i++)
+				{
+					uint8_t *buffer = new (std::nothrow) uint8_t[LENGTH];
+
+					if (buffer == nullptr)
+					{
+						OSSHS_LOG_ERROR("Failed to allocate memory for a buffer(bufferLength = %u).", LENGTH);
+						return;
+					}
+
+					std::fill(buffer, buffer + LENGTH, i & 0xff);
+					buffer[6] = destination;
+
+					std::unique_ptr<const uint8_t[]> data(buffer);
+					uint32_t identifier = static_cast<uint32_t>(events::SystemErrorEvent::TYPE) << can::EVENT_TYPE_SHIFT;
+
+					if (!sender.send(identifier, data, LENGTH))
+					{
+						OSSHS_LOG_ERROR("Failed to start a benchmark transfer(iteration = %u).", i);
+						return;
+					}
+
+					// Flow control frames go back to the sender, data frames to the receiving nodes.
+					modm::can::Message message;
+
+					do
+					{
+						while (LoopbackCan::getMessage(message))
+						{
+							if (message.getIdentifier() & can::FLOW_CONTROL_FLAG)
+							{
+								flowControlFrames++;
+								sender.handleFrame(message);
+							}
+							else
+							{
+								receiver.handleFrame(message);
+								bystander.handleFrame(message);
+							}
+						}
+
+						receiver.update();
+						bystander.update();
+						sender.update();
+					}
+					while (LoopbackCan::length != 0);
+				}
+
+				uint32_t time = getTimePerIteration(start);
+				uint32_t bytes = static_cast<uint32_t>(LENGTH) * ITERATIONS;
+
+				OSSHS_LOG_INFO("Benchmark segmented transport(destination = 0x%02x, bytes = %lu/%lu, overheard = %lu, frames = %lu, flow control = %lu, transfer = %lu ns, bus = %lu B/s).",
+					destination, received, bytes, overheard, LoopbackCan::frameCount, flowControlFrames, time,
+					static_cast<uint32_t>(static_cast<uint64_t>(bytes) * BITRATE / LoopbackCan::bitCount));
+			}
+		}
+
+		uint32_t
+		Benchmark::getTimePerIteration(uint32_t start)
+		{
+			uint32_t elapsed = Time::getSystemTime<uint32_t, Time::Precision::Microseconds>() - start;
+
+			return static_cast<uint32_t>(static_cast<uint64_t>(elapsed) * 1000 / ITERATIONS);
+		}
+	}
+#endif  // ENABLE_BENCHMARK
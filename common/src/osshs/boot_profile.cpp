@@ -0,0 +1,119 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2019 Linas Nikiperavicius
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <osshs/boot_profile.hpp>
+#include <osshs/time.hpp>
+#include <osshs/log/logger.hpp>
+
+namespace osshs
+{
+	BootProfile::Entry BootProfile::entries[BootProfile::SIZE] = {};
+	uint8_t BootProfile::count = 0;
+	uint8_t BootProfile::reported = 0;
+	uint8_t BootProfile::overflow = 0;
+	bool BootProfile::loopStarted = false;
+	bool BootProfile::firstEvent = false;
+	uint32_t BootProfile::firstEventTimestamp = 0;
+	uint32_t BootProfile::loopTimestamp = 0;
+	uint32_t BootProfile::reportTimestamp = 0;
+
+	void
+	BootProfile::mark(BootPhase phase, uint16_t argument)
+	{
+		uint32_t timestamp = Time::getSystemTime<uint32_t, Time::Precision::Microseconds>();
+
+		if (phase == BootPhase::LOOP_STARTED)
+		{
+			loopStarted = true;
+			loopTimestamp = timestamp / 1000;
+		}
+
+		if (phase == BootPhase::FIRST_EVENT)
+			firstEventTimestamp = timestamp;
+
+		if (count >= SIZE)
+		{
+			overflow++;
+			return;
+		}
+
+		entries[count++] = {phase, argument, timestamp};
+	}
+
+	uint32_t
+	BootProfile::getTimeToFirstEvent()
+	{
+		return firstEventTimestamp;
+	}
+
+	void
+	BootProfile::update()
+	{
+		if (reported > count)
+			return;
+
+		uint32_t now = Time::getSystemTime<uint32_t, Time::Precision::Milliseconds>();
+
+		// Stay off the UART until the system is up, unless nothing arrives for a while.
+		if ((!firstEvent && now - loopTimestamp < REPORT_DELAY) || now - reportTimestamp < REPORT_INTERVAL)
+			return;
+
+		reportTimestamp = now;
+
+		if (reported == count)
+		{
+			if (firstEvent)
+			{
+				OSSHS_LOG_INFO("Boot profile complete(timeToFirstEvent = %lu us, unrecorded = %u).", firstEventTimestamp, overflow);
+				reported++;
+			}
+
+			return;
+		}
+
+		const Entry &entry = entries[reported++];
+
+		switch (entry.phase)
+		{
+			case BootPhase::SYSTEM_INITIALIZED:
+				OSSHS_LOG_INFO("Boot profile: system initialized(time = %lu us).", entry.timestamp);
+				break;
+			case BootPhase::INTERFACE_REGISTERED:
+				OSSHS_LOG_INFO("Boot profile: interface registered(time = %lu us).", entry.timestamp);
+				break;
+			case BootPhase::MODULE_REGISTERED:
+				OSSHS_LOG_INFO("Boot profile: module registered(type = 0x%02x, time = %lu us).", entry.argument, entry.timestamp);
+				break;
+			case BootPhase::APPLICATION:
+				OSSHS_LOG_INFO("Boot profile: application phase(phase = %u, time = %lu us).", entry.argument, entry.timestamp);
+				break;
+			case BootPhase::LOOP_STARTED:
+				OSSHS_LOG_INFO("Boot profile: loop started(time = %lu us).", entry.timestamp);
+				break;
+			case BootPhase::FIRST_EVENT:
+				OSSHS_LOG_INFO("Boot profile: first event(type = 0x%04x, time = %lu us).", entry.argument, entry.timestamp);
+				break;
+		}
+	}
+}
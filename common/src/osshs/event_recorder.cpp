@@ -0,0 +1,160 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2019 Linas Nikiperavicius
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <osshs/event_recorder.hpp>
+
+#ifdef ENABLE_EVENT_RECORDER
+	#include <osshs/time.hpp>
+	#include <osshs/log/logger.hpp>
+
+	namespace osshs
+	{
+		uint8_t EventRecorder::ring[EventRecorder::SIZE];
+		uint16_t EventRecorder::head = 0;
+		uint16_t EventRecorder::tail = 0;
+		uint16_t EventRecorder::used = 0;
+		uint16_t EventRecorder::sequence = 0;
+		uint32_t EventRecorder::droppedCount = 0;
+		uint32_t EventRecorder::reportedDroppedCount = 0;
+		uint16_t EventRecorder::logOffset = 0;
+
+		void
+		EventRecorder::recordReceived(const uint8_t *data)
+		{
+			record(EventDirection::RECEIVED, data);
+		}
+
+		void
+		EventRecorder::recordSent(const events::Event *event)
+		{
+			if (event == nullptr)
+				return;
+
+			std::unique_ptr<const uint8_t[]> data = event->serialize();
+
+			if (data == nullptr)
+				return;
+
+			record(EventDirection::SENT, data.get());
+		}
+
+		void
+		EventRecorder::update()
+		{
+		#ifndef DISABLE_LOGGING
+			// Half of the log buffer is left to other messages.
+			while (used > 0 && log::Logger::getFree() >= log::LogBuffer::SIZE / 2)
+			{
+				uint16_t recordSequence = peek(0) | (peek(1) << 8);
+				uint16_t length = peek(RECORD_HEADER_LENGTH) | (peek(RECORD_HEADER_LENGTH + 1) << 8);
+
+				if (logOffset == 0)
+				{
+					uint32_t timestamp = peek(3) | (peek(4) << 8) | (peek(5) << 16) | (static_cast<uint32_t>(peek(6)) << 24);
+
+					OSSHS_LOG_INFO("event(sequence = %u, direction = %u, time = %lu, length = %u)",
+						recordSequence, peek(2), timestamp, length);
+				}
+
+				// Bytes are packed most significant first, so the hex digits read in data order.
+				uint32_t words[LOG_CHUNK_LENGTH / 4] = {};
+
+				for (uint8_t i = 0; i < LOG_CHUNK_LENGTH && logOffset + i < length; i++)
+					words[i / 4] |= static_cast<uint32_t>(peek(RECORD_HEADER_LENGTH + logOffset + i)) << (24 - (i % 4) * 8);
+
+				OSSHS_LOG_INFO("event data(sequence = %u, offset = %u, data = %08lx%08lx%08lx%08lx)",
+					recordSequence, logOffset, words[0], words[1], words[2], words[3]);
+
+				logOffset += LOG_CHUNK_LENGTH;
+
+				if (logOffset >= length)
+				{
+					tail = (tail + RECORD_HEADER_LENGTH + length) % SIZE;
+					used -= RECORD_HEADER_LENGTH + length;
+					logOffset = 0;
+				}
+			}
+
+			// Records dropped after the last logged one would not show up as a sequence gap until the next record.
+			if (used == 0 && reportedDroppedCount != droppedCount && log::Logger::getFree() >= log::LogBuffer::SIZE / 2)
+			{
+				OSSHS_LOG_WARNING("Dropped event records(next sequence = %u, dropped = %lu).", sequence, droppedCount);
+				reportedDroppedCount = droppedCount;
+			}
+		#endif  // DISABLE_LOGGING
+		}
+
+		uint32_t
+		EventRecorder::getDroppedCount()
+		{
+			return droppedCount;
+		}
+
+		void
+		EventRecorder::record(EventDirection direction, const uint8_t *data)
+		{
+			uint16_t length = data[0] | (data[1] << 8);
+			uint16_t recordSequence = sequence++;
+
+			if (RECORD_HEADER_LENGTH + length > SIZE - used)
+			{
+				droppedCount++;
+				return;
+			}
+
+			uint32_t timestamp = Time::getSystemTime<uint32_t, Time::Precision::Microseconds>();
+
+			uint8_t header[RECORD_HEADER_LENGTH] = {
+				static_cast<uint8_t>(recordSequence),
+				static_cast<uint8_t>(recordSequence >> 8),
+				static_cast<uint8_t>(direction),
+				static_cast<uint8_t>(timestamp),
+				static_cast<uint8_t>(timestamp >> 8),
+				static_cast<uint8_t>(timestamp >> 16),
+				static_cast<uint8_t>(timestamp >> 24)
+			};
+
+			write(header, RECORD_HEADER_LENGTH);
+			write(data, length);
+		}
+
+		void
+		EventRecorder::write(const uint8_t *data, uint16_t length)
+		{
+			for (uint16_t i = 0; i < length; i++)
+			{
+				ring[head] = data[i];
+				head = (head + 1) % SIZE;
+			}
+
+			used += length;
+		}
+
+		uint8_t
+		EventRecorder::peek(uint16_t offset)
+		{
+			return ring[(tail + offset) % SIZE];
+		}
+	}
+#endif  // ENABLE_EVENT_RECORDER
@@ -0,0 +1,107 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2019 Linas Nikiperavicius
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <modm/platform.hpp>
+#include <osshs/rpc.hpp>
+#include <osshs/events/event.hpp>
+#include <osshs/events/cause_id_allocator.hpp>
+
+namespace osshs
+{
+	namespace events
+	{
+		uint16_t CauseIdAllocator::prefix = 0;
+		uint16_t CauseIdAllocator::sequence = 0;
+		uint16_t CauseIdAllocator::reserved[CAUSE_ID_MAX_RESERVED];
+		uint8_t CauseIdAllocator::reservedCount = 0;
+
+		static_assert(RPC_MAX_PENDING + CAUSE_ID_MAX_RESERVED < CauseIdAllocator::SEQUENCE_MASK,
+			"Pending and reserved cause ids must leave free ids in the sequence.");
+
+		uint16_t
+		CauseIdAllocator::allocate()
+		{
+			uint16_t causeId;
+
+			// The pending and reserved checks are made under the same lock, so an id
+			// cannot become pending or reserved between the check and the allocation.
+			modm::atomic::Lock lock;
+
+			do
+			{
+				causeId = prefix | sequence;
+				sequence = (sequence + 1) & SEQUENCE_MASK;
+			}
+			while (causeId == Event::CAUSE_ID_GENERATE || isReserved(causeId) || Rpc::isPending(causeId));
+
+			return causeId;
+		}
+
+		void
+		CauseIdAllocator::setNodeId(uint8_t nodeId)
+		{
+			modm::atomic::Lock lock;
+
+			prefix = static_cast<uint16_t>(nodeId & Event::MAX_NODE_ID) << SEQUENCE_BITS;
+		}
+
+		bool
+		CauseIdAllocator::reserve(uint16_t causeId)
+		{
+			modm::atomic::Lock lock;
+
+			if (reservedCount >= CAUSE_ID_MAX_RESERVED)
+				return false;
+
+			reserved[reservedCount++] = causeId;
+
+			return true;
+		}
+
+		void
+		CauseIdAllocator::release(uint16_t causeId)
+		{
+			modm::atomic::Lock lock;
+
+			for (uint8_t i = 0; i < reservedCount; i++)
+			{
+				if (reserved[i] == causeId)
+				{
+					reserved[i] = reserved[--reservedCount];
+					return;
+				}
+			}
+		}
+
+		bool
+		CauseIdAllocator::isReserved(uint16_t causeId)
+		{
+			for (uint8_t i = 0; i < reservedCount; i++)
+				if (reserved[i] == causeId)
+					return true;
+
+			return false;
+		}
+	}
+}
@@ -0,0 +1,650 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2019 Linas Nikiperavicius
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <osshs/events/diagnostics_event.hpp>
+#include <osshs/log/logger.hpp>
+
+namespace osshs
+{
+	namespace events
+	{
+		DiagnosticsRequestLockStatisticsEvent::DiagnosticsRequestLockStatisticsEvent(std::unique_ptr<const uint8_t[]> data, EventCallback callback)
+			: EventRegistrar<DiagnosticsRequestLockStatisticsEvent>(data[4] | (data[5] << 8), callback)
+		{
+			lock = data[8];
+		}
+
+		uint8_t
+		DiagnosticsRequestLockStatisticsEvent::getLock() const
+		{
+			return lock;
+		}
+
+		std::unique_ptr<const uint8_t[]>
+		DiagnosticsRequestLockStatisticsEvent::serialize() const
+		{
+			uint8_t *buffer = new (std::nothrow) uint8_t[EVENT_LENGTH];
+
+			if (buffer == nullptr)
+			{
+				OSSHS_LOG_ERROR("Failed to allocate memory for a buffer(bufferLength = %u).", EVENT_LENGTH);
+				return std::unique_ptr<const uint8_t[]>();
+			}
+
+			buffer[0] = EVENT_LENGTH & 0xff;
+			buffer[1] = (EVENT_LENGTH >> 8);
+
+			buffer[2] = TYPE & 0xff;
+			buffer[3] = (TYPE >> 8);
+
+			buffer[4] = causeId & 0xff;
+			buffer[5] = (causeId >> 8);
+
+			buffer[6] = destination;
+			buffer[7] = source;
+
+			buffer[8] = lock;
+
+			return std::unique_ptr<const uint8_t[]>(buffer);
+		}
+
+
+		DiagnosticsLockStatisticsReadyEvent::DiagnosticsLockStatisticsReadyEvent(std::unique_ptr<const uint8_t[]> data, EventCallback callback)
+			: EventRegistrar<DiagnosticsLockStatisticsReadyEvent>(data[4] | (data[5] << 8), callback)
+		{
+			lock = data[8];
+			lockCount = data[9];
+			statistics.lockId = data[10] | (data[11] << 8) | (data[12] << 16) | (static_cast<uint32_t>(data[13]) << 24);
+			statistics.acquisitions = data[14] | (data[15] << 8) | (data[16] << 16) | (static_cast<uint32_t>(data[17]) << 24);
+			statistics.failedTryLocks = data[18] | (data[19] << 8) | (data[20] << 16) | (static_cast<uint32_t>(data[21]) << 24);
+			statistics.maxHoldTime = data[22] | (data[23] << 8) | (data[24] << 16) | (static_cast<uint32_t>(data[25]) << 24);
+			statistics.averageHoldTime = data[26] | (data[27] << 8) | (data[28] << 16) | (static_cast<uint32_t>(data[29]) << 24);
+			statistics.maxWaitTime = data[30] | (data[31] << 8) | (data[32] << 16) | (static_cast<uint32_t>(data[33]) << 24);
+		}
+
+		uint8_t
+		DiagnosticsLockStatisticsReadyEvent::getLock() const
+		{
+			return lock;
+		}
+
+		uint8_t
+		DiagnosticsLockStatisticsReadyEvent::getLockCount() const
+		{
+			return lockCount;
+		}
+
+		DiagnosticsLockStatistics
+		DiagnosticsLockStatisticsReadyEvent::getStatistics() const
+		{
+			return statistics;
+		}
+
+		std::unique_ptr<const uint8_t[]>
+		DiagnosticsLockStatisticsReadyEvent::serialize() const
+		{
+			uint8_t *buffer = new (std::nothrow) uint8_t[EVENT_LENGTH];
+
+			if (buffer == nullptr)
+			{
+				OSSHS_LOG_ERROR("Failed to allocate memory for a buffer(bufferLength = %u).", EVENT_LENGTH);
+				return std::unique_ptr<const uint8_t[]>();
+			}
+
+			buffer[0] = EVENT_LENGTH & 0xff;
+			buffer[1] = (EVENT_LENGTH >> 8);
+
+			buffer[2] = TYPE & 0xff;
+			buffer[3] = (TYPE >> 8);
+
+			buffer[4] = causeId & 0xff;
+			buffer[5] = (causeId >> 8);
+
+			buffer[6] = destination;
+			buffer[7] = source;
+
+			buffer[8] = lock;
+			buffer[9] = lockCount;
+
+			buffer[10] = statistics.lockId & 0xff;
+			buffer[11] = (statistics.lockId >> 8);
+			buffer[12] = (statistics.lockId >> 16);
+			buffer[13] = (statistics.lockId >> 24);
+
+			buffer[14] = statistics.acquisitions & 0xff;
+			buffer[15] = (statistics.acquisitions >> 8);
+			buffer[16] = (statistics.acquisitions >> 16);
+			buffer[17] = (statistics.acquisitions >> 24);
+
+			buffer[18] = statistics.failedTryLocks & 0xff;
+			buffer[19] = (statistics.failedTryLocks >> 8);
+			buffer[20] = (statistics.failedTryLocks >> 16);
+			buffer[21] = (statistics.failedTryLocks >> 24);
+
+			buffer[22] = statistics.maxHoldTime & 0xff;
+			buffer[23] = (statistics.maxHoldTime >> 8);
+			buffer[24] = (statistics.maxHoldTime >> 16);
+			buffer[25] = (statistics.maxHoldTime >> 24);
+
+			buffer[26] = statistics.averageHoldTime & 0xff;
+			buffer[27] = (statistics.averageHoldTime >> 8);
+			buffer[28] = (statistics.averageHoldTime >> 16);
+			buffer[29] = (statistics.averageHoldTime >> 24);
+
+			buffer[30] = statistics.maxWaitTime & 0xff;
+			buffer[31] = (statistics.maxWaitTime >> 8);
+			buffer[32] = (statistics.maxWaitTime >> 16);
+			buffer[33] = (statistics.maxWaitTime >> 24);
+
+			return std::unique_ptr<const uint8_t[]>(buffer);
+		}
+
+
+		DiagnosticsRequestTraceEvent::DiagnosticsRequestTraceEvent(std::unique_ptr<const uint8_t[]> data, EventCallback callback)
+			: EventRegistrar<DiagnosticsRequestTraceEvent>(data[4] | (data[5] << 8), callback)
+		{
+			index = data[8] | (data[9] << 8);
+			target = static_cast<DiagnosticsTraceTarget>(data[10]);
+		}
+
+		uint16_t
+		DiagnosticsRequestTraceEvent::getIndex() const
+		{
+			return index;
+		}
+
+		DiagnosticsTraceTarget
+		DiagnosticsRequestTraceEvent::getTarget() const
+		{
+			return target;
+		}
+
+		std::unique_ptr<const uint8_t[]>
+		DiagnosticsRequestTraceEvent::serialize() const
+		{
+			uint8_t *buffer = new (std::nothrow) uint8_t[EVENT_LENGTH];
+
+			if (buffer == nullptr)
+			{
+				OSSHS_LOG_ERROR("Failed to allocate memory for a buffer(bufferLength = %u).", EVENT_LENGTH);
+				return std::unique_ptr<const uint8_t[]>();
+			}
+
+			buffer[0] = EVENT_LENGTH & 0xff;
+			buffer[1] = (EVENT_LENGTH >> 8);
+
+			buffer[2] = TYPE & 0xff;
+			buffer[3] = (TYPE >> 8);
+
+			buffer[4] = causeId & 0xff;
+			buffer[5] = (causeId >> 8);
+
+			buffer[6] = destination;
+			buffer[7] = source;
+
+			buffer[8] = index & 0xff;
+			buffer[9] = (index >> 8);
+
+			buffer[10] = static_cast<uint8_t>(target);
+
+			return std::unique_ptr<const uint8_t[]>(buffer);
+		}
+
+
+		DiagnosticsTraceReadyEvent::DiagnosticsTraceReadyEvent(std::unique_ptr<const uint8_t[]> data, EventCallback callback)
+			: EventRegistrar<DiagnosticsTraceReadyEvent>(data[4] | (data[5] << 8), callback)
+		{
+			index = data[8] | (data[9] << 8);
+			recordCount = data[10] | (data[11] << 8);
+			length = (data[12] < MAX_RECORDS) ? data[12] : MAX_RECORDS;
+
+			for (uint8_t i = 0; i < length; i++)
+			{
+				const uint8_t *record = &data[13 + i * RECORD_LENGTH];
+
+				records[i].timestamp = record[0] | (record[1] << 8) | (record[2] << 16) | (static_cast<uint32_t>(record[3]) << 24);
+				records[i].causeId = record[4] | (record[5] << 8);
+				records[i].type = record[6] | (record[7] << 8);
+				records[i].stage = static_cast<DiagnosticsTraceStage>(record[8]);
+			}
+		}
+
+		uint16_t
+		DiagnosticsTraceReadyEvent::getIndex() const
+		{
+			return index;
+		}
+
+		uint16_t
+		DiagnosticsTraceReadyEvent::getRecordCount() const
+		{
+			return recordCount;
+		}
+
+		uint8_t
+		DiagnosticsTraceReadyEvent::getLength() const
+		{
+			return length;
+		}
+
+		DiagnosticsTraceRecord
+		DiagnosticsTraceReadyEvent::getRecord(uint8_t record) const
+		{
+			return (record < length) ? records[record] : DiagnosticsTraceRecord();
+		}
+
+		std::unique_ptr<const uint8_t[]>
+		DiagnosticsTraceReadyEvent::serialize() const
+		{
+			uint8_t *buffer = new (std::nothrow) uint8_t[EVENT_LENGTH];
+
+			if (buffer == nullptr)
+			{
+				OSSHS_LOG_ERROR("Failed to allocate memory for a buffer(bufferLength = %u).", EVENT_LENGTH);
+				return std::unique_ptr<const uint8_t[]>();
+			}
+
+			buffer[0] = EVENT_LENGTH & 0xff;
+			buffer[1] = (EVENT_LENGTH >> 8);
+
+			buffer[2] = TYPE & 0xff;
+			buffer[3] = (TYPE >> 8);
+
+			buffer[4] = causeId & 0xff;
+			buffer[5] = (causeId >> 8);
+
+			buffer[6] = destination;
+			buffer[7] = source;
+
+			buffer[8] = index & 0xff;
+			buffer[9] = (index >> 8);
+
+			buffer[10] = recordCount & 0xff;
+			buffer[11] = (recordCount >> 8);
+
+			buffer[12] = length;
+
+			for (uint8_t i = 0; i < MAX_RECORDS; i++)
+			{
+				uint8_t *record = &buffer[13 + i * RECORD_LENGTH];
+				DiagnosticsTraceRecord value = (i < length) ? records[i] : DiagnosticsTraceRecord();
+
+				record[0] = value.timestamp & 0xff;
+				record[1] = (value.timestamp >> 8);
+				record[2] = (value.timestamp >> 16);
+				record[3] = (value.timestamp >> 24);
+
+				record[4] = value.causeId & 0xff;
+				record[5] = (value.causeId >> 8);
+
+				record[6] = value.type & 0xff;
+				record[7] = (value.type >> 8);
+
+				record[8] = static_cast<uint8_t>(value.stage);
+			}
+
+			return std::unique_ptr<const uint8_t[]>(buffer);
+		}
+
+
+		DiagnosticsRequestModuleMetricsEvent::DiagnosticsRequestModuleMetricsEvent(std::unique_ptr<const uint8_t[]> data, EventCallback callback)
+			: EventRegistrar<DiagnosticsRequestModuleMetricsEvent>(data[4] | (data[5] << 8), callback)
+		{
+			module = data[8];
+		}
+
+		uint8_t
+		DiagnosticsRequestModuleMetricsEvent::getModule() const
+		{
+			return module;
+		}
+
+		std::unique_ptr<const uint8_t[]>
+		DiagnosticsRequestModuleMetricsEvent::serialize() const
+		{
+			uint8_t *buffer = new (std::nothrow) uint8_t[EVENT_LENGTH];
+
+			if (buffer == nullptr)
+			{
+				OSSHS_LOG_ERROR("Failed to allocate memory for a buffer(bufferLength = %u).", EVENT_LENGTH);
+				return std::unique_ptr<const uint8_t[]>();
+			}
+
+			buffer[0] = EVENT_LENGTH & 0xff;
+			buffer[1] = (EVENT_LENGTH >> 8);
+
+			buffer[2] = TYPE & 0xff;
+			buffer[3] = (TYPE >> 8);
+
+			buffer[4] = causeId & 0xff;
+			buffer[5] = (causeId >> 8);
+
+			buffer[6] = destination;
+			buffer[7] = source;
+
+			buffer[8] = module;
+
+			return std::unique_ptr<const uint8_t[]>(buffer);
+		}
+
+
+		DiagnosticsModuleMetricsReadyEvent::DiagnosticsModuleMetricsReadyEvent(std::unique_ptr<const uint8_t[]> data, EventCallback callback)
+			: EventRegistrar<DiagnosticsModuleMetricsReadyEvent>(data[4] | (data[5] << 8), callback)
+		{
+			uint16_t eventLength = data[0] | (data[1] << 8);
+
+			module = data[8];
+			moduleCount = data[9];
+			moduleTypeId = data[10];
+			metrics.eventsHandled = data[11] | (data[12] << 8) | (data[13] << 16) | (static_cast<uint32_t>(data[14]) << 24);
+			metrics.errors = data[15] | (data[16] << 8) | (data[17] << 16) | (static_cast<uint32_t>(data[18]) << 24);
+			metrics.queueHighWaterMark = data[19] | (data[20] << 8);
+			metrics.totalHandlerTime = 0;
+
+			for (uint8_t i = 0; i < 8; i++)
+				metrics.totalHandlerTime |= static_cast<uint64_t>(data[21 + i]) << (i * 8);
+
+			metrics.maxHandlerTime = data[29] | (data[30] << 8) | (data[31] << 16) | (static_cast<uint32_t>(data[32]) << 24);
+			eventCountLength = data[33];
+
+			if (eventCountLength > MAX_EVENT_COUNTS || PREFIX_LENGTH + eventCountLength * EVENT_COUNT_LENGTH != eventLength)
+			{
+				OSSHS_LOG_WARNING("Failed to construct a diagnostics module metrics ready event(eventLength = %u, eventCountLength = %u).", eventLength, eventCountLength);
+				eventCountLength = 0;
+				return;
+			}
+
+			for (uint8_t i = 0; i < eventCountLength; i++)
+			{
+				const uint8_t *eventCount = &data[PREFIX_LENGTH + i * EVENT_COUNT_LENGTH];
+
+				eventCounts[i].type = eventCount[0] | (eventCount[1] << 8);
+				eventCounts[i].count = eventCount[2] | (eventCount[3] << 8) | (eventCount[4] << 16) | (static_cast<uint32_t>(eventCount[5]) << 24);
+			}
+		}
+
+		void
+		DiagnosticsModuleMetricsReadyEvent::addEventCount(DiagnosticsEventCount eventCount)
+		{
+			if (eventCountLength < MAX_EVENT_COUNTS)
+				eventCounts[eventCountLength++] = eventCount;
+		}
+
+		uint8_t
+		DiagnosticsModuleMetricsReadyEvent::getModule() const
+		{
+			return module;
+		}
+
+		uint8_t
+		DiagnosticsModuleMetricsReadyEvent::getModuleCount() const
+		{
+			return moduleCount;
+		}
+
+		uint8_t
+		DiagnosticsModuleMetricsReadyEvent::getModuleTypeId() const
+		{
+			return moduleTypeId;
+		}
+
+		DiagnosticsModuleMetrics
+		DiagnosticsModuleMetricsReadyEvent::getMetrics() const
+		{
+			return metrics;
+		}
+
+		uint8_t
+		DiagnosticsModuleMetricsReadyEvent::getEventCountLength() const
+		{
+			return eventCountLength;
+		}
+
+		DiagnosticsEventCount
+		DiagnosticsModuleMetricsReadyEvent::getEventCount(uint8_t index) const
+		{
+			return (index < eventCountLength) ? eventCounts[index] : DiagnosticsEventCount();
+		}
+
+		std::unique_ptr<const uint8_t[]>
+		DiagnosticsModuleMetricsReadyEvent::serialize() const
+		{
+			uint16_t EVENT_LENGTH = PREFIX_LENGTH + eventCountLength * EVENT_COUNT_LENGTH;
+			uint8_t *buffer = new (std::nothrow) uint8_t[EVENT_LENGTH];
+
+			if (buffer == nullptr)
+			{
+				OSSHS_LOG_ERROR("Failed to allocate memory for a buffer(bufferLength = %u).", EVENT_LENGTH);
+				return std::unique_ptr<const uint8_t[]>();
+			}
+
+			buffer[0] = EVENT_LENGTH & 0xff;
+			buffer[1] = (EVENT_LENGTH >> 8);
+
+			buffer[2] = TYPE & 0xff;
+			buffer[3] = (TYPE >> 8);
+
+			buffer[4] = causeId & 0xff;
+			buffer[5] = (causeId >> 8);
+
+			buffer[6] = destination;
+			buffer[7] = source;
+
+			buffer[8] = module;
+			buffer[9] = moduleCount;
+			buffer[10] = moduleTypeId;
+
+			buffer[11] = metrics.eventsHandled & 0xff;
+			buffer[12] = (metrics.eventsHandled >> 8);
+			buffer[13] = (metrics.eventsHandled >> 16);
+			buffer[14] = (metrics.eventsHandled >> 24);
+
+			buffer[15] = metrics.errors & 0xff;
+			buffer[16] = (metrics.errors >> 8);
+			buffer[17] = (metrics.errors >> 16);
+			buffer[18] = (metrics.errors >> 24);
+
+			buffer[19] = metrics.queueHighWaterMark & 0xff;
+			buffer[20] = (metrics.queueHighWaterMark >> 8);
+
+			for (uint8_t i = 0; i < 8; i++)
+				buffer[21 + i] = (metrics.totalHandlerTime >> (i * 8)) & 0xff;
+
+			buffer[29] = metrics.maxHandlerTime & 0xff;
+			buffer[30] = (metrics.maxHandlerTime >> 8);
+			buffer[31] = (metrics.maxHandlerTime >> 16);
+			buffer[32] = (metrics.maxHandlerTime >> 24);
+
+			buffer[33] = eventCountLength;
+
+			for (uint8_t i = 0; i < eventCountLength; i++)
+			{
+				uint8_t *eventCount = &buffer[PREFIX_LENGTH + i * EVENT_COUNT_LENGTH];
+
+				eventCount[0] = eventCounts[i].type & 0xff;
+				eventCount[1] = (eventCounts[i].type >> 8);
+				eventCount[2] = eventCounts[i].count & 0xff;
+				eventCount[3] = (eventCounts[i].count >> 8);
+				eventCount[4] = (eventCounts[i].count >> 16);
+				eventCount[5] = (eventCounts[i].count >> 24);
+			}
+
+			return std::unique_ptr<const uint8_t[]>(buffer);
+		}
+
+
+		DiagnosticsRequestMemoryStatisticsEvent::DiagnosticsRequestMemoryStatisticsEvent(std::unique_ptr<const uint8_t[]> data, EventCallback callback)
+			: EventRegistrar<DiagnosticsRequestMemoryStatisticsEvent>(data[4] | (data[5] << 8), callback)
+		{
+			static_cast<void>(data);
+		}
+
+		std::unique_ptr<const uint8_t[]>
+		DiagnosticsRequestMemoryStatisticsEvent::serialize() const
+		{
+			uint8_t *buffer = new (std::nothrow) uint8_t[EVENT_LENGTH];
+
+			if (buffer == nullptr)
+			{
+				OSSHS_LOG_ERROR("Failed to allocate memory for a buffer(bufferLength = %u).", EVENT_LENGTH);
+				return std::unique_ptr<const uint8_t[]>();
+			}
+
+			buffer[0] = EVENT_LENGTH & 0xff;
+			buffer[1] = (EVENT_LENGTH >> 8);
+
+			buffer[2] = TYPE & 0xff;
+			buffer[3] = (TYPE >> 8);
+
+			buffer[4] = causeId & 0xff;
+			buffer[5] = (causeId >> 8);
+
+			buffer[6] = destination;
+			buffer[7] = source;
+
+			return std::unique_ptr<const uint8_t[]>(buffer);
+		}
+
+
+		DiagnosticsMemoryStatisticsReadyEvent::DiagnosticsMemoryStatisticsReadyEvent(std::unique_ptr<const uint8_t[]> data, EventCallback callback)
+			: EventRegistrar<DiagnosticsMemoryStatisticsReadyEvent>(data[4] | (data[5] << 8), callback)
+		{
+			statistics.liveBytes = data[8] | (data[9] << 8) | (data[10] << 16) | (static_cast<uint32_t>(data[11]) << 24);
+			statistics.peakBytes = data[12] | (data[13] << 8) | (data[14] << 16) | (static_cast<uint32_t>(data[15]) << 24);
+			statistics.allocations = data[16] | (data[17] << 8) | (data[18] << 16) | (static_cast<uint32_t>(data[19]) << 24);
+			statistics.failedAllocations = data[20] | (data[21] << 8) | (data[22] << 16) | (static_cast<uint32_t>(data[23]) << 24);
+			statistics.largestFreeBlock = data[24] | (data[25] << 8) | (data[26] << 16) | (static_cast<uint32_t>(data[27]) << 24);
+			statistics.stackHighWaterMark = data[28] | (data[29] << 8) | (data[30] << 16) | (static_cast<uint32_t>(data[31]) << 24);
+			statistics.stackSize = data[32] | (data[33] << 8) | (data[34] << 16) | (static_cast<uint32_t>(data[35]) << 24);
+		}
+
+		DiagnosticsMemoryStatistics
+		DiagnosticsMemoryStatisticsReadyEvent::getStatistics() const
+		{
+			return statistics;
+		}
+
+		std::unique_ptr<const uint8_t[]>
+		DiagnosticsMemoryStatisticsReadyEvent::serialize() const
+		{
+			uint8_t *buffer = new (std::nothrow) uint8_t[EVENT_LENGTH];
+
+			if (buffer == nullptr)
+			{
+				OSSHS_LOG_ERROR("Failed to allocate memory for a buffer(bufferLength = %u).", EVENT_LENGTH);
+				return std::unique_ptr<const uint8_t[]>();
+			}
+
+			buffer[0] = EVENT_LENGTH & 0xff;
+			buffer[1] = (EVENT_LENGTH >> 8);
+
+			buffer[2] = TYPE & 0xff;
+			buffer[3] = (TYPE >> 8);
+
+			buffer[4] = causeId & 0xff;
+			buffer[5] = (causeId >> 8);
+
+			buffer[6] = destination;
+			buffer[7] = source;
+
+			buffer[8] = statistics.liveBytes & 0xff;
+			buffer[9] = (statistics.liveBytes >> 8);
+			buffer[10] = (statistics.liveBytes >> 16);
+			buffer[11] = (statistics.liveBytes >> 24);
+
+			buffer[12] = statistics.peakBytes & 0xff;
+			buffer[13] = (statistics.peakBytes >> 8);
+			buffer[14] = (statistics.peakBytes >> 16);
+			buffer[15] = (statistics.peakBytes >> 24);
+
+			buffer[16] = statistics.allocations & 0xff;
+			buffer[17] = (statistics.allocations >> 8);
+			buffer[18] = (statistics.allocations >> 16);
+			buffer[19] = (statistics.allocations >> 24);
+
+			buffer[20] = statistics.failedAllocations & 0xff;
+			buffer[21] = (statistics.failedAllocations >> 8);
+			buffer[22] = (statistics.failedAllocations >> 16);
+			buffer[23] = (statistics.failedAllocations >> 24);
+
+			buffer[24] = statistics.largestFreeBlock & 0xff;
+			buffer[25] = (statistics.largestFreeBlock >> 8);
+			buffer[26] = (statistics.largestFreeBlock >> 16);
+			buffer[27] = (statistics.largestFreeBlock >> 24);
+
+			buffer[28] = statistics.stackHighWaterMark & 0xff;
+			buffer[29] = (statistics.stackHighWaterMark >> 8);
+			buffer[30] = (statistics.stackHighWaterMark >> 16);
+			buffer[31] = (statistics.stackHighWaterMark >> 24);
+
+			buffer[32] = statistics.stackSize & 0xff;
+			buffer[33] = (statistics.stackSize >> 8);
+			buffer[34] = (statistics.stackSize >> 16);
+			buffer[35] = (statistics.stackSize >> 24);
+
+			return std::unique_ptr<const uint8_t[]>(buffer);
+		}
+
+
+		DiagnosticsErrorEvent::DiagnosticsErrorEvent(std::unique_ptr<const uint8_t[]> data, EventCallback callback)
+			: EventRegistrar<DiagnosticsErrorEvent>(data[4] | (data[5] << 8), callback)
+		{
+			error = static_cast<DiagnosticsError>(data[8]);
+		}
+
+		DiagnosticsError
+		DiagnosticsErrorEvent::getError() const
+		{
+			return error;
+		}
+
+		std::unique_ptr<const uint8_t[]>
+		DiagnosticsErrorEvent::serialize() const
+		{
+			uint8_t *buffer = new (std::nothrow) uint8_t[EVENT_LENGTH];
+
+			if (buffer == nullptr)
+			{
+				OSSHS_LOG_ERROR("Failed to allocate memory for a buffer(bufferLength = %u).", EVENT_LENGTH);
+				return std::unique_ptr<const uint8_t[]>();
+			}
+
+			buffer[0] = EVENT_LENGTH & 0xff;
+			buffer[1] = (EVENT_LENGTH >> 8);
+
+			buffer[2] = TYPE & 0xff;
+			buffer[3] = (TYPE >> 8);
+
+			buffer[4] = causeId & 0xff;
+			buffer[5] = (causeId >> 8);
+
+			buffer[6] = destination;
+			buffer[7] = source;
+
+			buffer[8] = static_cast<uint8_t>(error);
+
+			return std::unique_ptr<const uint8_t[]>(buffer);
+		}
+	}
+}
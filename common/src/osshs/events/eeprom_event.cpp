@@ -32,8 +32,8 @@ namespace osshs
 		EepromRequestDataEvent::EepromRequestDataEvent(std::unique_ptr<const uint8_t[]> data, EventCallback callback)
 			: EventRegistrar<EepromRequestDataEvent>(data[4] | (data[5] << 8), callback)
 		{
-			address = data[6] | (data[7] << 8);
-			dataLen = data[8] | (data[9] << 8);
+			address = data[8] | (data[9] << 8);
+			dataLen = data[10] | (data[11] << 8);
 		}
 
 		uint16_t
@@ -68,11 +68,14 @@ namespace osshs
 			buffer[4] = causeId & 0xff;
 			buffer[5] = (causeId >> 8);
 
-			buffer[6] = address & 0xff;
-			buffer[7] = (address >> 8);
+			buffer[6] = destination;
+			buffer[7] = source;
 
-			buffer[8] = dataLen & 0xff;
-			buffer[9] = (dataLen >> 8);
+			buffer[8] = address & 0xff;
+			buffer[9] = (address >> 8);
+
+			buffer[10] = dataLen & 0xff;
+			buffer[11] = (dataLen >> 8);
 
 			return std::unique_ptr<const uint8_t[]>(buffer);
 		}
@@ -82,9 +85,9 @@ namespace osshs
 			: EventRegistrar<EepromDataReadyEvent>(data[4] | (data[5] << 8), callback)
 		{
 			uint16_t eventLength = data[0] | (data[1] << 8);
-			dataLen = data[6] | (data[7] << 8);
+			dataLen = data[8] | (data[9] << 8);
 
-			if (8 + dataLen != eventLength)
+			if (PREFIX_LENGTH + dataLen != eventLength)
 			{
 				OSSHS_LOG_WARNING("Failed to construct an epprom data ready event(eventLength = %u, dataLength = %u).", eventLength, dataLen);
 				return;
@@ -98,7 +101,7 @@ namespace osshs
 				return;
 			}
 
-			std::copy(&data[8], &data[8 + dataLen], &this->data[0]);
+			std::copy(&data[10], &data[10 + dataLen], &this->data[0]);
 		}
 
 		const std::shared_ptr<uint8_t[]>
@@ -116,7 +119,7 @@ namespace osshs
 		std::unique_ptr<const uint8_t[]>
 		EepromDataReadyEvent::serialize() const
 		{
-			uint16_t EVENT_LENGTH = 8 + dataLen;
+			uint16_t EVENT_LENGTH = 10 + dataLen;
 			uint8_t *buffer = new (std::nothrow) uint8_t[EVENT_LENGTH];
 
 			if (buffer == nullptr)
@@ -134,10 +137,13 @@ namespace osshs
 			buffer[4] = causeId & 0xff;
 			buffer[5] = (causeId >> 8);
 
-			buffer[6] = dataLen & 0xff;
-			buffer[7] = (dataLen >> 8);
+			buffer[6] = destination;
+			buffer[7] = source;
+
+			buffer[8] = dataLen & 0xff;
+			buffer[9] = (dataLen >> 8);
 
-			std::copy(&data[0], &data[dataLen], &buffer[8]);
+			std::copy(&data[0], &data[dataLen], &buffer[10]);
 
 			return std::unique_ptr<const uint8_t[]>(buffer);
 		}
@@ -147,10 +153,10 @@ namespace osshs
 			: EventRegistrar<EepromUpdateDataEvent>(data[4] | (data[5] << 8), callback)
 		{
 			uint16_t eventLength = data[0] | (data[1] << 8);
-			address = data[6] | (data[7] << 8);
-			dataLen = data[8] | (data[9] << 8);
+			address = data[8] | (data[9] << 8);
+			dataLen = data[10] | (data[11] << 8);
 
-			if (10 + dataLen != eventLength)
+			if (PREFIX_LENGTH + dataLen != eventLength)
 			{
 				OSSHS_LOG_WARNING("Failed to construct an epprom update data event(eventLength = %u, dataLength = %u).", eventLength, dataLen);
 				return;
@@ -164,7 +170,7 @@ namespace osshs
 				return;
 			}
 
-			std::copy(&data[10], &data[10 + dataLen], &this->data[0]);
+			std::copy(&data[12], &data[12 + dataLen], &this->data[0]);
 		}
 
 		uint16_t
@@ -188,7 +194,7 @@ namespace osshs
 		std::unique_ptr<const uint8_t[]>
 		EepromUpdateDataEvent::serialize() const
 		{
-			uint16_t EVENT_LENGTH = 8 + dataLen;
+			uint16_t EVENT_LENGTH = 12 + dataLen;
 			uint8_t *buffer = new (std::nothrow) uint8_t[EVENT_LENGTH];
 
 			if (buffer == nullptr)
@@ -206,13 +212,16 @@ namespace osshs
 			buffer[4] = causeId & 0xff;
 			buffer[5] = (causeId >> 8);
 
-			buffer[6] = address & 0xff;
-			buffer[7] = (address >> 8);
+			buffer[6] = destination;
+			buffer[7] = source;
 
-			buffer[8] = dataLen & 0xff;
-			buffer[9] = (dataLen >> 8);
+			buffer[8] = address & 0xff;
+			buffer[9] = (address >> 8);
 
-			std::copy(&data[0], &data[dataLen], &buffer[10]);
+			buffer[10] = dataLen & 0xff;
+			buffer[11] = (dataLen >> 8);
+
+			std::copy(&data[0], &data[dataLen], &buffer[12]);
 
 			return std::unique_ptr<const uint8_t[]>(buffer);
 		}
@@ -244,6 +253,9 @@ namespace osshs
 			buffer[4] = causeId & 0xff;
 			buffer[5] = (causeId >> 8);
 
+			buffer[6] = destination;
+			buffer[7] = source;
+
 			return std::unique_ptr<const uint8_t[]>(buffer);
 		}
 
@@ -251,7 +263,7 @@ namespace osshs
 		EepromErrorEvent::EepromErrorEvent(std::unique_ptr<const uint8_t[]> data, EventCallback callback)
 			: EventRegistrar<EepromErrorEvent>(data[4] | (data[5] << 8), callback)
 		{
-			error = static_cast<EepromError>(data[6]);
+			error = static_cast<EepromError>(data[8]);
 		}
 
 		EepromError
@@ -280,7 +292,10 @@ namespace osshs
 			buffer[4] = causeId & 0xff;
 			buffer[5] = (causeId >> 8);
 
-			buffer[6] = static_cast<uint8_t>(error);
+			buffer[6] = destination;
+			buffer[7] = source;
+
+			buffer[8] = static_cast<uint8_t>(error);
 
 			return std::unique_ptr<const uint8_t[]>(buffer);
 		}
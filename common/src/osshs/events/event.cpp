@@ -23,22 +23,22 @@
  */
 
 #include <osshs/events/event.hpp>
+#include <osshs/events/cause_id_allocator.hpp>
 
 namespace osshs
 {
 	namespace events
 	{
-		uint16_t Event::nextCauseId = 0;
+		static_assert(sizeof(EventCallback) == 2 * sizeof(void*), "EventCallback should hold a single captured pointer.");
+		static_assert(sizeof(Event) <= sizeof(void*) + 4 * sizeof(uint16_t) + sizeof(EventCallback), "Event has grown beyond its header fields and callback.");
+
+		// Unset until System::setNodeId, see OSSHS_NODE_ID.
+		uint8_t Event::localNodeId = ADDRESS_BROADCAST;
 
 		Event::Event(uint16_t type, uint16_t causeId, EventCallback callback)
-		 	: type(type), callback(callback)
+		 	: destination(ADDRESS_BROADCAST), source(localNodeId), priority(EventPriority::NORMAL), received(false), type(type), callback(callback)
 		{
-			this->causeId = (causeId == CAUSE_ID_GENERATE) ? nextCauseId++ : causeId;
-
-			if (nextCauseId == CAUSE_ID_GENERATE)
-			{
-				nextCauseId++;
-			}
+			this->causeId = (causeId == CAUSE_ID_GENERATE) ? CauseIdAllocator::allocate() : causeId;
 		}
 
 		uint16_t
@@ -53,17 +53,46 @@ namespace osshs
 			return causeId;
 		}
 
-		EventCallback
+		const EventCallback &
 		Event::getCallback() const
 		{
 			return callback;
 		}
 
-		std::unordered_map<uint16_t, Event::EventMaker>&
-		Event::eventRegister()
+		uint8_t
+		Event::getDestination() const
+		{
+			return destination;
+		}
+
+		void
+		Event::setDestination(uint8_t destination)
+		{
+			this->destination = destination;
+		}
+
+		uint8_t
+		Event::getSource() const
+		{
+			return source;
+		}
+
+		EventPriority
+		Event::getPriority() const
+		{
+			return priority;
+		}
+
+		void
+		Event::setPriority(EventPriority priority)
+		{
+			this->priority = priority;
+		}
+
+		bool
+		Event::isReceived() const
 		{
-			static std::unordered_map<uint16_t, Event::EventMaker> map;
-			return map;
+			return received;
 		}
 	}
 }
@@ -22,25 +22,154 @@
  * SOFTWARE.
  */
 
+#include <algorithm>
+#include <iterator>
+
 #include <osshs/events/event_factory.hpp>
+#include <osshs/events/system_event.hpp>
+#include <osshs/events/eeprom_event.hpp>
+#include <osshs/events/pwm_event.hpp>
+#include <osshs/events/diagnostics_event.hpp>
+#include <osshs/events/firmware_event.hpp>
+#include <osshs/event_recorder.hpp>
+#include <osshs/system.hpp>
+#include <osshs/trace_recorder.hpp>
 #include <osshs/log/logger.hpp>
 
 namespace osshs
 {
 	namespace events
 	{
+		template<typename DerivedEvent>
+		constexpr EventFactory::MakerEntry
+		EventFactory::makerOf()
+		{
+			if constexpr (DerivedEvent::EVENT_LENGTH == 0)
+				return {DerivedEvent::TYPE, DerivedEvent::PREFIX_LENGTH, &EventRegistrar<DerivedEvent>::make};
+			else
+				return {DerivedEvent::TYPE, DerivedEvent::EVENT_LENGTH, &EventRegistrar<DerivedEvent>::make};
+		}
+
+		// New event types must be added here, in type order.
+		constexpr EventFactory::MakerEntry EventFactory::makers[] = {
+			makerOf<SystemErrorEvent>(),
+
+			makerOf<EepromRequestDataEvent>(),
+			makerOf<EepromDataReadyEvent>(),
+			makerOf<EepromUpdateDataEvent>(),
+			makerOf<EepromUpdateSuccessEvent>(),
+			makerOf<EepromErrorEvent>(),
+
+			makerOf<PwmRequestStatusEvent>(),
+			makerOf<PwmStatusReadyEvent>(),
+			makerOf<PwmEnableEvent>(),
+			makerOf<PwmDisableEvent>(),
+			makerOf<PwmRequestChannelEvent>(),
+			makerOf<PwmChannelReadyEvent>(),
+			makerOf<PwmUpdateChannelEvent>(),
+			makerOf<PwmRequestRgbwChannelEvent>(),
+			makerOf<PwmRgbwChannelReadyEvent>(),
+			makerOf<PwmUpdateRgbwChannelEvent>(),
+			makerOf<PwmUpdateSuccessEvent>(),
+			makerOf<PwmErrorEvent>(),
+			makerOf<PwmStoreSceneEvent>(),
+			makerOf<PwmRecallSceneEvent>(),
+
+			makerOf<DiagnosticsRequestLockStatisticsEvent>(),
+			makerOf<DiagnosticsLockStatisticsReadyEvent>(),
+			makerOf<DiagnosticsRequestTraceEvent>(),
+			makerOf<DiagnosticsTraceReadyEvent>(),
+			makerOf<DiagnosticsRequestModuleMetricsEvent>(),
+			makerOf<DiagnosticsModuleMetricsReadyEvent>(),
+			makerOf<DiagnosticsRequestMemoryStatisticsEvent>(),
+			makerOf<DiagnosticsMemoryStatisticsReadyEvent>(),
+			makerOf<DiagnosticsErrorEvent>(),
+
+			makerOf<FirmwareBeginEvent>(),
+			makerOf<FirmwareReadyEvent>(),
+			makerOf<FirmwareBlockEvent>(),
+			makerOf<FirmwareAcknowledgeEvent>(),
+			makerOf<FirmwareFinishEvent>(),
+			makerOf<FirmwareCompleteEvent>(),
+			makerOf<FirmwareErrorEvent>()
+		};
+
+		constexpr bool
+		EventFactory::isSorted()
+		{
+			for (std::size_t i = 1; i < std::size(makers); i++)
+				if (makers[i - 1].type >= makers[i].type)
+					return false;
+
+			return true;
+		}
+
+		const EventFactory::MakerEntry *
+		EventFactory::findMaker(uint16_t type)
+		{
+			static_assert(isSorted(), "Event makers must be sorted by type, without duplicates.");
+
+			const MakerEntry *entry = std::lower_bound(std::begin(makers), std::end(makers), type,
+				[](const MakerEntry &entry, uint16_t type) -> bool
+				{
+					return entry.type < type;
+				}
+			);
+
+			return (entry != std::end(makers) && entry->type == type) ? entry : nullptr;
+		}
+
 		std::shared_ptr<Event>
 		EventFactory::make(uint16_t type, std::unique_ptr<const uint8_t[]> data, EventCallback callback)
 		{
 			OSSHS_LOG_DEBUG("Making event(type = 0x%04x).", type);
 
-			if (Event::eventRegister().find(type) == Event::eventRegister().end())
+			uint16_t length = data[0] | (data[1] << 8);
+
+			if (length < Event::HEADER_LENGTH)
+			{
+				OSSHS_LOG_WARNING("Dropping event shorter than the header(type = 0x%04x, length = %u).", type, length);
+				return std::shared_ptr<Event>();
+			}
+
+			OSSHS_RECORD_RECEIVED(data.get());
+
+			uint8_t destination = data[6];
+			uint8_t source = data[7];
+
+			if (!System::isAddressed(destination))
+			{
+				OSSHS_LOG_DEBUG("Dropping event addressed to another node(type = 0x%04x, destination = 0x%02x).", type, destination);
+				return std::shared_ptr<Event>();
+			}
+
+			const MakerEntry *entry = findMaker(type);
+
+			if (entry == nullptr)
 			{
 				OSSHS_LOG_WARNING("Could not make event(type = 0x%04x).", type);
 				return std::shared_ptr<Event>();
 			}
 
-			return Event::eventRegister().at(type)(std::move(data), callback);
+			// The makers read their fixed fields without checking the length, so a short event would read past the buffer.
+			if (length < entry->minimumLength)
+			{
+				OSSHS_LOG_WARNING("Dropping event shorter than its type(type = 0x%04x, length = %u, minimumLength = %u).", type, length, entry->minimumLength);
+				return std::shared_ptr<Event>();
+			}
+
+			std::shared_ptr<Event> event = entry->maker(std::move(data), callback);
+
+			if (event)
+			{
+				event->destination = destination;
+				event->source = source;
+				event->received = true;
+			}
+
+			OSSHS_TRACE(MADE, event);
+
+			return event;
 		}
 	}
 }
@@ -0,0 +1,388 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2019 Linas Nikiperavicius
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <osshs/events/firmware_event.hpp>
+#include <osshs/log/logger.hpp>
+
+namespace osshs
+{
+	namespace events
+	{
+		FirmwareBeginEvent::FirmwareBeginEvent(std::unique_ptr<const uint8_t[]> data, EventCallback callback)
+			: EventRegistrar<FirmwareBeginEvent>(data[4] | (data[5] << 8), callback)
+		{
+			imageSize = data[8] | (data[9] << 8) | (data[10] << 16) | (static_cast<uint32_t>(data[11]) << 24);
+			imageCrc = data[12] | (data[13] << 8) | (data[14] << 16) | (static_cast<uint32_t>(data[15]) << 24);
+		}
+
+		uint32_t
+		FirmwareBeginEvent::getImageSize() const
+		{
+			return imageSize;
+		}
+
+		uint32_t
+		FirmwareBeginEvent::getImageCrc() const
+		{
+			return imageCrc;
+		}
+
+		std::unique_ptr<const uint8_t[]>
+		FirmwareBeginEvent::serialize() const
+		{
+			uint8_t *buffer = new (std::nothrow) uint8_t[EVENT_LENGTH];
+
+			if (buffer == nullptr)
+			{
+				OSSHS_LOG_ERROR("Failed to allocate memory for a buffer(bufferLength = %u).", EVENT_LENGTH);
+				return std::unique_ptr<const uint8_t[]>();
+			}
+
+			buffer[0] = EVENT_LENGTH & 0xff;
+			buffer[1] = (EVENT_LENGTH >> 8);
+
+			buffer[2] = TYPE & 0xff;
+			buffer[3] = (TYPE >> 8);
+
+			buffer[4] = causeId & 0xff;
+			buffer[5] = (causeId >> 8);
+
+			buffer[6] = destination;
+			buffer[7] = source;
+
+			buffer[8] = imageSize & 0xff;
+			buffer[9] = (imageSize >> 8) & 0xff;
+			buffer[10] = (imageSize >> 16) & 0xff;
+			buffer[11] = (imageSize >> 24);
+
+			buffer[12] = imageCrc & 0xff;
+			buffer[13] = (imageCrc >> 8) & 0xff;
+			buffer[14] = (imageCrc >> 16) & 0xff;
+			buffer[15] = (imageCrc >> 24);
+
+			return std::unique_ptr<const uint8_t[]>(buffer);
+		}
+
+		FirmwareReadyEvent::FirmwareReadyEvent(std::unique_ptr<const uint8_t[]> data, EventCallback callback)
+			: EventRegistrar<FirmwareReadyEvent>(data[4] | (data[5] << 8), callback)
+		{
+			blockSize = data[8] | (data[9] << 8);
+			window = data[10];
+		}
+
+		uint16_t
+		FirmwareReadyEvent::getBlockSize() const
+		{
+			return blockSize;
+		}
+
+		uint8_t
+		FirmwareReadyEvent::getWindow() const
+		{
+			return window;
+		}
+
+		std::unique_ptr<const uint8_t[]>
+		FirmwareReadyEvent::serialize() const
+		{
+			uint8_t *buffer = new (std::nothrow) uint8_t[EVENT_LENGTH];
+
+			if (buffer == nullptr)
+			{
+				OSSHS_LOG_ERROR("Failed to allocate memory for a buffer(bufferLength = %u).", EVENT_LENGTH);
+				return std::unique_ptr<const uint8_t[]>();
+			}
+
+			buffer[0] = EVENT_LENGTH & 0xff;
+			buffer[1] = (EVENT_LENGTH >> 8);
+
+			buffer[2] = TYPE & 0xff;
+			buffer[3] = (TYPE >> 8);
+
+			buffer[4] = causeId & 0xff;
+			buffer[5] = (causeId >> 8);
+
+			buffer[6] = destination;
+			buffer[7] = source;
+
+			buffer[8] = blockSize & 0xff;
+			buffer[9] = (blockSize >> 8);
+
+			buffer[10] = window;
+
+			return std::unique_ptr<const uint8_t[]>(buffer);
+		}
+
+		FirmwareBlockEvent::FirmwareBlockEvent(std::unique_ptr<const uint8_t[]> data, EventCallback callback)
+			: EventRegistrar<FirmwareBlockEvent>(data[4] | (data[5] << 8), callback)
+		{
+			uint16_t eventLength = data[0] | (data[1] << 8);
+			index = data[8] | (data[9] << 8);
+			crc = data[10] | (data[11] << 8) | (data[12] << 16) | (static_cast<uint32_t>(data[13]) << 24);
+			dataLen = data[14] | (data[15] << 8);
+
+			if (PREFIX_LENGTH + dataLen != eventLength)
+			{
+				OSSHS_LOG_WARNING("Failed to construct a firmware block event(eventLength = %u, dataLength = %u).", eventLength, dataLen);
+				return;
+			}
+
+			this->data.reset(new (std::nothrow) uint8_t[dataLen]);
+
+			if (this->data == nullptr)
+			{
+				OSSHS_LOG_ERROR("Failed to allocate memory for a buffer(bufferLength = %u).", dataLen);
+				return;
+			}
+
+			std::copy(&data[16], &data[16 + dataLen], &this->data[0]);
+		}
+
+		uint16_t
+		FirmwareBlockEvent::getIndex() const
+		{
+			return index;
+		}
+
+		uint32_t
+		FirmwareBlockEvent::getCrc() const
+		{
+			return crc;
+		}
+
+		const std::shared_ptr<uint8_t[]>
+		FirmwareBlockEvent::getData() const
+		{
+			return data;
+		}
+
+		uint16_t
+		FirmwareBlockEvent::getDataLen() const
+		{
+			return dataLen;
+		}
+
+		std::unique_ptr<const uint8_t[]>
+		FirmwareBlockEvent::serialize() const
+		{
+			uint16_t EVENT_LENGTH = 16 + dataLen;
+			uint8_t *buffer = new (std::nothrow) uint8_t[EVENT_LENGTH];
+
+			if (buffer == nullptr)
+			{
+				OSSHS_LOG_ERROR("Failed to allocate memory for a buffer(bufferLength = %u).", EVENT_LENGTH);
+				return std::unique_ptr<const uint8_t[]>();
+			}
+
+			buffer[0] = EVENT_LENGTH & 0xff;
+			buffer[1] = (EVENT_LENGTH >> 8);
+
+			buffer[2] = TYPE & 0xff;
+			buffer[3] = (TYPE >> 8);
+
+			buffer[4] = causeId & 0xff;
+			buffer[5] = (causeId >> 8);
+
+			buffer[6] = destination;
+			buffer[7] = source;
+
+			buffer[8] = index & 0xff;
+			buffer[9] = (index >> 8);
+
+			buffer[10] = crc & 0xff;
+			buffer[11] = (crc >> 8) & 0xff;
+			buffer[12] = (crc >> 16) & 0xff;
+			buffer[13] = (crc >> 24);
+
+			buffer[14] = dataLen & 0xff;
+			buffer[15] = (dataLen >> 8);
+
+			std::copy(&data[0], &data[dataLen], &buffer[16]);
+
+			return std::unique_ptr<const uint8_t[]>(buffer);
+		}
+
+		FirmwareAcknowledgeEvent::FirmwareAcknowledgeEvent(std::unique_ptr<const uint8_t[]> data, EventCallback callback)
+			: EventRegistrar<FirmwareAcknowledgeEvent>(data[4] | (data[5] << 8), callback)
+		{
+			nextIndex = data[8] | (data[9] << 8);
+			window = data[10];
+		}
+
+		uint16_t
+		FirmwareAcknowledgeEvent::getNextIndex() const
+		{
+			return nextIndex;
+		}
+
+		uint8_t
+		FirmwareAcknowledgeEvent::getWindow() const
+		{
+			return window;
+		}
+
+		std::unique_ptr<const uint8_t[]>
+		FirmwareAcknowledgeEvent::serialize() const
+		{
+			uint8_t *buffer = new (std::nothrow) uint8_t[EVENT_LENGTH];
+
+			if (buffer == nullptr)
+			{
+				OSSHS_LOG_ERROR("Failed to allocate memory for a buffer(bufferLength = %u).", EVENT_LENGTH);
+				return std::unique_ptr<const uint8_t[]>();
+			}
+
+			buffer[0] = EVENT_LENGTH & 0xff;
+			buffer[1] = (EVENT_LENGTH >> 8);
+
+			buffer[2] = TYPE & 0xff;
+			buffer[3] = (TYPE >> 8);
+
+			buffer[4] = causeId & 0xff;
+			buffer[5] = (causeId >> 8);
+
+			buffer[6] = destination;
+			buffer[7] = source;
+
+			buffer[8] = nextIndex & 0xff;
+			buffer[9] = (nextIndex >> 8);
+
+			buffer[10] = window;
+
+			return std::unique_ptr<const uint8_t[]>(buffer);
+		}
+
+		FirmwareFinishEvent::FirmwareFinishEvent(std::unique_ptr<const uint8_t[]> data, EventCallback callback)
+			: EventRegistrar<FirmwareFinishEvent>(data[4] | (data[5] << 8), callback)
+		{
+			restart = data[8];
+		}
+
+		bool
+		FirmwareFinishEvent::getRestart() const
+		{
+			return restart;
+		}
+
+		std::unique_ptr<const uint8_t[]>
+		FirmwareFinishEvent::serialize() const
+		{
+			uint8_t *buffer = new (std::nothrow) uint8_t[EVENT_LENGTH];
+
+			if (buffer == nullptr)
+			{
+				OSSHS_LOG_ERROR("Failed to allocate memory for a buffer(bufferLength = %u).", EVENT_LENGTH);
+				return std::unique_ptr<const uint8_t[]>();
+			}
+
+			buffer[0] = EVENT_LENGTH & 0xff;
+			buffer[1] = (EVENT_LENGTH >> 8);
+
+			buffer[2] = TYPE & 0xff;
+			buffer[3] = (TYPE >> 8);
+
+			buffer[4] = causeId & 0xff;
+			buffer[5] = (causeId >> 8);
+
+			buffer[6] = destination;
+			buffer[7] = source;
+
+			buffer[8] = static_cast<uint8_t>(restart);
+
+			return std::unique_ptr<const uint8_t[]>(buffer);
+		}
+
+		FirmwareCompleteEvent::FirmwareCompleteEvent(std::unique_ptr<const uint8_t[]> data, EventCallback callback)
+			: EventRegistrar<FirmwareCompleteEvent>(data[4] | (data[5] << 8), callback)
+		{
+			static_cast<void>(data);
+		}
+
+		std::unique_ptr<const uint8_t[]>
+		FirmwareCompleteEvent::serialize() const
+		{
+			uint8_t *buffer = new (std::nothrow) uint8_t[EVENT_LENGTH];
+
+			if (buffer == nullptr)
+			{
+				OSSHS_LOG_ERROR("Failed to allocate memory for a buffer(bufferLength = %u).", EVENT_LENGTH);
+				return std::unique_ptr<const uint8_t[]>();
+			}
+
+			buffer[0] = EVENT_LENGTH & 0xff;
+			buffer[1] = (EVENT_LENGTH >> 8);
+
+			buffer[2] = TYPE & 0xff;
+			buffer[3] = (TYPE >> 8);
+
+			buffer[4] = causeId & 0xff;
+			buffer[5] = (causeId >> 8);
+
+			buffer[6] = destination;
+			buffer[7] = source;
+
+			return std::unique_ptr<const uint8_t[]>(buffer);
+		}
+
+		FirmwareErrorEvent::FirmwareErrorEvent(std::unique_ptr<const uint8_t[]> data, EventCallback callback)
+			: EventRegistrar<FirmwareErrorEvent>(data[4] | (data[5] << 8), callback)
+		{
+			error = static_cast<FirmwareError>(data[8]);
+		}
+
+		FirmwareError
+		FirmwareErrorEvent::getError() const
+		{
+			return error;
+		}
+
+		std::unique_ptr<const uint8_t[]>
+		FirmwareErrorEvent::serialize() const
+		{
+			uint8_t *buffer = new (std::nothrow) uint8_t[EVENT_LENGTH];
+
+			if (buffer == nullptr)
+			{
+				OSSHS_LOG_ERROR("Failed to allocate memory for a buffer(bufferLength = %u).", EVENT_LENGTH);
+				return std::unique_ptr<const uint8_t[]>();
+			}
+
+			buffer[0] = EVENT_LENGTH & 0xff;
+			buffer[1] = (EVENT_LENGTH >> 8);
+
+			buffer[2] = TYPE & 0xff;
+			buffer[3] = (TYPE >> 8);
+
+			buffer[4] = causeId & 0xff;
+			buffer[5] = (causeId >> 8);
+
+			buffer[6] = destination;
+			buffer[7] = source;
+
+			buffer[8] = static_cast<uint8_t>(error);
+
+			return std::unique_ptr<const uint8_t[]>(buffer);
+		}
+	}
+}
@@ -55,6 +55,9 @@ namespace osshs
 			buffer[4] = causeId & 0xff;
 			buffer[5] = (causeId >> 8);
 
+			buffer[6] = destination;
+			buffer[7] = source;
+
 			return std::unique_ptr<const uint8_t[]>(buffer);
 		}
 
@@ -62,7 +65,7 @@ namespace osshs
 		PwmStatusReadyEvent::PwmStatusReadyEvent(std::unique_ptr<const uint8_t[]> data, EventCallback callback)
 			: EventRegistrar<PwmStatusReadyEvent>(data[4] | (data[5] << 8), callback)
 		{
-			status = static_cast<PwmStatus>(data[6]);
+			status = static_cast<PwmStatus>(data[8]);
 		}
 
 		PwmStatus
@@ -91,7 +94,10 @@ namespace osshs
 			buffer[4] = causeId & 0xff;
 			buffer[5] = (causeId >> 8);
 
-			buffer[6] = static_cast<uint8_t>(status);
+			buffer[6] = destination;
+			buffer[7] = source;
+
+			buffer[8] = static_cast<uint8_t>(status);
 
 			return std::unique_ptr<const uint8_t[]>(buffer);
 		}
@@ -123,6 +129,9 @@ namespace osshs
 			buffer[4] = causeId & 0xff;
 			buffer[5] = (causeId >> 8);
 
+			buffer[6] = destination;
+			buffer[7] = source;
+
 			return std::unique_ptr<const uint8_t[]>(buffer);
 		}
 
@@ -153,6 +162,9 @@ namespace osshs
 			buffer[4] = causeId & 0xff;
 			buffer[5] = (causeId >> 8);
 
+			buffer[6] = destination;
+			buffer[7] = source;
+
 			return std::unique_ptr<const uint8_t[]>(buffer);
 		}
 
@@ -160,7 +172,7 @@ namespace osshs
 		PwmRequestChannelEvent::PwmRequestChannelEvent(std::unique_ptr<const uint8_t[]> data, EventCallback callback)
 			: EventRegistrar<PwmRequestChannelEvent>(data[4] | (data[5] << 8), callback)
 		{
-			channel = data[6] | (data[7] << 8);
+			channel = data[8] | (data[9] << 8);
 		}
 
 		uint16_t
@@ -189,8 +201,11 @@ namespace osshs
 			buffer[4] = causeId & 0xff;
 			buffer[5] = (causeId >> 8);
 
-			buffer[6] = channel & 0xff;
-			buffer[7] = (channel >> 8);
+			buffer[6] = destination;
+			buffer[7] = source;
+
+			buffer[8] = channel & 0xff;
+			buffer[9] = (channel >> 8);
 
 			return std::unique_ptr<const uint8_t[]>(buffer);
 		}
@@ -199,8 +214,8 @@ namespace osshs
 		PwmChannelReadyEvent::PwmChannelReadyEvent(std::unique_ptr<const uint8_t[]> data, EventCallback callback)
 			: EventRegistrar<PwmChannelReadyEvent>(data[4] | (data[5] << 8), callback)
 		{
-			channel = data[6] | (data[7] << 8);
-			value = data[8] | (data[9] << 8);
+			channel = data[8] | (data[9] << 8);
+			value = data[10] | (data[11] << 8);
 		}
 
 		uint16_t
@@ -235,11 +250,14 @@ namespace osshs
 			buffer[4] = causeId & 0xff;
 			buffer[5] = (causeId >> 8);
 
-			buffer[6] = channel & 0xff;
-			buffer[7] = (channel >> 8);
+			buffer[6] = destination;
+			buffer[7] = source;
 
-			buffer[8] = value & 0xff;
-			buffer[9] = (value >> 8);
+			buffer[8] = channel & 0xff;
+			buffer[9] = (channel >> 8);
+
+			buffer[10] = value & 0xff;
+			buffer[11] = (value >> 8);
 
 			return std::unique_ptr<const uint8_t[]>(buffer);
 		}
@@ -248,8 +266,8 @@ namespace osshs
 		PwmUpdateChannelEvent::PwmUpdateChannelEvent(std::unique_ptr<const uint8_t[]> data, EventCallback callback)
 			: EventRegistrar<PwmUpdateChannelEvent>(data[4] | (data[5] << 8), callback)
 		{
-			channel = data[6] | (data[7] << 8);
-			value = data[8] | (data[9] << 8);
+			channel = data[8] | (data[9] << 8);
+			value = data[10] | (data[11] << 8);
 		}
 
 		uint16_t
@@ -284,11 +302,14 @@ namespace osshs
 			buffer[4] = causeId & 0xff;
 			buffer[5] = (causeId >> 8);
 
-			buffer[6] = channel & 0xff;
-			buffer[7] = (channel >> 8);
+			buffer[6] = destination;
+			buffer[7] = source;
+
+			buffer[8] = channel & 0xff;
+			buffer[9] = (channel >> 8);
 
-			buffer[8] = value & 0xff;
-			buffer[9] = (value >> 8);
+			buffer[10] = value & 0xff;
+			buffer[11] = (value >> 8);
 
 			return std::unique_ptr<const uint8_t[]>(buffer);
 		}
@@ -297,7 +318,7 @@ namespace osshs
 		PwmRequestRgbwChannelEvent::PwmRequestRgbwChannelEvent(std::unique_ptr<const uint8_t[]> data, EventCallback callback)
 			: EventRegistrar<PwmRequestRgbwChannelEvent>(data[4] | (data[5] << 8), callback)
 		{
-			channel = data[6] | (data[7] << 8);
+			channel = data[8] | (data[9] << 8);
 		}
 
 		uint16_t
@@ -326,8 +347,11 @@ namespace osshs
 			buffer[4] = causeId & 0xff;
 			buffer[5] = (causeId >> 8);
 
-			buffer[6] = channel & 0xff;
-			buffer[7] = (channel >> 8);
+			buffer[6] = destination;
+			buffer[7] = source;
+
+			buffer[8] = channel & 0xff;
+			buffer[9] = (channel >> 8);
 
 			return std::unique_ptr<const uint8_t[]>(buffer);
 		}
@@ -336,11 +360,11 @@ namespace osshs
 		PwmRgbwChannelReadyEvent::PwmRgbwChannelReadyEvent(std::unique_ptr<const uint8_t[]> data, EventCallback callback)
 			: EventRegistrar<PwmRgbwChannelReadyEvent>(data[4] | (data[5] << 8), callback)
 		{
-			channel = data[6] | (data[7] << 8);
-			value.red = data[8] | (data[9] << 8);
-			value.green = data[10] | (data[11] << 8);
-			value.blue = data[12] | (data[13] << 8);
-			value.white = data[14] | (data[15] << 8);
+			channel = data[8] | (data[9] << 8);
+			value.red = data[10] | (data[11] << 8);
+			value.green = data[12] | (data[13] << 8);
+			value.blue = data[14] | (data[15] << 8);
+			value.white = data[16] | (data[17] << 8);
 		}
 
 		uint16_t
@@ -375,20 +399,23 @@ namespace osshs
 			buffer[4] = causeId & 0xff;
 			buffer[5] = (causeId >> 8);
 
-			buffer[6] = channel & 0xff;
-			buffer[7] = (channel >> 8);
+			buffer[6] = destination;
+			buffer[7] = source;
 
-			buffer[8] = value.red & 0xff;
-			buffer[9] = (value.red >> 8);
+			buffer[8] = channel & 0xff;
+			buffer[9] = (channel >> 8);
 
-			buffer[10] = value.green & 0xff;
-			buffer[11] = (value.green >> 8);
+			buffer[10] = value.red & 0xff;
+			buffer[11] = (value.red >> 8);
 
-			buffer[12] = value.blue & 0xff;
-			buffer[13] = (value.blue >> 8);
+			buffer[12] = value.green & 0xff;
+			buffer[13] = (value.green >> 8);
 
-			buffer[14] = value.white & 0xff;
-			buffer[15] = (value.white >> 8);
+			buffer[14] = value.blue & 0xff;
+			buffer[15] = (value.blue >> 8);
+
+			buffer[16] = value.white & 0xff;
+			buffer[17] = (value.white >> 8);
 
 			return std::unique_ptr<const uint8_t[]>(buffer);
 		}
@@ -397,11 +424,11 @@ namespace osshs
 		PwmUpdateRgbwChannelEvent::PwmUpdateRgbwChannelEvent(std::unique_ptr<const uint8_t[]> data, EventCallback callback)
 			: EventRegistrar<PwmUpdateRgbwChannelEvent>(data[4] | (data[5] << 8), callback)
 		{
-			channel = data[6] | (data[7] << 8);
-			value.red = data[8] | (data[9] << 8);
-			value.green = data[10] | (data[11] << 8);
-			value.blue = data[12] | (data[13] << 8);
-			value.white = data[14] | (data[15] << 8);
+			channel = data[8] | (data[9] << 8);
+			value.red = data[10] | (data[11] << 8);
+			value.green = data[12] | (data[13] << 8);
+			value.blue = data[14] | (data[15] << 8);
+			value.white = data[16] | (data[17] << 8);
 		}
 
 		uint16_t
@@ -436,20 +463,115 @@ namespace osshs
 			buffer[4] = causeId & 0xff;
 			buffer[5] = (causeId >> 8);
 
-			buffer[6] = channel & 0xff;
-			buffer[7] = (channel >> 8);
+			buffer[6] = destination;
+			buffer[7] = source;
+
+			buffer[8] = channel & 0xff;
+			buffer[9] = (channel >> 8);
 
-			buffer[8] = value.red & 0xff;
-			buffer[9] = (value.red >> 8);
+			buffer[10] = value.red & 0xff;
+			buffer[11] = (value.red >> 8);
 
-			buffer[10] = value.green & 0xff;
-			buffer[11] = (value.green >> 8);
+			buffer[12] = value.green & 0xff;
+			buffer[13] = (value.green >> 8);
 
-			buffer[12] = value.blue & 0xff;
-			buffer[13] = (value.blue >> 8);
+			buffer[14] = value.blue & 0xff;
+			buffer[15] = (value.blue >> 8);
 
-			buffer[14] = value.white & 0xff;
-			buffer[15] = (value.white >> 8);
+			buffer[16] = value.white & 0xff;
+			buffer[17] = (value.white >> 8);
+
+			return std::unique_ptr<const uint8_t[]>(buffer);
+		}
+
+
+		PwmStoreSceneEvent::PwmStoreSceneEvent(std::unique_ptr<const uint8_t[]> data, EventCallback callback)
+			: EventRegistrar<PwmStoreSceneEvent>(data[4] | (data[5] << 8), callback)
+		{
+			scene = data[8];
+			fadeTime = data[9] | (data[10] << 8);
+		}
+
+		uint8_t
+		PwmStoreSceneEvent::getScene() const
+		{
+			return scene;
+		}
+
+		uint16_t
+		PwmStoreSceneEvent::getFadeTime() const
+		{
+			return fadeTime;
+		}
+
+		std::unique_ptr<const uint8_t[]>
+		PwmStoreSceneEvent::serialize() const
+		{
+			uint8_t *buffer = new (std::nothrow) uint8_t[EVENT_LENGTH];
+
+			if (buffer == nullptr)
+			{
+				OSSHS_LOG_ERROR("Failed to allocate memory for a buffer(bufferLength = %u).", EVENT_LENGTH);
+				return std::unique_ptr<const uint8_t[]>();
+			}
+
+			buffer[0] = EVENT_LENGTH & 0xff;
+			buffer[1] = (EVENT_LENGTH >> 8);
+
+			buffer[2] = TYPE & 0xff;
+			buffer[3] = (TYPE >> 8);
+
+			buffer[4] = causeId & 0xff;
+			buffer[5] = (causeId >> 8);
+
+			buffer[6] = destination;
+			buffer[7] = source;
+
+			buffer[8] = scene;
+
+			buffer[9] = fadeTime & 0xff;
+			buffer[10] = (fadeTime >> 8);
+
+			return std::unique_ptr<const uint8_t[]>(buffer);
+		}
+
+
+		PwmRecallSceneEvent::PwmRecallSceneEvent(std::unique_ptr<const uint8_t[]> data, EventCallback callback)
+			: EventRegistrar<PwmRecallSceneEvent>(data[4] | (data[5] << 8), callback)
+		{
+			scene = data[8];
+		}
+
+		uint8_t
+		PwmRecallSceneEvent::getScene() const
+		{
+			return scene;
+		}
+
+		std::unique_ptr<const uint8_t[]>
+		PwmRecallSceneEvent::serialize() const
+		{
+			uint8_t *buffer = new (std::nothrow) uint8_t[EVENT_LENGTH];
+
+			if (buffer == nullptr)
+			{
+				OSSHS_LOG_ERROR("Failed to allocate memory for a buffer(bufferLength = %u).", EVENT_LENGTH);
+				return std::unique_ptr<const uint8_t[]>();
+			}
+
+			buffer[0] = EVENT_LENGTH & 0xff;
+			buffer[1] = (EVENT_LENGTH >> 8);
+
+			buffer[2] = TYPE & 0xff;
+			buffer[3] = (TYPE >> 8);
+
+			buffer[4] = causeId & 0xff;
+			buffer[5] = (causeId >> 8);
+
+			buffer[6] = destination;
+			buffer[7] = source;
+
+			buffer[8] = scene;
 
 			return std::unique_ptr<const uint8_t[]>(buffer);
 		}
@@ -481,6 +603,9 @@ namespace osshs
 			buffer[4] = causeId & 0xff;
 			buffer[5] = (causeId >> 8);
 
+			buffer[6] = destination;
+			buffer[7] = source;
+
 			return std::unique_ptr<const uint8_t[]>(buffer);
 		}
 
@@ -488,7 +613,7 @@ namespace osshs
 		PwmErrorEvent::PwmErrorEvent(std::unique_ptr<const uint8_t[]> data, EventCallback callback)
 			: EventRegistrar<PwmErrorEvent>(data[4] | (data[5] << 8), callback)
 		{
-			error = static_cast<PwmError>(data[6]);
+			error = static_cast<PwmError>(data[8]);
 		}
 
 		PwmError
@@ -517,7 +642,10 @@ namespace osshs
 			buffer[4] = causeId & 0xff;
 			buffer[5] = (causeId >> 8);
 
-			buffer[6] = static_cast<uint8_t>(error);
+			buffer[6] = destination;
+			buffer[7] = source;
+
+			buffer[8] = static_cast<uint8_t>(error);
 
 			return std::unique_ptr<const uint8_t[]>(buffer);
 		}
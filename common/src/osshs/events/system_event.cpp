@@ -0,0 +1,72 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2019 Linas Nikiperavicius
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <osshs/events/system_event.hpp>
+#include <osshs/log/logger.hpp>
+
+namespace osshs
+{
+	namespace events
+	{
+		SystemErrorEvent::SystemErrorEvent(std::unique_ptr<const uint8_t[]> data, EventCallback callback)
+			: EventRegistrar<SystemErrorEvent>(data[4] | (data[5] << 8), callback)
+		{
+			error = static_cast<SystemError>(data[8]);
+		}
+
+		SystemError
+		SystemErrorEvent::getError() const
+		{
+			return error;
+		}
+
+		std::unique_ptr<const uint8_t[]>
+		SystemErrorEvent::serialize() const
+		{
+			uint8_t *buffer = new (std::nothrow) uint8_t[EVENT_LENGTH];
+
+			if (buffer == nullptr)
+			{
+				OSSHS_LOG_ERROR("Failed to allocate memory for a buffer(bufferLength = %u).", EVENT_LENGTH);
+				return std::unique_ptr<const uint8_t[]>();
+			}
+
+			buffer[0] = EVENT_LENGTH & 0xff;
+			buffer[1] = (EVENT_LENGTH >> 8);
+
+			buffer[2] = TYPE & 0xff;
+			buffer[3] = (TYPE >> 8);
+
+			buffer[4] = causeId & 0xff;
+			buffer[5] = (causeId >> 8);
+
+			buffer[6] = destination;
+			buffer[7] = source;
+
+			buffer[8] = static_cast<uint8_t>(error);
+
+			return std::unique_ptr<const uint8_t[]>(buffer);
+		}
+	}
+}
@@ -0,0 +1,86 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2019 Linas Nikiperavicius
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <modm/platform.hpp>
+#include <osshs/flash/stm32f1_flash.hpp>
+
+namespace osshs
+{
+	namespace flash
+	{
+		void
+		Stm32f1Flash::unlock()
+		{
+			if (FLASH->CR & FLASH_CR_LOCK)
+			{
+				FLASH->KEYR = KEY1;
+				FLASH->KEYR = KEY2;
+			}
+		}
+
+		void
+		Stm32f1Flash::lock()
+		{
+			FLASH->CR |= FLASH_CR_LOCK;
+		}
+
+		void
+		Stm32f1Flash::startErase(uint32_t address)
+		{
+			FLASH->CR |= FLASH_CR_PER;
+			FLASH->AR = address;
+			FLASH->CR |= FLASH_CR_STRT;
+		}
+
+		void
+		Stm32f1Flash::startProgram(uint32_t address, uint16_t value)
+		{
+			FLASH->CR |= FLASH_CR_PG;
+			*reinterpret_cast<volatile uint16_t *>(static_cast<uintptr_t>(address)) = value;
+		}
+
+		bool
+		Stm32f1Flash::isBusy()
+		{
+			return FLASH->SR & FLASH_SR_BSY;
+		}
+
+		bool
+		Stm32f1Flash::finish()
+		{
+			bool success = !(FLASH->SR & (FLASH_SR_PGERR | FLASH_SR_WRPRTERR));
+
+			FLASH->SR = FLASH_SR_EOP | FLASH_SR_PGERR | FLASH_SR_WRPRTERR;
+			FLASH->CR &= ~(FLASH_CR_PER | FLASH_CR_PG);
+
+			return success;
+		}
+
+		const uint8_t *
+		Stm32f1Flash::getData(uint32_t address)
+		{
+			return reinterpret_cast<const uint8_t *>(static_cast<uintptr_t>(address));
+		}
+	}
+}
@@ -0,0 +1,91 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2019 Linas Nikiperavicius
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <atomic>
+#include <osshs/log/log_buffer.hpp>
+
+namespace osshs
+{
+	namespace log
+	{
+		LogBuffer::LogBuffer()
+			: head(0), tail(0)
+		{
+		}
+
+		bool
+		LogBuffer::write(const uint8_t *data, std::size_t length)
+		{
+			if (length > getFree())
+				return false;
+
+			std::size_t head = this->head;
+
+			for (std::size_t i = 0; i < length; i++)
+			{
+				this->data[head] = data[i];
+				head = (head + 1) % SIZE;
+			}
+
+			// Data must be in place before the consumer can see the new head.
+			std::atomic_signal_fence(std::memory_order_release);
+			this->head = head;
+
+			return true;
+		}
+
+		std::size_t
+		LogBuffer::peek(const uint8_t *&data) const
+		{
+			std::size_t head = this->head;
+			std::size_t tail = this->tail;
+
+			data = &this->data[tail];
+
+			return (head >= tail) ? head - tail : SIZE - tail;
+		}
+
+		void
+		LogBuffer::consume(std::size_t length)
+		{
+			tail = (tail + length) % SIZE;
+		}
+
+		std::size_t
+		LogBuffer::getFree() const
+		{
+			std::size_t head = this->head;
+			std::size_t tail = this->tail;
+
+			// One byte is kept free to tell a full buffer from an empty one.
+			return (tail > head) ? tail - head - 1 : SIZE - (head - tail) - 1;
+		}
+
+		bool
+		LogBuffer::isEmpty() const
+		{
+			return head == tail;
+		}
+	}
+}
@@ -0,0 +1,83 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2019 Linas Nikiperavicius
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <osshs/log/log_line.hpp>
+
+namespace osshs
+{
+	namespace log
+	{
+		LogLine::LogLine()
+			: length(0)
+		{
+		}
+
+		void
+		LogLine::write(char c)
+		{
+			if (length < LENGTH)
+				data[length++] = static_cast<uint8_t>(c);
+		}
+
+		void
+		LogLine::flush()
+		{
+		}
+
+		bool
+		LogLine::read(char &c)
+		{
+			static_cast<void>(c);
+			return false;
+		}
+
+		void
+		LogLine::clear()
+		{
+			length = 0;
+		}
+
+		void
+		LogLine::terminate()
+		{
+			if (length > LENGTH - 2)
+				length = LENGTH - 2;
+
+			data[length++] = '\r';
+			data[length++] = '\n';
+		}
+
+		const uint8_t *
+		LogLine::getData() const
+		{
+			return data;
+		}
+
+		std::size_t
+		LogLine::getLength() const
+		{
+			return length;
+		}
+	}
+}
@@ -23,6 +23,7 @@
  */
 
 #include <osshs/log/logger.hpp>
+#include <osshs/time.hpp>
 
 #ifndef DISABLE_LOGGING
 	namespace osshs
@@ -30,17 +31,112 @@
 		namespace log
 		{
 			Level Logger::level = Level::DEBUG;
+			LogBuffer Logger::buffer;
+			LogLine Logger::message;
+			modm::IOStream Logger::stream(Logger::message);
+			uint32_t Logger::dropped = 0;
+			uint32_t Logger::droppedTotal = 0;
 
 			void
 			Logger::setLevel(Level level)
 			{
 				Logger::level = level;
 			}
-			
+
+			Level
+			Logger::getLevel()
+			{
+				return level;
+			}
+
+			void
+			Logger::update()
+			{
+				logDrain.update(buffer);
+			}
+
 			void
 			Logger::flush()
 			{
-				logger.flush();
+				logDrain.flush(buffer);
+			}
+
+			uint32_t
+			Logger::getDroppedTotal()
+			{
+				return droppedTotal;
+			}
+
+			std::size_t
+			Logger::getFree()
+			{
+				return buffer.getFree();
+			}
+
+			void
+			Logger::commit(const uint8_t *data, std::size_t length)
+			{
+				if (dropped > 0)
+				{
+					#ifdef ENABLE_TOKENIZED_LOGGING
+						uint8_t marker[RECORD_HEADER_LENGTH + sizeof(uint32_t)];
+						uint32_t timestamp = Time::getSystemTime<uint32_t, Time::Precision::Milliseconds>();
+
+						marker[0] = RECORD_MAGIC;
+						marker[1] = sizeof(marker) - 2;
+
+						marker[2] = DROPPED_TOKEN & 0xff;
+						marker[3] = (DROPPED_TOKEN >> 8) & 0xff;
+						marker[4] = (DROPPED_TOKEN >> 16) & 0xff;
+						marker[5] = (DROPPED_TOKEN >> 24) & 0xff;
+
+						marker[6] = timestamp & 0xff;
+						marker[7] = (timestamp >> 8);
+						marker[8] = (timestamp >> 16);
+						marker[9] = (timestamp >> 24);
+
+						marker[10] = static_cast<uint8_t>(Level::WARNING);
+
+						marker[11] = dropped & 0xff;
+						marker[12] = (dropped >> 8);
+						marker[13] = (dropped >> 16);
+						marker[14] = (dropped >> 24);
+
+						bool written = buffer.write(marker, sizeof(marker));
+					#else  // ENABLE_TOKENIZED_LOGGING
+						// The message has already been formatted into the line buffer, so the marker is built by hand.
+						uint8_t marker[32] = "[dropped ";
+						std::size_t offset = 9;
+						char digits[10];
+						std::size_t count = 0;
+
+						for (uint32_t value = dropped; value > 0 || count == 0; value /= 10)
+							digits[count++] = '0' + value % 10;
+
+						while (count > 0)
+							marker[offset++] = digits[--count];
+
+						for (const char *suffix = " messages]\r\n"; *suffix != '\0'; suffix++)
+							marker[offset++] = *suffix;
+
+						bool written = buffer.write(marker, offset);
+					#endif  // ENABLE_TOKENIZED_LOGGING
+
+					if (!written)
+					{
+						dropped++;
+						droppedTotal++;
+						return;
+					}
+
+					dropped = 0;
+				}
+
+				if (!buffer.write(data, length))
+				{
+					dropped++;
+					droppedTotal++;
+				}
 			}
 		}
 	}
@@ -0,0 +1,98 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2019 Linas Nikiperavicius
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <modm/platform.hpp>
+#include <osshs/log/usart1_dma_log_drain.hpp>
+
+namespace osshs
+{
+	namespace log
+	{
+		Usart1DmaLogDrain::Usart1DmaLogDrain()
+			: buffer(nullptr), transferLength(0), initialized(false)
+		{
+		}
+
+		void
+		Usart1DmaLogDrain::update(LogBuffer &buffer)
+		{
+			// USART1 is set up by the application, so DMA is only attached on first use.
+			if (!initialized)
+			{
+				this->buffer = &buffer;
+				initialize();
+			}
+
+			if (transferLength == 0)
+			{
+				modm::atomic::Lock lock;
+				startTransfer();
+			}
+		}
+
+		void
+		Usart1DmaLogDrain::handleInterrupt()
+		{
+			DMA1->IFCR = DMA_IFCR_CGIF4;
+			DMA1_Channel4->CCR &= ~DMA_CCR_EN;
+
+			buffer->consume(transferLength);
+			transferLength = 0;
+
+			startTransfer();
+		}
+
+		void
+		Usart1DmaLogDrain::initialize()
+		{
+			RCC->AHBENR |= RCC_AHBENR_DMA1EN;
+
+			DMA1_Channel4->CCR = 0;
+			DMA1_Channel4->CPAR = static_cast<uint32_t>(reinterpret_cast<uintptr_t>(&USART1->DR));
+			DMA1_Channel4->CCR = DMA_CCR_MINC | DMA_CCR_DIR | DMA_CCR_TCIE;
+
+			USART1->CR3 |= USART_CR3_DMAT;
+
+			NVIC_EnableIRQ(DMA1_Channel4_IRQn);
+
+			initialized = true;
+		}
+
+		void
+		Usart1DmaLogDrain::startTransfer()
+		{
+			const uint8_t *data;
+			std::size_t length = buffer->peek(data);
+
+			if (length == 0)
+				return;
+
+			transferLength = length;
+
+			DMA1_Channel4->CMAR = static_cast<uint32_t>(reinterpret_cast<uintptr_t>(data));
+			DMA1_Channel4->CNDTR = length;
+			DMA1_Channel4->CCR |= DMA_CCR_EN;
+		}
+	}
+}
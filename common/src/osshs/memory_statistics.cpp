@@ -0,0 +1,219 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2019 Linas Nikiperavicius
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <osshs/memory_statistics.hpp>
+
+#ifdef ENABLE_MEMORY_STATISTICS
+	#include <cstdlib>
+	#include <malloc.h>
+	#include <unistd.h>
+	#include <modm/platform.hpp>
+
+	extern "C"
+	{
+		// Provided by the modm linker script.
+		extern uint32_t __stack_start[];
+		extern uint32_t __stack_end[];
+
+		// End of the region _sbrk() hands out, provided by the modm newlib heap.
+		extern uint8_t *heap_end;
+
+		// Chunk layout and free list of the newlib-nano allocator (nano-mallocr.c).
+		struct malloc_chunk
+		{
+			long size;
+			struct malloc_chunk *next;
+		};
+
+		extern struct malloc_chunk *__malloc_free_list;
+
+		void *
+		__real_malloc(std::size_t size);
+
+		void
+		__real_free(void *pointer);
+
+		void *
+		__real_realloc(void *pointer, std::size_t size);
+
+		void *
+		__real_calloc(std::size_t count, std::size_t size);
+
+		void *
+		__wrap_malloc(std::size_t size)
+		{
+			void *pointer = __real_malloc(size);
+			osshs::MemoryStatistics::recordAllocation((pointer != nullptr) ? malloc_usable_size(pointer) : 0);
+
+			return pointer;
+		}
+
+		void
+		__wrap_free(void *pointer)
+		{
+			if (pointer != nullptr)
+				osshs::MemoryStatistics::recordRelease(malloc_usable_size(pointer));
+
+			__real_free(pointer);
+		}
+
+		void *
+		__wrap_realloc(void *pointer, std::size_t size)
+		{
+			std::size_t previousSize = (pointer != nullptr) ? malloc_usable_size(pointer) : 0;
+			void *newPointer = __real_realloc(pointer, size);
+
+			// On failure the original block is left untouched.
+			if (newPointer != nullptr || size == 0)
+			{
+				if (pointer != nullptr)
+					osshs::MemoryStatistics::recordRelease(previousSize);
+
+				if (newPointer != nullptr)
+					osshs::MemoryStatistics::recordAllocation(malloc_usable_size(newPointer));
+			}
+			else
+			{
+				osshs::MemoryStatistics::recordAllocation(0);
+			}
+
+			return newPointer;
+		}
+
+		void *
+		__wrap_calloc(std::size_t count, std::size_t size)
+		{
+			void *pointer = __real_calloc(count, size);
+			osshs::MemoryStatistics::recordAllocation((pointer != nullptr) ? malloc_usable_size(pointer) : 0);
+
+			return pointer;
+		}
+	}
+
+	namespace osshs
+	{
+		uint32_t MemoryStatistics::liveBytes = 0;
+		uint32_t MemoryStatistics::peakBytes = 0;
+		uint32_t MemoryStatistics::allocations = 0;
+		uint32_t MemoryStatistics::failedAllocations = 0;
+
+		void
+		MemoryStatistics::initialize()
+		{
+			// Leave some room below the current frame for this function itself.
+			uint32_t *end = static_cast<uint32_t*>(__builtin_frame_address(0)) - 16;
+
+			for (volatile uint32_t *word = __stack_start; word < end; word++)
+				*word = STACK_PATTERN;
+		}
+
+		void
+		MemoryStatistics::recordAllocation(std::size_t size)
+		{
+			modm::atomic::Lock lock;
+
+			if (size == 0)
+			{
+				failedAllocations++;
+				return;
+			}
+
+			allocations++;
+			liveBytes += size;
+
+			if (liveBytes > peakBytes)
+				peakBytes = liveBytes;
+		}
+
+		void
+		MemoryStatistics::recordRelease(std::size_t size)
+		{
+			modm::atomic::Lock lock;
+
+			// Blocks allocated inside the C library are not seen by the wrappers.
+			liveBytes = (size < liveBytes) ? liveBytes - size : 0;
+		}
+
+		events::DiagnosticsMemoryStatistics
+		MemoryStatistics::getStatistics()
+		{
+			events::DiagnosticsMemoryStatistics statistics;
+
+			{
+				modm::atomic::Lock lock;
+
+				statistics.liveBytes = liveBytes;
+				statistics.peakBytes = peakBytes;
+				statistics.allocations = allocations;
+				statistics.failedAllocations = failedAllocations;
+			}
+
+			statistics.largestFreeBlock = getLargestFreeBlock();
+			statistics.stackHighWaterMark = getStackHighWaterMark();
+			statistics.stackSize = (__stack_end - __stack_start) * sizeof(uint32_t);
+
+			return statistics;
+		}
+
+		uint32_t
+		MemoryStatistics::getLargestFreeBlock()
+		{
+			// Walk the free list instead of probing with allocations, which would
+			// disturb the heap that is being measured. A malloc larger than any free
+			// chunk is served from the top of the heap, where it can grow a free chunk
+			// that ends at the current break.
+			static constexpr uint32_t CHUNK_OFFSET = sizeof(long);
+
+			modm::atomic::Lock lock;
+
+			const uint8_t *brk = static_cast<const uint8_t*>(sbrk(0));
+			uint32_t headroom = (brk < heap_end) ? (heap_end - brk) & ~(sizeof(long) - 1) : 0;
+			uint32_t largest = headroom;
+
+			for (const malloc_chunk *chunk = __malloc_free_list; chunk != nullptr; chunk = chunk->next)
+			{
+				uint32_t size = chunk->size;
+
+				if (reinterpret_cast<const uint8_t*>(chunk) + size == brk)
+					size += headroom;
+
+				if (size > largest)
+					largest = size;
+			}
+
+			return (largest > CHUNK_OFFSET) ? largest - CHUNK_OFFSET : 0;
+		}
+
+		uint32_t
+		MemoryStatistics::getStackHighWaterMark()
+		{
+			const volatile uint32_t *word = __stack_start;
+
+			while (word < __stack_end && *word == STACK_PATTERN)
+				word++;
+
+			return (__stack_end - word) * sizeof(uint32_t);
+		}
+	}
+#endif  // ENABLE_MEMORY_STATISTICS
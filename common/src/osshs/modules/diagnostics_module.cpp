@@ -0,0 +1,395 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2019 Linas Nikiperavicius
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <osshs/modules/diagnostics_module.hpp>
+#include <osshs/modules/module_manager.hpp>
+#include <osshs/memory_statistics.hpp>
+#include <osshs/resource_lock_statistics.hpp>
+#include <osshs/trace_recorder.hpp>
+#include <osshs/system.hpp>
+#include <osshs/log/logger.hpp>
+
+namespace osshs
+{
+	namespace modules
+	{
+		DiagnosticsModule::DiagnosticsModule()
+		{
+			OSSHS_LOG_INFO("Initializing diagnostics module.");
+		}
+
+		uint8_t
+		DiagnosticsModule::getModuleTypeId() const
+		{
+			return static_cast<uint8_t>(static_cast<uint16_t> (events::DiagnosticsEvent::BASE) >> 8);
+		}
+
+		bool
+		DiagnosticsModule::run()
+		{
+			PT_BEGIN();
+
+			do
+			{
+				PT_WAIT_WHILE(eventQueue.empty());
+
+				currentEvent = eventQueue.front();
+				eventQueue.pop();
+
+				OSSHS_TRACE(DEQUEUED, currentEvent);
+				metrics.recordEvent(currentEvent->getType());
+
+				PT_CALL(dispatchEvent(currentEvent));
+
+				metrics.recordHandled();
+				currentEvent.reset();
+			}
+			while (true);
+
+			PT_END();
+		}
+
+		modm::ResumableResult<void>
+		DiagnosticsModule::handleRequestLockStatisticsEvent(std::shared_ptr<events::DiagnosticsRequestLockStatisticsEvent> event)
+		{
+			RF_BEGIN();
+
+			OSSHS_LOG_DEBUG("Handling diagnostics request lock statistics event(lock = 0x%02x).", event->getLock());
+
+			{
+				std::shared_ptr<events::Event> responseEvent;
+
+			#ifdef ENABLE_LOCK_STATISTICS
+				const ResourceLockStatistics *statistics = ResourceLockStatistics::get(event->getLock());
+
+				if (statistics != nullptr)
+				{
+					events::DiagnosticsLockStatisticsReadyEvent *successEvent = new (std::nothrow) events::DiagnosticsLockStatisticsReadyEvent(
+						event->getLock(),
+						ResourceLockStatistics::getLockCount(),
+						statistics->getStatistics(),
+						event->getCauseId(),
+						[=](std::shared_ptr<osshs::events::Event> event) -> void
+						{
+							this->handleEvent(event);
+						}
+					);
+
+					if (successEvent == nullptr)
+					{
+						OSSHS_LOG_ERROR("Failed to allocate memory for a diagnostics lock statistics ready event.");
+						metrics.recordError();
+						RF_RETURN();
+					}
+
+					responseEvent.reset(static_cast<events::Event*> (successEvent));
+				}
+				else
+				{
+					metrics.recordError();
+
+					events::DiagnosticsErrorEvent *errorEvent = new (std::nothrow) events::DiagnosticsErrorEvent(
+						events::DiagnosticsError::LOCK_OUT_OF_BOUNDS,
+						event->getCauseId(),
+						[=](std::shared_ptr<osshs::events::Event> event) -> void
+						{
+							this->handleEvent(event);
+						}
+					);
+
+					if (errorEvent == nullptr)
+					{
+						OSSHS_LOG_ERROR("Failed to allocate memory for a diagnostics error event.");
+						RF_RETURN();
+					}
+
+					responseEvent.reset(static_cast<events::Event*> (errorEvent));
+				}
+			#else  // ENABLE_LOCK_STATISTICS
+				metrics.recordError();
+
+				responseEvent.reset(static_cast<events::Event*> (new (std::nothrow) events::DiagnosticsErrorEvent(
+					events::DiagnosticsError::STATISTICS_DISABLED,
+					event->getCauseId(),
+					[=](std::shared_ptr<osshs::events::Event> event) -> void
+					{
+						this->handleEvent(event);
+					}
+				)));
+
+				if (responseEvent == nullptr)
+				{
+					OSSHS_LOG_ERROR("Failed to allocate memory for a diagnostics error event.");
+					RF_RETURN();
+				}
+			#endif  // ENABLE_LOCK_STATISTICS
+
+				responseEvent->setDestination(event->getSource());
+				OSSHS_TRACE(RESPONDED, responseEvent);
+
+				if (event->getCallback() != nullptr)
+				{
+					event->getCallback()(responseEvent);
+				}
+				else
+				{
+					System::reportEvent(responseEvent);
+				}
+			}
+
+			RF_END();
+		}
+
+		modm::ResumableResult<void>
+		DiagnosticsModule::handleRequestTraceEvent(std::shared_ptr<events::DiagnosticsRequestTraceEvent> event)
+		{
+			RF_BEGIN();
+
+			OSSHS_LOG_DEBUG("Handling diagnostics request trace event(index = 0x%04x).", event->getIndex());
+
+			{
+				std::shared_ptr<events::Event> responseEvent;
+
+			#ifdef ENABLE_TRACE
+				events::DiagnosticsTraceRecord records[events::DiagnosticsTraceReadyEvent::MAX_RECORDS];
+				uint8_t length = 0;
+
+				if (event->getTarget() == events::DiagnosticsTraceTarget::LOG)
+				{
+					TraceRecorder::dump();
+				}
+				else
+				{
+					// Reading out starts at index 0 and ends with the last record. Recording is
+					// paused in between, so indices stay valid and the read out is not traced itself.
+					// Every page extends the pause, an abandoned read out resumes after READOUT_TIMEOUT.
+					TraceRecorder::pause(TraceRecorder::READOUT_TIMEOUT);
+
+					while (length < events::DiagnosticsTraceReadyEvent::MAX_RECORDS && event->getIndex() + length < TraceRecorder::getRecordCount())
+					{
+						records[length] = TraceRecorder::getRecord(event->getIndex() + length);
+						length++;
+					}
+
+					if (event->getIndex() + length >= TraceRecorder::getRecordCount())
+						TraceRecorder::resume();
+				}
+
+				responseEvent.reset(static_cast<events::Event*> (new (std::nothrow) events::DiagnosticsTraceReadyEvent(
+					event->getIndex(),
+					TraceRecorder::getRecordCount(),
+					length,
+					records,
+					event->getCauseId(),
+					[=](std::shared_ptr<osshs::events::Event> event) -> void
+					{
+						this->handleEvent(event);
+					}
+				)));
+
+				if (responseEvent == nullptr)
+				{
+					OSSHS_LOG_ERROR("Failed to allocate memory for a diagnostics trace ready event.");
+					metrics.recordError();
+					RF_RETURN();
+				}
+			#else  // ENABLE_TRACE
+				metrics.recordError();
+
+				responseEvent.reset(static_cast<events::Event*> (new (std::nothrow) events::DiagnosticsErrorEvent(
+					events::DiagnosticsError::TRACE_DISABLED,
+					event->getCauseId(),
+					[=](std::shared_ptr<osshs::events::Event> event) -> void
+					{
+						this->handleEvent(event);
+					}
+				)));
+
+				if (responseEvent == nullptr)
+				{
+					OSSHS_LOG_ERROR("Failed to allocate memory for a diagnostics error event.");
+					RF_RETURN();
+				}
+			#endif  // ENABLE_TRACE
+
+				responseEvent->setDestination(event->getSource());
+				OSSHS_TRACE(RESPONDED, responseEvent);
+
+				if (event->getCallback() != nullptr)
+				{
+					event->getCallback()(responseEvent);
+				}
+				else
+				{
+					System::reportEvent(responseEvent);
+				}
+			}
+
+			RF_END();
+		}
+
+		modm::ResumableResult<void>
+		DiagnosticsModule::handleRequestModuleMetricsEvent(std::shared_ptr<events::DiagnosticsRequestModuleMetricsEvent> event)
+		{
+			RF_BEGIN();
+
+			OSSHS_LOG_DEBUG("Handling diagnostics request module metrics event(module = 0x%02x).", event->getModule());
+
+			{
+				std::shared_ptr<events::Event> responseEvent;
+				const Module *module = ModuleManager::getModule(event->getModule());
+
+				if (module != nullptr)
+				{
+					const ModuleMetrics &moduleMetrics = module->getMetrics();
+
+					events::DiagnosticsModuleMetricsReadyEvent *successEvent = new (std::nothrow) events::DiagnosticsModuleMetricsReadyEvent(
+						event->getModule(),
+						ModuleManager::getModuleCount(),
+						module->getModuleTypeId(),
+						moduleMetrics.getMetrics(),
+						event->getCauseId(),
+						[=](std::shared_ptr<osshs::events::Event> event) -> void
+						{
+							this->handleEvent(event);
+						}
+					);
+
+					if (successEvent == nullptr)
+					{
+						OSSHS_LOG_ERROR("Failed to allocate memory for a diagnostics module metrics ready event.");
+						metrics.recordError();
+						RF_RETURN();
+					}
+
+					for (uint8_t i = 0; i < moduleMetrics.getEventTypeCount(); i++)
+						successEvent->addEventCount(moduleMetrics.getEventCount(i));
+
+					responseEvent.reset(static_cast<events::Event*> (successEvent));
+				}
+				else
+				{
+					metrics.recordError();
+
+					events::DiagnosticsErrorEvent *errorEvent = new (std::nothrow) events::DiagnosticsErrorEvent(
+						events::DiagnosticsError::MODULE_OUT_OF_BOUNDS,
+						event->getCauseId(),
+						[=](std::shared_ptr<osshs::events::Event> event) -> void
+						{
+							this->handleEvent(event);
+						}
+					);
+
+					if (errorEvent == nullptr)
+					{
+						OSSHS_LOG_ERROR("Failed to allocate memory for a diagnostics error event.");
+						RF_RETURN();
+					}
+
+					responseEvent.reset(static_cast<events::Event*> (errorEvent));
+				}
+
+				responseEvent->setDestination(event->getSource());
+				OSSHS_TRACE(RESPONDED, responseEvent);
+
+				if (event->getCallback() != nullptr)
+				{
+					event->getCallback()(responseEvent);
+				}
+				else
+				{
+					System::reportEvent(responseEvent);
+				}
+			}
+
+			RF_END();
+		}
+
+		modm::ResumableResult<void>
+		DiagnosticsModule::handleRequestMemoryStatisticsEvent(std::shared_ptr<events::DiagnosticsRequestMemoryStatisticsEvent> event)
+		{
+			RF_BEGIN();
+
+			OSSHS_LOG_DEBUG("Handling diagnostics request memory statistics event.");
+
+			{
+				std::shared_ptr<events::Event> responseEvent;
+
+			#ifdef ENABLE_MEMORY_STATISTICS
+				events::DiagnosticsMemoryStatistics statistics = MemoryStatistics::getStatistics();
+
+				OSSHS_LOG_INFO("Memory statistics(liveBytes = %lu, peakBytes = %lu, allocations = %lu, largestFreeBlock = %lu, stackHighWaterMark = %lu).",
+					statistics.liveBytes, statistics.peakBytes, statistics.allocations, statistics.largestFreeBlock, statistics.stackHighWaterMark);
+
+				responseEvent.reset(static_cast<events::Event*> (new (std::nothrow) events::DiagnosticsMemoryStatisticsReadyEvent(
+					statistics,
+					event->getCauseId(),
+					[=](std::shared_ptr<osshs::events::Event> event) -> void
+					{
+						this->handleEvent(event);
+					}
+				)));
+
+				if (responseEvent == nullptr)
+				{
+					OSSHS_LOG_ERROR("Failed to allocate memory for a diagnostics memory statistics ready event.");
+					metrics.recordError();
+					RF_RETURN();
+				}
+			#else  // ENABLE_MEMORY_STATISTICS
+				metrics.recordError();
+
+				responseEvent.reset(static_cast<events::Event*> (new (std::nothrow) events::DiagnosticsErrorEvent(
+					events::DiagnosticsError::MEMORY_STATISTICS_DISABLED,
+					event->getCauseId(),
+					[=](std::shared_ptr<osshs::events::Event> event) -> void
+					{
+						this->handleEvent(event);
+					}
+				)));
+
+				if (responseEvent == nullptr)
+				{
+					OSSHS_LOG_ERROR("Failed to allocate memory for a diagnostics error event.");
+					RF_RETURN();
+				}
+			#endif  // ENABLE_MEMORY_STATISTICS
+
+				responseEvent->setDestination(event->getSource());
+				OSSHS_TRACE(RESPONDED, responseEvent);
+
+				if (event->getCallback() != nullptr)
+				{
+					event->getCallback()(responseEvent);
+				}
+				else
+				{
+					System::reportEvent(responseEvent);
+				}
+			}
+
+			RF_END();
+		}
+	}
+}
@@ -24,6 +24,8 @@
 
 #include <osshs/modules/module.hpp>
 #include <osshs/system.hpp>
+#include <osshs/trace_recorder.hpp>
+#include <osshs/events/system_event.hpp>
 #include <osshs/log/logger.hpp>
 
 namespace osshs
@@ -33,8 +35,6 @@ namespace osshs
 		void
 		Module::initialize()
 		{
-			OSSHS_LOG_INFO("Initializing module.");
-
 			System::subscribeEvent(events::EventSelector(0xff00, static_cast<uint16_t>(getModuleTypeId()) << 8),
 				[=](std::shared_ptr<events::Event> event) -> void
 				{
@@ -43,12 +43,54 @@ namespace osshs
 			);
 		}
 
+		const ModuleMetrics &
+		Module::getMetrics() const
+		{
+			return metrics;
+		}
+
 		void
 		Module::handleEvent(std::shared_ptr<events::Event> event)
 		{
 			OSSHS_LOG_DEBUG("Handling event(type = 0x%04x).", event->getType());
 
+			OSSHS_TRACE(QUEUED, event);
+
 			eventQueue.push(event);
+			metrics.recordQueueLength(eventQueue.size());
+		}
+
+		void
+		Module::reportUnsupportedEvent(const std::shared_ptr<events::Event> &event)
+		{
+			OSSHS_LOG_WARNING("Unsupported event(type = 0x%04x, source = 0x%02x).", event->getType(), event->getSource());
+			metrics.recordError();
+
+			if (event->getDestination() != System::getNodeId())
+				return;
+
+			std::shared_ptr<events::Event> errorEvent(static_cast<events::Event*> (new (std::nothrow) events::SystemErrorEvent(
+				events::SystemError::UNSUPPORTED_EVENT,
+				event->getCauseId()
+			)));
+
+			if (errorEvent == nullptr)
+			{
+				OSSHS_LOG_ERROR("Failed to allocate memory for a system error event.");
+				return;
+			}
+
+			errorEvent->setDestination(event->getSource());
+			OSSHS_TRACE(RESPONDED, errorEvent);
+
+			if (event->getCallback() != nullptr)
+			{
+				event->getCallback()(errorEvent);
+			}
+			else
+			{
+				System::reportEvent(errorEvent);
+			}
 		}
 	}
 }
@@ -23,7 +23,6 @@
  */
 
 #include <osshs/modules/module_manager.hpp>
-#include <osshs/log/logger.hpp>
 
 namespace osshs
 {
@@ -34,14 +33,11 @@ namespace osshs
 		void
 		ModuleManager::initialize()
 		{
-			OSSHS_LOG_INFO("Initializing module manager.");
 		}
 
 		void
 		ModuleManager::registerModule(modules::Module *module)
 		{
-			OSSHS_LOG_INFO("Registering module(type = 0x%02x).", module->getModuleTypeId());
-			
 			modules.push_back(module);
 			module->initialize();
 		}
@@ -54,5 +50,17 @@ namespace osshs
 				module->run();
 			}
 		}
+
+		uint8_t
+		ModuleManager::getModuleCount()
+		{
+			return modules.size();
+		}
+
+		const modules::Module *
+		ModuleManager::getModule(uint8_t module)
+		{
+			return (module < modules.size()) ? modules[module] : nullptr;
+		}
 	}
 }
@@ -0,0 +1,103 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2019 Linas Nikiperavicius
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <osshs/modules/module_metrics.hpp>
+#include <osshs/time.hpp>
+
+namespace osshs
+{
+	namespace modules
+	{
+		ModuleMetrics::ModuleMetrics()
+			: eventTypeCount(0), handleStartTime(0)
+		{
+		}
+
+		void
+		ModuleMetrics::recordEvent(uint16_t type)
+		{
+			metrics.eventsHandled++;
+			handleStartTime = Time::getSystemTime<uint32_t, Time::Precision::Microseconds>();
+
+			for (uint8_t i = 0; i < eventTypeCount; i++)
+			{
+				if (eventCounts[i].type == type)
+				{
+					eventCounts[i].count++;
+					return;
+				}
+			}
+
+			// Types beyond the table are only included in eventsHandled.
+			if (eventTypeCount < events::DiagnosticsModuleMetricsReadyEvent::MAX_EVENT_COUNTS)
+			{
+				eventCounts[eventTypeCount].type = type;
+				eventCounts[eventTypeCount].count = 1;
+				eventTypeCount++;
+			}
+		}
+
+		void
+		ModuleMetrics::recordHandled()
+		{
+			uint32_t handlerTime = Time::getSystemTime<uint32_t, Time::Precision::Microseconds>() - handleStartTime;
+
+			metrics.totalHandlerTime += handlerTime;
+
+			if (handlerTime > metrics.maxHandlerTime)
+				metrics.maxHandlerTime = handlerTime;
+		}
+
+		void
+		ModuleMetrics::recordError()
+		{
+			metrics.errors++;
+		}
+
+		void
+		ModuleMetrics::recordQueueLength(std::size_t length)
+		{
+			if (length > metrics.queueHighWaterMark)
+				metrics.queueHighWaterMark = (length < UINT16_MAX) ? length : UINT16_MAX;
+		}
+
+		events::DiagnosticsModuleMetrics
+		ModuleMetrics::getMetrics() const
+		{
+			return metrics;
+		}
+
+		uint8_t
+		ModuleMetrics::getEventTypeCount() const
+		{
+			return eventTypeCount;
+		}
+
+		events::DiagnosticsEventCount
+		ModuleMetrics::getEventCount(uint8_t index) const
+		{
+			return (index < eventTypeCount) ? eventCounts[index] : events::DiagnosticsEventCount();
+		}
+	}
+}
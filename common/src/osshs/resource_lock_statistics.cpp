@@ -0,0 +1,126 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2019 Linas Nikiperavicius
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <osshs/resource_lock_statistics.hpp>
+
+#ifdef ENABLE_LOCK_STATISTICS
+	#include <algorithm>
+	#include <cstring>
+
+	#include <osshs/crc32.hpp>
+	#include <osshs/time.hpp>
+	#include <osshs/events/diagnostics_event.hpp>
+
+	namespace osshs
+	{
+		ResourceLockStatistics::ResourceLockStatistics(const char *signature)
+			: id(0), acquisitions(0), failedTryLocks(0), maxHoldTime(0), totalHoldTime(0), maxWaitTime(0), acquireTime(0)
+		{
+			// GCC spells the signature "... [with Resource = modm::platform::SpiMaster1]".
+			const char *name = std::strstr(signature, "Resource = ");
+			name = (name != nullptr) ? name + std::strlen("Resource = ") : signature;
+			std::size_t length = std::strcspn(name, ";]");
+
+			id = Crc32::update(Crc32::INITIAL, reinterpret_cast<const uint8_t*>(name), length);
+
+			std::vector<const ResourceLockStatistics*> &locks = registry();
+			locks.insert(std::upper_bound(locks.begin(), locks.end(), this,
+				[](const ResourceLockStatistics *a, const ResourceLockStatistics *b) -> bool
+				{
+					return a->id < b->id;
+				}
+			), this);
+		}
+
+		uint32_t
+		ResourceLockStatistics::getId() const
+		{
+			return id;
+		}
+
+		void
+		ResourceLockStatistics::recordAcquisition(uint32_t waitTime)
+		{
+			acquisitions++;
+			acquireTime = Time::getSystemTime<uint32_t, Time::Precision::Microseconds>();
+
+			if (waitTime > maxWaitTime)
+				maxWaitTime = waitTime;
+		}
+
+		void
+		ResourceLockStatistics::recordFailedTryLock()
+		{
+			failedTryLocks++;
+		}
+
+		void
+		ResourceLockStatistics::recordRelease()
+		{
+			uint32_t holdTime = Time::getSystemTime<uint32_t, Time::Precision::Microseconds>() - acquireTime;
+
+			totalHoldTime += holdTime;
+
+			if (holdTime > maxHoldTime)
+				maxHoldTime = holdTime;
+		}
+
+		events::DiagnosticsLockStatistics
+		ResourceLockStatistics::getStatistics() const
+		{
+			events::DiagnosticsLockStatistics statistics;
+
+			statistics.lockId = id;
+			statistics.acquisitions = acquisitions;
+			statistics.failedTryLocks = failedTryLocks;
+			statistics.maxHoldTime = maxHoldTime;
+			statistics.averageHoldTime = (acquisitions > 0) ? static_cast<uint32_t>(totalHoldTime / acquisitions) : 0;
+			statistics.maxWaitTime = maxWaitTime;
+
+			return statistics;
+		}
+
+		uint8_t
+		ResourceLockStatistics::getLockCount()
+		{
+			return static_cast<uint8_t>(registry().size());
+		}
+
+		const ResourceLockStatistics *
+		ResourceLockStatistics::get(uint8_t lock)
+		{
+			if (lock >= registry().size())
+				return nullptr;
+
+			return registry()[lock];
+		}
+
+		std::vector<const ResourceLockStatistics*>&
+		ResourceLockStatistics::registry()
+		{
+			static std::vector<const ResourceLockStatistics*> locks;
+			return locks;
+		}
+	}
+#endif  // ENABLE_LOCK_STATISTICS
@@ -0,0 +1,238 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2019 Linas Nikiperavicius
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <osshs/rpc.hpp>
+#include <osshs/system.hpp>
+#include <osshs/events/system_event.hpp>
+#include <osshs/log/logger.hpp>
+
+namespace osshs
+{
+	Rpc::PendingRequest Rpc::pending[RPC_MAX_PENDING];
+	Rpc::QueuedRequest Rpc::queue[RPC_MAX_QUEUED];
+	uint8_t Rpc::queueHead = 0;
+	uint8_t Rpc::queueLength = 0;
+	uint8_t Rpc::pendingCount = 0;
+	uint8_t Rpc::concurrencyLimit = RPC_MAX_PENDING;
+
+	bool
+	Rpc::call(std::shared_ptr<events::Event> request, events::EventCallback callback, uint32_t timeout)
+	{
+		// A module answers through the request's own callback, which would bypass handleResponse().
+		if (request->getCallback() != nullptr)
+		{
+			OSSHS_LOG_WARNING("Rejecting request with an event callback(type = 0x%04x).", request->getType());
+			return false;
+		}
+
+		if (pendingCount >= concurrencyLimit)
+		{
+			OSSHS_LOG_DEBUG("Concurrency limit reached(type = 0x%04x, pendingCount = %u).", request->getType(), pendingCount);
+			return false;
+		}
+
+		if (find(request->getCauseId()) != nullptr)
+		{
+			OSSHS_LOG_WARNING("Request is already pending(causeId = 0x%04x).", request->getCauseId());
+			return false;
+		}
+
+		PendingRequest *slot = nullptr;
+
+		for (uint8_t i = 0; i < RPC_MAX_PENDING && slot == nullptr; i++)
+		{
+			PendingRequest &candidate = pending[(request->getCauseId() + i) % RPC_MAX_PENDING];
+
+			if (!candidate.active)
+				slot = &candidate;
+		}
+
+		slot->active = true;
+		slot->causeId = request->getCauseId();
+		slot->type = request->getType();
+		slot->destination = request->getDestination();
+		slot->callback = callback;
+		slot->timer.setCallback([slot]() -> void
+			{
+				Rpc::expire(slot);
+			}
+		);
+		slot->timer.start(timeout);
+		pendingCount++;
+
+		// The slot is taken before reporting, as a local module may answer synchronously.
+		System::reportEvent(request);
+
+		return true;
+	}
+
+	bool
+	Rpc::pipeline(std::shared_ptr<events::Event> request, events::EventCallback callback, uint32_t timeout)
+	{
+		if (request->getCallback() != nullptr)
+		{
+			OSSHS_LOG_WARNING("Rejecting request with an event callback(type = 0x%04x).", request->getType());
+			return false;
+		}
+
+		if (queueLength >= RPC_MAX_QUEUED)
+		{
+			OSSHS_LOG_WARNING("Request queue is full(type = 0x%04x).", request->getType());
+			return false;
+		}
+
+		QueuedRequest &queued = queue[(queueHead + queueLength) % RPC_MAX_QUEUED];
+
+		queued.request = request;
+		queued.callback = callback;
+		queued.timeout = timeout;
+		queueLength++;
+
+		update();
+
+		return true;
+	}
+
+	void
+	Rpc::setConcurrencyLimit(uint8_t limit)
+	{
+		concurrencyLimit = (limit == 0) ? 1 : (limit > RPC_MAX_PENDING) ? RPC_MAX_PENDING : limit;
+	}
+
+	uint8_t
+	Rpc::getConcurrencyLimit()
+	{
+		return concurrencyLimit;
+	}
+
+	uint8_t
+	Rpc::getPendingCount()
+	{
+		return pendingCount;
+	}
+
+	bool
+	Rpc::isPending(uint16_t causeId)
+	{
+		return pendingCount != 0 && find(causeId) != nullptr;
+	}
+
+	bool
+	Rpc::handleResponse(std::shared_ptr<events::Event> event)
+	{
+		if (pendingCount == 0)
+			return false;
+
+		PendingRequest *request = find(event->getCauseId());
+
+		if (request == nullptr || request->type == event->getType())
+			return false;
+
+		// A request to a single node is only answered by that node.
+		if (!(request->destination & events::Event::ADDRESS_GROUP_FLAG) && request->destination != event->getSource())
+			return false;
+
+		events::EventCallback callback = request->callback;
+		release(request);
+
+		if (callback != nullptr)
+			callback(event);
+
+		return true;
+	}
+
+	void
+	Rpc::update()
+	{
+		while (queueLength > 0 && pendingCount < concurrencyLimit)
+		{
+			QueuedRequest &queued = queue[queueHead];
+			std::shared_ptr<events::Event> request = std::move(queued.request);
+			events::EventCallback callback = queued.callback;
+			uint32_t timeout = queued.timeout;
+
+			queueHead = (queueHead + 1) % RPC_MAX_QUEUED;
+			queueLength--;
+
+			if (!call(request, callback, timeout))
+			{
+				OSSHS_LOG_WARNING("Rejecting queued request(causeId = 0x%04x).", request->getCauseId());
+				fail(callback, request->getCauseId(), events::SystemError::REJECTED);
+			}
+		}
+	}
+
+	Rpc::PendingRequest *
+	Rpc::find(uint16_t causeId)
+	{
+		for (uint8_t i = 0; i < RPC_MAX_PENDING; i++)
+		{
+			PendingRequest &request = pending[(causeId + i) % RPC_MAX_PENDING];
+
+			if (request.active && request.causeId == causeId)
+				return &request;
+		}
+
+		return nullptr;
+	}
+
+	void
+	Rpc::release(PendingRequest *request)
+	{
+		request->timer.stop();
+		request->active = false;
+		request->callback = nullptr;
+		pendingCount--;
+	}
+
+	void
+	Rpc::expire(PendingRequest *request)
+	{
+		OSSHS_LOG_WARNING("Request timed out(causeId = 0x%04x, type = 0x%04x).", request->causeId, request->type);
+
+		events::EventCallback callback = request->callback;
+		uint16_t causeId = request->causeId;
+		release(request);
+
+		fail(callback, causeId, events::SystemError::TIMEOUT);
+	}
+
+	void
+	Rpc::fail(events::EventCallback callback, uint16_t causeId, events::SystemError error)
+	{
+		std::shared_ptr<events::Event> errorEvent(static_cast<events::Event*> (new (std::nothrow) events::SystemErrorEvent(
+			error,
+			causeId
+		)));
+
+		if (errorEvent == nullptr)
+		{
+			OSSHS_LOG_ERROR("Failed to allocate memory for a system error event.");
+			return;
+		}
+
+		if (callback != nullptr)
+			callback(errorEvent);
+	}
+}
@@ -23,67 +23,229 @@
  */
 
 #include <osshs/system.hpp>
+#include <osshs/benchmark.hpp>
+#include <osshs/boot_profile.hpp>
+#include <osshs/event_recorder.hpp>
+#include <osshs/memory_statistics.hpp>
+#include <osshs/rpc.hpp>
 #include <osshs/time.hpp>
+#include <osshs/timer_wheel.hpp>
+#include <osshs/trace_recorder.hpp>
 #include <osshs/protocol/interfaces/interface_manager.hpp>
 #include <osshs/modules/module_manager.hpp>
+#include <osshs/events/cause_id_allocator.hpp>
 #include <osshs/log/logger.hpp>
 
 namespace osshs
 {
+	uint32_t System::groups[4] = {};
 	std::unordered_map<events::EventSelector, std::vector<events::EventCallback>> System::eventSubscriptions;
+	SubscriptionHandler System::subscriptionHandler;
 
 	void
 	System::initialize()
 	{
-		OSSHS_LOG_INFO("Initializing system.");
+	#ifdef ENABLE_MEMORY_STATISTICS
+		MemoryStatistics::initialize();
+	#endif  // ENABLE_MEMORY_STATISTICS
 
 		Time::initialize();
+		TimerWheel::initialize();
 		protocol::interfaces::InterfaceManager::initialize();
 		modules::ModuleManager::initialize();
+
+		BootProfile::mark(BootPhase::SYSTEM_INITIALIZED);
+
+		// The log buffer would otherwise hold boot messages until loop() starts and drop the rest.
+		OSSHS_LOG_UPDATE();
 	}
 
 	void
 	System::registerInterface(protocol::interfaces::Interface *interface)
 	{
-		OSSHS_LOG_INFO("Registering interface.");
-
 		protocol::interfaces::InterfaceManager::registerInterface(interface);
+
+		BootProfile::mark(BootPhase::INTERFACE_REGISTERED);
+
+		OSSHS_LOG_UPDATE();
 	}
 
 	void
 	System::registerModule(modules::Module *module)
 	{
-		OSSHS_LOG_INFO("Registering module(type = 0x%02x).", module->getModuleTypeId());
-
 		modules::ModuleManager::registerModule(module);
+
+		BootProfile::mark(BootPhase::MODULE_REGISTERED, module->getModuleTypeId());
+
+		OSSHS_LOG_UPDATE();
 	}
 
 	void
 	System::subscribeEvent(events::EventSelector selector, events::EventCallback subscription)
 	{
-		OSSHS_LOG_INFO("Subscribing to event(mask = 0x%04x, identifier = 0x%04x).", selector.mask, selector.identifier);
+		OSSHS_LOG_DEBUG("Subscribing to event(mask = 0x%04x, identifier = 0x%04x).", selector.mask, selector.identifier);
+
+		std::vector<events::EventCallback> &subscriptions = eventSubscriptions[selector];
+		subscriptions.push_back(subscription);
 
-		eventSubscriptions[selector].push_back(subscription);
+		if (subscriptions.size() == 1 && subscriptionHandler != nullptr)
+			subscriptionHandler();
+	}
+
+	void
+	System::setSubscriptionHandler(SubscriptionHandler handler)
+	{
+		subscriptionHandler = handler;
 	}
 
 	void
 	System::reportEvent(std::shared_ptr<events::Event> event)
 	{
+		// Local subscribers get the event by pointer. Only events made on this node which another
+		// node may consume are passed to the interfaces, so intra-node traffic is never serialized.
+		// The source address cannot tell received events apart, since it is only as unique as the node ids.
+		bool local = isAddressed(event->getDestination());
+		bool remote = !event->isReceived() && event->getDestination() != getNodeId();
+
+		if (!local && !remote)
+		{
+			OSSHS_LOG_DEBUG("Dropping event addressed to another node(type = 0x%04x, destination = 0x%02x).", event->getType(), event->getDestination());
+			return;
+		}
+
 		OSSHS_LOG_DEBUG("Handling event(type = 0x%04x)", event->getType());
-		
+		OSSHS_TRACE(REPORTED, event);
+
+		if (remote)
+		{
+			OSSHS_RECORD_SENT(event);
+			protocol::interfaces::InterfaceManager::reportEvent(event);
+		}
+
+		if (!local || Rpc::handleResponse(event))
+			return;
+
+		BootProfile::markFirstEvent(event->getType());
+
 		for(auto const &[selector, subscriptions] : eventSubscriptions)
 			if (selector.match(event->getType()))
 				for (auto const &subscription : subscriptions)
 					subscription(event);
 	}
 
+	void
+	System::setNodeId(uint8_t nodeId)
+	{
+		if (nodeId > events::Event::MAX_NODE_ID)
+		{
+			OSSHS_LOG_ERROR("Invalid node id(nodeId = 0x%02x).", nodeId);
+			return;
+		}
+
+		OSSHS_LOG_INFO("Setting node id(nodeId = 0x%02x).", nodeId);
+
+		events::Event::localNodeId = nodeId;
+		events::CauseIdAllocator::setNodeId(nodeId);
+	}
+
+	uint8_t
+	System::getNodeId()
+	{
+		return events::Event::localNodeId;
+	}
+
+	void
+	System::joinGroup(uint8_t group)
+	{
+		if (!(group & events::Event::ADDRESS_GROUP_FLAG) || group == events::Event::ADDRESS_BROADCAST)
+		{
+			OSSHS_LOG_ERROR("Invalid group address(group = 0x%02x).", group);
+			return;
+		}
+
+		OSSHS_LOG_INFO("Joining group(group = 0x%02x).", group);
+
+		uint8_t index = group & ~events::Event::ADDRESS_GROUP_FLAG;
+		groups[index / 32] |= (1ul << (index % 32));
+	}
+
+	void
+	System::leaveGroup(uint8_t group)
+	{
+		if (!(group & events::Event::ADDRESS_GROUP_FLAG) || group == events::Event::ADDRESS_BROADCAST)
+		{
+			OSSHS_LOG_ERROR("Invalid group address(group = 0x%02x).", group);
+			return;
+		}
+
+		OSSHS_LOG_INFO("Leaving group(group = 0x%02x).", group);
+
+		uint8_t index = group & ~events::Event::ADDRESS_GROUP_FLAG;
+		groups[index / 32] &= ~(1ul << (index % 32));
+	}
+
+	bool
+	System::isAddressed(uint8_t destination)
+	{
+		if (destination == events::Event::ADDRESS_BROADCAST || destination == events::Event::localNodeId)
+			return true;
+
+		if (!(destination & events::Event::ADDRESS_GROUP_FLAG))
+			return false;
+
+		uint8_t index = destination & ~events::Event::ADDRESS_GROUP_FLAG;
+		return groups[index / 32] & (1ul << (index % 32));
+	}
+
+	std::vector<events::EventSelector>
+	System::getEventSelectors()
+	{
+		std::vector<events::EventSelector> selectors;
+
+		for (auto const &[selector, subscriptions] : eventSubscriptions)
+			if (!subscriptions.empty())
+				selectors.push_back(selector);
+
+		return selectors;
+	}
+
 	void
 	System::loop()
 	{
+		if (getNodeId() > events::Event::MAX_NODE_ID)
+		{
+			OSSHS_LOG_ERROR("Node id is not set, not starting. Build with node_id=<id>.");
+
+			while (true)
+			{
+				OSSHS_LOG_UPDATE();
+			}
+		}
+
+	#ifdef ENABLE_BENCHMARK
+		Benchmark::run();
+	#endif  // ENABLE_BENCHMARK
+
+		BootProfile::mark(BootPhase::LOOP_STARTED);
+
 		do
 		{
 			protocol::interfaces::InterfaceManager::run();
+			TimerWheel::update();
+			Rpc::update();
 			modules::ModuleManager::update();
+
+			BootProfile::update();
+
+		#ifdef ENABLE_EVENT_RECORDER
+			EventRecorder::update();
+		#endif  // ENABLE_EVENT_RECORDER
+
+		#ifdef ENABLE_TRACE
+			TraceRecorder::update();
+		#endif  // ENABLE_TRACE
+
+			OSSHS_LOG_UPDATE();
 		}
 		while (true);
 	}
@@ -23,23 +23,26 @@
  */
 
 #include <osshs/time.hpp>
-#include <osshs/log/logger.hpp>
 
 namespace osshs
 {
-	uint64_t Time::systemTime = 0;
+	volatile uint32_t Time::systemTimeLow = 0;
+	volatile uint32_t Time::systemTimeHigh = 0;
 
 	void
 	Time::initialize()
 	{
-		OSSHS_LOG_INFO("Initializing system time.");
-		
 		modm::platform::SysTickTimer::attachInterruptHandler(tick);
 	}
 
 	void
 	Time::tick()
 	{
-		systemTime++;
+		uint32_t low = systemTimeLow + 1;
+
+		if (low == 0)
+			systemTimeHigh = systemTimeHigh + 1;
+
+		systemTimeLow = low;
 	}
 }
@@ -0,0 +1,87 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2019 Linas Nikiperavicius
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <osshs/timer.hpp>
+#include <osshs/timer_wheel.hpp>
+#include <osshs/time.hpp>
+
+namespace osshs
+{
+	Timer::Timer(TimerCallback callback)
+		: next(nullptr), previous(nullptr), slot(nullptr), expiry(0), armed(false), expired(false), callback(callback)
+	{
+	}
+
+	Timer::~Timer()
+	{
+		stop();
+	}
+
+	void
+	Timer::start(uint32_t timeout)
+	{
+		if (armed)
+			TimerWheel::unschedule(this);
+
+		if (timeout == 0)
+			timeout = 1;
+
+		if (timeout > TimerWheel::MAX_TIMEOUT)
+			timeout = TimerWheel::MAX_TIMEOUT;
+
+		expiry = Time::getSystemTime<uint32_t, Time::Precision::Milliseconds>() + timeout;
+		armed = true;
+		expired = false;
+
+		TimerWheel::schedule(this);
+	}
+
+	void
+	Timer::stop()
+	{
+		if (armed)
+			TimerWheel::unschedule(this);
+
+		armed = false;
+		expired = false;
+	}
+
+	bool
+	Timer::isArmed() const
+	{
+		return armed;
+	}
+
+	bool
+	Timer::isExpired() const
+	{
+		return expired;
+	}
+
+	void
+	Timer::setCallback(TimerCallback callback)
+	{
+		this->callback = callback;
+	}
+}
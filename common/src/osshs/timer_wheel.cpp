@@ -0,0 +1,155 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2019 Linas Nikiperavicius
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <osshs/timer_wheel.hpp>
+#include <osshs/time.hpp>
+
+namespace osshs
+{
+	Timer *TimerWheel::root[TimerWheel::ROOT_SIZE];
+	Timer *TimerWheel::levels[TimerWheel::LEVELS - 1][TimerWheel::LEVEL_SIZE];
+	uint32_t TimerWheel::currentTime = 0;
+
+	void
+	TimerWheel::initialize()
+	{
+		currentTime = Time::getSystemTime<uint32_t, Time::Precision::Milliseconds>();
+	}
+
+	void
+	TimerWheel::update()
+	{
+		uint32_t now = Time::getSystemTime<uint32_t, Time::Precision::Milliseconds>();
+
+		while (currentTime != now)
+		{
+			advance();
+		}
+	}
+
+	void
+	TimerWheel::schedule(Timer *timer)
+	{
+		uint32_t expiry = timer->expiry;
+		uint32_t delta = expiry - currentTime;
+		Timer **slot = nullptr;
+
+		if (delta < ROOT_SIZE)
+		{
+			slot = &root[expiry & (ROOT_SIZE - 1)];
+		}
+		else
+		{
+			// The timer is rescheduled from its real expiry time when its slot cascades.
+			if (delta > MAX_TIMEOUT)
+				expiry = currentTime + MAX_TIMEOUT;
+
+			for (uint8_t level = 0; level < LEVELS - 1; level++)
+			{
+				uint8_t shift = ROOT_BITS + level * LEVEL_BITS;
+
+				if (delta < (1ul << (shift + LEVEL_BITS)) || level == LEVELS - 2)
+				{
+					slot = &levels[level][(expiry >> shift) & (LEVEL_SIZE - 1)];
+					break;
+				}
+			}
+		}
+
+		timer->slot = slot;
+		timer->previous = nullptr;
+		timer->next = *slot;
+
+		if (*slot != nullptr)
+			(*slot)->previous = timer;
+
+		*slot = timer;
+	}
+
+	void
+	TimerWheel::unschedule(Timer *timer)
+	{
+		if (timer->previous != nullptr)
+			timer->previous->next = timer->next;
+		else
+			*timer->slot = timer->next;
+
+		if (timer->next != nullptr)
+			timer->next->previous = timer->previous;
+
+		timer->next = nullptr;
+		timer->previous = nullptr;
+		timer->slot = nullptr;
+	}
+
+	void
+	TimerWheel::cascade(uint8_t level, uint8_t index)
+	{
+		Timer *timer = levels[level][index];
+
+		levels[level][index] = nullptr;
+
+		while (timer != nullptr)
+		{
+			Timer *next = timer->next;
+
+			schedule(timer);
+			timer = next;
+		}
+	}
+
+	void
+	TimerWheel::advance()
+	{
+		currentTime++;
+
+		uint8_t index = currentTime & (ROOT_SIZE - 1);
+
+		if (index == 0)
+		{
+			for (uint8_t level = 0; level < LEVELS - 1; level++)
+			{
+				uint8_t levelIndex = (currentTime >> (ROOT_BITS + level * LEVEL_BITS)) & (LEVEL_SIZE - 1);
+
+				cascade(level, levelIndex);
+
+				if (levelIndex != 0)
+					break;
+			}
+		}
+
+		// Callbacks may arm or cancel timers, so the slot is re-read after each one.
+		while (root[index] != nullptr)
+		{
+			Timer *timer = root[index];
+
+			unschedule(timer);
+			timer->armed = false;
+			timer->expired = true;
+
+			if (timer->callback != nullptr)
+				timer->callback();
+		}
+	}
+}
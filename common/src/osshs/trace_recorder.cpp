@@ -0,0 +1,134 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2019 Linas Nikiperavicius
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <osshs/trace_recorder.hpp>
+
+#ifdef ENABLE_TRACE
+	#include <osshs/time.hpp>
+	#include <osshs/events/cause_id_allocator.hpp>
+	#include <osshs/log/logger.hpp>
+
+	namespace osshs
+	{
+		// Records are grouped by cause id, which is only unique within one run of the sequence.
+		static_assert(TraceRecorder::SIZE <= events::CauseIdAllocator::SEQUENCE_MASK + 1,
+			"Trace buffer must not outlast a wrap-around of the cause id sequence.");
+
+		events::DiagnosticsTraceRecord TraceRecorder::records[TraceRecorder::SIZE];
+		uint16_t TraceRecorder::head = 0;
+		uint16_t TraceRecorder::recordCount = 0;
+		bool TraceRecorder::paused = false;
+		uint32_t TraceRecorder::pauseStart = 0;
+		uint32_t TraceRecorder::pauseTimeout = 0;
+		bool TraceRecorder::dumping = false;
+		uint16_t TraceRecorder::dumpIndex = 0;
+
+		void
+		TraceRecorder::record(events::DiagnosticsTraceStage stage, const events::Event *event)
+		{
+			if (event == nullptr || dumping)
+				return;
+
+			if (paused)
+			{
+				if (pauseTimeout == 0 || Time::getSystemTime<uint32_t, Time::Precision::Milliseconds>() - pauseStart < pauseTimeout)
+					return;
+
+				paused = false;
+			}
+
+			events::DiagnosticsTraceRecord &record = records[head];
+
+			record.timestamp = Time::getSystemTime<uint32_t, Time::Precision::Microseconds>();
+			record.causeId = event->getCauseId();
+			record.type = event->getType();
+			record.stage = stage;
+
+			head = (head + 1) % SIZE;
+
+			if (recordCount < SIZE)
+				recordCount++;
+		}
+
+		void
+		TraceRecorder::pause(uint32_t timeout)
+		{
+			paused = true;
+			pauseStart = Time::getSystemTime<uint32_t, Time::Precision::Milliseconds>();
+			pauseTimeout = timeout;
+		}
+
+		void
+		TraceRecorder::resume()
+		{
+			paused = false;
+		}
+
+		uint16_t
+		TraceRecorder::getRecordCount()
+		{
+			return recordCount;
+		}
+
+		events::DiagnosticsTraceRecord
+		TraceRecorder::getRecord(uint16_t index)
+		{
+			if (index >= recordCount)
+				return events::DiagnosticsTraceRecord();
+
+			return records[(head + SIZE - recordCount + index) % SIZE];
+		}
+
+		void
+		TraceRecorder::dump()
+		{
+		#ifndef DISABLE_LOGGING
+			// A dump requested while one is running starts over.
+			dumping = true;
+			dumpIndex = 0;
+		#endif  // DISABLE_LOGGING
+		}
+
+		void
+		TraceRecorder::update()
+		{
+		#ifndef DISABLE_LOGGING
+			// Half of the log buffer is left to other messages.
+			while (dumping && log::Logger::getFree() >= log::LogBuffer::SIZE / 2)
+			{
+				if (dumpIndex >= recordCount)
+				{
+					dumping = false;
+					break;
+				}
+
+				events::DiagnosticsTraceRecord record = getRecord(dumpIndex++);
+
+				OSSHS_LOG_INFO("trace(causeId = 0x%04x, type = 0x%04x, stage = %u, time = %lu)",
+					record.causeId, record.type, static_cast<uint8_t>(record.stage), record.timestamp);
+			}
+		#endif  // DISABLE_LOGGING
+		}
+	}
+#endif  // ENABLE_TRACE
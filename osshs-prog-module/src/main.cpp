@@ -24,8 +24,9 @@
 
 #include <osshs/system.hpp>
 #include <osshs/protocol/interfaces/uart_interface.hpp>
-#include <osshs/protocol/interfaces/can_interface.hpp>
+#include <osshs/transport/segmented_can_interface.hpp>
 #include <osshs/log/logger.hpp>
+#include <osshs/log/usart1_dma_log_drain.hpp>
 
 #include "./board.hpp"
 
@@ -34,7 +35,7 @@ using namespace modm::literals;
 #undef	MODM_LOG_LEVEL
 #define	MODM_LOG_LEVEL modm::log::DEBUG
 
-OSSHS_ENABLE_LOGGER(modm::platform::Usart1, modm::IOBuffer::BlockIfFull);
+OSSHS_ENABLE_DMA_LOGGER();
 
 int
 main()
@@ -51,13 +52,14 @@ main()
 	modm::platform::Can::initialize<osshs::board::SystemClock, 50_kbps>(0);
 
 	osshs::System::initialize();
+	osshs::System::setNodeId(OSSHS_NODE_ID);
 
 	osshs::System::registerInterface(
 		new osshs::protocol::interfaces::UartInterface<modm::platform::Usart2>()
 	);
 
 	osshs::System::registerInterface(
-		new osshs::protocol::interfaces::CanInterface<modm::platform::Can>()
+		new osshs::transport::SegmentedCanInterface<modm::platform::Can>()
 	);
 
 	osshs::System::loop();
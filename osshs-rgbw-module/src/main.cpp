@@ -23,10 +23,15 @@
  */
 
 #include <osshs/system.hpp>
-#include <osshs/protocol/interfaces/can_interface.hpp>
+#include <osshs/can/can_acceptance_filter.hpp>
+#include <osshs/flash/stm32f1_flash.hpp>
+#include <osshs/transport/segmented_can_interface.hpp>
+#include <osshs/modules/diagnostics_module.hpp>
 #include <osshs/modules/eeprom_module.hpp>
+#include <osshs/modules/firmware_update_module.hpp>
 #include <osshs/modules/pwm_module.hpp>
 #include <osshs/log/logger.hpp>
+#include <osshs/log/usart1_dma_log_drain.hpp>
 
 #include "./board.hpp"
 
@@ -35,7 +40,7 @@ using namespace modm::literals;
 #undef	MODM_LOG_LEVEL
 #define	MODM_LOG_LEVEL modm::log::DEBUG
 
-OSSHS_ENABLE_LOGGER(modm::platform::Usart1, modm::IOBuffer::BlockIfFull);
+OSSHS_ENABLE_DMA_LOGGER();
 
 int
 main()
@@ -55,24 +60,27 @@ main()
 	modm::platform::SpiMaster1::initialize<osshs::board::SystemClock, 1125_kBd>();
 
 	osshs::System::initialize();
+	osshs::System::setNodeId(OSSHS_NODE_ID);
 
 	osshs::System::registerInterface(
-		new osshs::protocol::interfaces::CanInterface<modm::platform::Can> ()
+		new osshs::transport::SegmentedCanInterface<modm::platform::Can>()
 	);
 
-	std::shared_ptr<osshs::events::Event> event(new osshs::events::EepromRequestDataEvent(0x01, 0x02));
-	osshs::protocol::interfaces::InterfaceManager::reportEvent(event);
+	// Only frames of subscribed event types reach the CPU, the modules subscribe as they register.
+	osshs::can::CanAcceptanceFilter<modm::platform::CanFilter>::enable();
 
-	event.reset(new osshs::events::EepromUpdateSuccessEvent());
-	osshs::protocol::interfaces::InterfaceManager::reportEvent(event);
-
-	event.reset(new osshs::events::PwmRgbwChannelReadyEvent(0x00, osshs::events::PwmRgbwValue(0x01, 0x02, 0x03, 0x04)));
-	osshs::protocol::interfaces::InterfaceManager::reportEvent(event);
+	osshs::System::registerModule(
+		new osshs::modules::DiagnosticsModule()
+	);
 
 	osshs::System::registerModule(
 		new osshs::modules::EepromModule<modm::platform::I2cMaster1>()
 	);
 
+	osshs::System::registerModule(
+		new osshs::modules::FirmwareUpdateModule<osshs::flash::Stm32f1Flash>()
+	);
+
 	osshs::System::registerModule(
 		new osshs::modules::PwmModule<24, modm::platform::SpiMaster1, modm::platform::GpioA4, modm::platform::GpioA3>()
 	);
@@ -0,0 +1,583 @@
+#!/usr/bin/env python3
+#
+# MIT License
+#
+# Copyright (c) 2019 Linas Nikiperavicius
+#
+# Permission is hereby granted, free of charge, to any person obtaining a copy
+# of this software and associated documentation files (the "Software"), to deal
+# in the Software without restriction, including without limitation the rights
+# to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+# copies of the Software, and to permit persons to whom the Software is
+# furnished to do so, subject to the following conditions:
+#
+# The above copyright notice and this permission notice shall be included in all
+# copies or substantial portions of the Software.
+#
+# THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+# IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+# FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+# AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+# LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+# OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+# SOFTWARE.
+
+
+"""
+Record event traffic and replay it against a node.
+
+Captures are stored in a compact binary format: the magic b'OSEC' and a version
+byte, followed by one record per event, [time in microseconds, 32 bits][direction]
+[serialized event], where the event starts with its own length. Direction is seen
+from the recorded node, 0 for events it received and 1 for events it sent.
+
+A capture can be made in several ways:
+  - extract: from the log of firmware built with event_recorder=1 (decoded by
+    tools/log_decoder.py in tokenized mode), which records the events crossing
+    the interfaces of that node with its own timestamps.
+  - record: from the UART interface of a node or an osshs-prog-module, with host
+    timestamps. Events sent by --node are recorded as sent, all others as received.
+  - convert: from a candump log (candump -l), reassembling the segmented transport.
+    Captures convert back to candump logs, e.g. for canplayer.
+
+Replay sends the received events of a capture to a node through a UART interface,
+at the original rate, accelerated by --speed, or back to back with --speed 0. The
+responses are matched to their requests by cause id. Per request type the latency
+is reported next to the latency in the capture, and every response which is missing,
+unexpected or different from the capture is listed. Configure the serial port
+beforehand, e.g. `stty -F /dev/ttyUSB0 115200 raw -echo`.
+
+    ./tools/log_decoder.py log.bin | ./tools/event_capture.py extract - capture.osec
+    ./tools/event_capture.py record /dev/ttyUSB0 capture.osec --node 0x10
+    ./tools/event_capture.py convert candump.log capture.osec --node 0x10
+    ./tools/event_capture.py convert capture.osec candump.log
+    ./tools/event_capture.py show capture.osec
+    ./tools/event_capture.py replay capture.osec /dev/ttyUSB0 --speed 10 --ignore 0x0306
+"""
+
+import argparse
+import os
+import re
+import select
+import struct
+import sys
+import time
+
+MAGIC = b'OSEC'
+VERSION = 1
+RECORD = struct.Struct('<IB')
+RECEIVED, SENT = range(2)
+DIRECTIONS = ['rx', 'tx']
+
+HEADER = struct.Struct('<HHHBB')
+
+# Must match osshs::can and osshs::transport::SegmentedTransport.
+FLOW_CONTROL_FLAG = 1 << 16
+SOURCE_SHIFT = 17
+PRIORITY_SHIFT = 26
+SINGLE, FIRST, CONSECUTIVE = 0x00, 0x10, 0x20
+
+LOG_EVENT = re.compile(r'event\(sequence = (\d+), direction = (\d+), time = (\d+), length = (\d+)\)')
+LOG_EVENT_DATA = re.compile(r'event data\(sequence = (\d+), offset = (\d+), data = ([0-9a-fA-F]+)\)')
+LOG_DROPPED = re.compile(r'Dropped event records\(next sequence = (\d+)')
+CANDUMP = re.compile(r'\((\d+(?:\.\d+)?)\)\s+(\S+)\s+([0-9a-fA-F]+)#([0-9a-fA-F]*)')
+
+
+class Event:
+    def __init__(self, timestamp, direction, data):
+        self.timestamp = timestamp
+        self.direction = direction
+        self.data = data
+        _, self.type, self.cause_id, self.destination, self.source = HEADER.unpack_from(data)
+
+    def describe(self):
+        return 'type 0x%04x, causeId 0x%04x, 0x%02x -> 0x%02x: %s' % (
+            self.type, self.cause_id, self.source, self.destination, self.data[HEADER.size:].hex())
+
+
+def unwrap(timestamps):
+    """
+    Extend wrapping 32-bit microsecond timestamps, assuming less than
+    about 71 minutes pass between two consecutive events.
+    """
+    previous = None
+    offset = 0
+
+    for timestamp in timestamps:
+        if previous is not None:
+            offset += (timestamp - previous) & 0xffffffff
+
+        previous = timestamp
+        yield offset
+
+
+def read_capture(path):
+    with open(path, 'rb') as stream:
+        data = stream.read()
+
+    if data[:len(MAGIC)] != MAGIC or data[len(MAGIC)] != VERSION:
+        raise ValueError('%s is not an event capture' % path)
+
+    raw = []
+    position = len(MAGIC) + 1
+
+    while position + RECORD.size + HEADER.size <= len(data):
+        timestamp, direction = RECORD.unpack_from(data, position)
+        position += RECORD.size
+        length = HEADER.unpack_from(data, position)[0]
+
+        if length < HEADER.size or position + length > len(data):
+            raise ValueError('%s is truncated' % path)
+
+        raw.append((timestamp, direction, data[position:position + length]))
+        position += length
+
+    return [Event(timestamp, direction, event) for timestamp, (_, direction, event) in zip(unwrap(record[0] for record in raw), raw)]
+
+
+def write_capture(path, events):
+    with open(path, 'wb') as stream:
+        stream.write(MAGIC + bytes([VERSION]))
+
+        for event in events:
+            stream.write(RECORD.pack(event.timestamp & 0xffffffff, event.direction) + event.data)
+
+
+def parse_log(lines):
+    """
+    Assemble the records written to the log by osshs::EventRecorder.
+    Returns the complete events and the number of records lost on the way.
+    """
+    pending = {}
+    raw = []
+    lost = 0
+    expected = None
+
+    for line in lines:
+        match = LOG_EVENT.search(line)
+
+        if match:
+            sequence, direction, timestamp, length = (int(group) for group in match.groups())
+
+            if expected is not None:
+                lost += (sequence - expected) & 0xffff
+
+            expected = (sequence + 1) & 0xffff
+            lost += len(pending)
+            pending = {sequence: (timestamp, direction, length, bytearray())}
+            continue
+
+        match = LOG_DROPPED.search(line)
+
+        if match:
+            sequence = int(match.group(1))
+
+            if expected is not None:
+                lost += (sequence - expected) & 0xffff
+
+            expected = sequence
+            continue
+
+        match = LOG_EVENT_DATA.search(line)
+
+        if match:
+            sequence, offset = int(match.group(1)), int(match.group(2))
+            record = pending.get(sequence)
+
+            if record is None or offset != len(record[3]):
+                # A line was dropped by the log buffer.
+                lost += sequence in pending
+                pending.pop(sequence, None)
+                continue
+
+            timestamp, direction, length, data = record
+            data += bytes.fromhex(match.group(3))
+
+            if len(data) >= length:
+                del pending[sequence]
+
+                if length >= HEADER.size:
+                    raw.append((timestamp, direction, bytes(data[:length])))
+                else:
+                    lost += 1
+
+    lost += len(pending)
+    events = [Event(timestamp, direction, data) for timestamp, (_, direction, data) in zip(unwrap(record[0] for record in raw), raw)]
+
+    return events, lost
+
+
+def direction_of(data, node):
+    return SENT if node is not None and data[7] == node else RECEIVED
+
+
+def read_candump(lines, node):
+    """
+    Reassemble the events carried by the frames of a candump log.
+    Returns the complete events and the number of transfers that did not complete.
+    """
+    sessions = {}
+    events = []
+    start = None
+    incomplete = 0
+
+    for line in lines:
+        match = CANDUMP.search(line)
+
+        if not match or len(match.group(3)) != 8:
+            continue
+
+        timestamp = int(round(float(match.group(1)) * 1000000))
+        identifier = int(match.group(3), 16)
+        frame = bytes.fromhex(match.group(4))
+        start = timestamp if start is None else start
+
+        if identifier & FLOW_CONTROL_FLAG or not frame:
+            continue
+
+        frame_type = frame[0] & 0xf0
+
+        if frame_type == SINGLE:
+            data = frame[1:1 + (frame[0] & 0x0f)]
+        elif frame_type == FIRST and len(frame) == 8:
+            incomplete += (identifier, frame[2]) in sessions
+            sessions[(identifier, frame[2])] = [((frame[0] & 0x0f) << 8) | frame[1], 1, bytearray(frame[4:])]
+            continue
+        elif frame_type == CONSECUTIVE and len(frame) >= 2:
+            session = sessions.get((identifier, frame[1]))
+
+            if session is None:
+                continue
+
+            length, sequence, data = session
+
+            if frame[0] & 0x0f != sequence:
+                incomplete += 1
+                del sessions[(identifier, frame[1])]
+                continue
+
+            data += frame[2:]
+            session[1] = (sequence + 1) & 0x0f
+
+            if len(data) < length:
+                continue
+
+            del sessions[(identifier, frame[1])]
+            data = bytes(data[:length])
+        else:
+            continue
+
+        if len(data) >= HEADER.size:
+            events.append(Event(timestamp - start, direction_of(data, node), data))
+
+    return events, incomplete + len(sessions)
+
+
+def write_candump(events, stream, interface, priority):
+    for event in events:
+        identifier = (priority << PRIORITY_SHIFT) | ((event.source & 0x7f) << SOURCE_SHIFT) | event.type
+        timestamp = '(%u.%06u)' % divmod(event.timestamp, 1000000)
+        data = event.data
+
+        if len(data) <= 7:
+            frames = [bytes([SINGLE | len(data)]) + data]
+        else:
+            tag = data[4]
+            frames = [bytes([FIRST | (len(data) >> 8), len(data) & 0xff, tag, event.destination]) + data[:4]]
+            sequence = 1
+
+            for offset in range(4, len(data), 6):
+                frames.append(bytes([CONSECUTIVE | sequence, tag]) + data[offset:offset + 6])
+                sequence = (sequence + 1) & 0x0f
+
+        for frame in frames:
+            stream.write('%s %s %08X#%s\n' % (timestamp, interface, identifier, frame.hex().upper()))
+
+
+class Link:
+    """
+    Serialized events over a UART interface, each starting with its own length.
+    """
+
+    def __init__(self, path):
+        self.fd = os.open(path, os.O_RDWR | os.O_NOCTTY)
+        self.data = b''
+
+    def send(self, data):
+        os.write(self.fd, data)
+
+    def receive(self, timeout):
+        """
+        Return the next serialized event, or None once the timeout expires.
+        """
+        deadline = time.monotonic() + timeout
+
+        while True:
+            if len(self.data) >= HEADER.size:
+                length = HEADER.unpack_from(self.data)[0]
+
+                if length < HEADER.size:
+                    # Not an event header, resynchronise on the next byte.
+                    self.data = self.data[1:]
+                    continue
+
+                if len(self.data) >= length:
+                    data = self.data[:length]
+                    self.data = self.data[length:]
+                    return data
+
+            remaining = deadline - time.monotonic()
+
+            if remaining <= 0 or not select.select([self.fd], [], [], remaining)[0]:
+                return None
+
+            self.data += os.read(self.fd, 256)
+
+
+def record(link, node, duration):
+    events = []
+    start = time.monotonic()
+
+    try:
+        while duration is None or time.monotonic() - start < duration:
+            data = link.receive(0.1)
+
+            if data is not None:
+                events.append(Event(int((time.monotonic() - start) * 1000000), direction_of(data, node), data))
+    except KeyboardInterrupt:
+        pass
+
+    return events
+
+
+def infer_node(events):
+    sources = [event.source for event in events if event.direction == SENT]
+
+    return max(set(sources), key=sources.count) if sources else None
+
+
+def match_responses(requests, responses):
+    """
+    Assign every response to the latest request before it with the same cause id.
+    requests and responses are lists of (timestamp, Event), ordered by time.
+    Returns one list of (timestamp, Event) per request and the unmatched responses.
+    """
+    matched = [[] for _ in requests]
+    unmatched = []
+    latest = {}
+    index = 0
+
+    for timestamp, response in responses:
+        while index < len(requests) and requests[index][0] <= timestamp:
+            latest[requests[index][1].cause_id] = index
+            index += 1
+
+        request = latest.get(response.cause_id)
+
+        if request is None:
+            unmatched.append((timestamp, response))
+        else:
+            matched[request].append((timestamp, response))
+
+    return matched, unmatched
+
+
+def replay(events, link, node, speed, timeout, ignored):
+    """
+    Send the received events to the node and collect everything it sends.
+    Returns (send time, Event) per request and (arrival time, Event) per response,
+    in microseconds since the replay started.
+    """
+    requests = [event for event in events if event.direction == RECEIVED]
+    sent = []
+    responses = []
+    start = time.monotonic()
+
+    def collect(until):
+        while True:
+            data = link.receive(max(0, until - time.monotonic()))
+
+            if data is None:
+                return
+
+            response = Event(0, SENT, data)
+
+            if response.source == node and response.type not in ignored:
+                responses.append((int((time.monotonic() - start) * 1000000), response))
+
+    for request in requests:
+        if speed > 0:
+            collect(start + (request.timestamp - requests[0].timestamp) / 1000000 / speed)
+        else:
+            collect(time.monotonic())
+
+        sent.append((int((time.monotonic() - start) * 1000000), request))
+        link.send(request.data)
+
+    collect(time.monotonic() + timeout)
+
+    return sent, responses
+
+
+def report(events, node, sent, responses, ignored, output):
+    captured_requests = [(event.timestamp, event) for event in events if event.direction == RECEIVED]
+    captured_responses = [(event.timestamp, event) for event in events
+                          if event.direction == SENT and event.source == node and event.type not in ignored]
+
+    expected, spontaneous = match_responses(captured_requests, captured_responses)
+    actual, unexpected = match_responses(sent, responses)
+    statistics = {}
+    divergences = 0
+
+    for index, (send_time, request) in enumerate(sent):
+        per_type = statistics.setdefault(request.type, {'count': 0, 'captured': [], 'replayed': [], 'diverged': 0})
+        per_type['count'] += 1
+
+        if expected[index]:
+            per_type['captured'].append(expected[index][0][0] - captured_requests[index][0])
+
+        if actual[index]:
+            per_type['replayed'].append(actual[index][0][0] - send_time)
+
+        missing = [response.data for _, response in expected[index]]
+        extra = []
+
+        for _, response in actual[index]:
+            if response.data in missing:
+                missing.remove(response.data)
+            else:
+                extra.append(response.data)
+
+        if not missing and not extra:
+            continue
+
+        per_type['diverged'] += 1
+        divergences += 1
+        output.write('request %u, %s\n' % (index, request.describe()))
+
+        for data in missing:
+            changed = next((other for other in extra if other[2:4] == data[2:4]), None)
+
+            if changed is not None:
+                extra.remove(changed)
+                output.write('  differs:    %s\n' % Event(0, SENT, data).describe())
+                output.write('         now: %s\n' % Event(0, SENT, changed).describe())
+            else:
+                output.write('  missing:    %s\n' % Event(0, SENT, data).describe())
+
+        for data in extra:
+            output.write('  unexpected: %s\n' % Event(0, SENT, data).describe())
+
+    if divergences:
+        output.write('\n')
+
+    output.write('%-10s %6s %9s %14s %10s %10s %10s\n' % (
+        'type', 'count', 'diverged', 'captured [us]', 'min [us]', 'avg [us]', 'max [us]'))
+
+    for event_type in sorted(statistics):
+        per_type = statistics[event_type]
+        captured = per_type['captured']
+        replayed = per_type['replayed']
+
+        # Latencies of requests without a response are shown as -.
+        latencies = [sum(captured) // len(captured) if captured else '-']
+        latencies += [min(replayed), sum(replayed) // len(replayed), max(replayed)] if replayed else ['-'] * 3
+
+        output.write('0x%04x     %6u %9u %14s %10s %10s %10s\n' % ((event_type, per_type['count'], per_type['diverged']) + tuple(latencies)))
+
+    if len(spontaneous) != len(unexpected):
+        output.write('\nevents not caused by a request: %u in the capture, %u in the replay\n' % (len(spontaneous), len(unexpected)))
+        divergences += 1
+
+    return divergences
+
+
+def is_capture(path):
+    with open(path, 'rb') as stream:
+        return stream.read(len(MAGIC)) == MAGIC
+
+
+def open_text(path):
+    return sys.stdin if path == '-' else open(path, 'r', errors='replace')
+
+
+def number(text):
+    return int(text, 0)
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Record osshs event traffic and replay it against a node.')
+    commands = parser.add_subparsers(dest='command', required=True)
+
+    command = commands.add_parser('show', help='print the events of a capture')
+    command.add_argument('capture')
+
+    command = commands.add_parser('extract', help='make a capture from the log of firmware built with event_recorder=1')
+    command.add_argument('log', help='log output containing event records, - for stdin')
+    command.add_argument('capture')
+
+    command = commands.add_parser('record', help='record the events on a UART interface')
+    command.add_argument('port')
+    command.add_argument('capture')
+    command.add_argument('--node', type=number, help='node id of the recorded node')
+    command.add_argument('--duration', type=float, help='recording time in seconds, until interrupted by default')
+
+    command = commands.add_parser('convert', help='convert between captures and candump logs')
+    command.add_argument('input')
+    command.add_argument('output')
+    command.add_argument('--node', type=number, help='node id of the recorded node, when reading a candump log')
+    command.add_argument('--interface', default='can0', help='CAN interface name, when writing a candump log')
+    command.add_argument('--priority', type=number, default=1, help='priority level of the frames, when writing a candump log')
+
+    command = commands.add_parser('replay', help='replay a capture against a node and report latency and divergence')
+    command.add_argument('capture')
+    command.add_argument('port')
+    command.add_argument('--node', type=number, help='node id of the replayed node, taken from the capture by default')
+    command.add_argument('--speed', type=float, default=1, help='rate relative to the capture, 0 to send back to back')
+    command.add_argument('--timeout', type=float, default=1, help='time to wait for responses after the last request, in seconds')
+    command.add_argument('--ignore', type=number, action='append', default=[], help='event type to leave out of the comparison')
+
+    arguments = parser.parse_args()
+
+    if arguments.command == 'show':
+        for event in read_capture(arguments.capture):
+            print('%12u us  %s  %s' % (event.timestamp, DIRECTIONS[event.direction], event.describe()))
+
+    elif arguments.command == 'extract':
+        events, lost = parse_log(open_text(arguments.log))
+        write_capture(arguments.capture, events)
+        print('%u events, %u lost' % (len(events), lost), file=sys.stderr)
+
+    elif arguments.command == 'record':
+        events = record(Link(arguments.port), arguments.node, arguments.duration)
+        write_capture(arguments.capture, events)
+        print('%u events' % len(events), file=sys.stderr)
+
+    elif arguments.command == 'convert':
+        if is_capture(arguments.input):
+            with open(arguments.output, 'w') as stream:
+                write_candump(read_capture(arguments.input), stream, arguments.interface, arguments.priority)
+        else:
+            if arguments.node is None:
+                parser.error('--node is required to tell sent from received events')
+
+            events, incomplete = read_candump(open_text(arguments.input), arguments.node)
+            write_capture(arguments.output, events)
+            print('%u events, %u incomplete transfers' % (len(events), incomplete), file=sys.stderr)
+
+    elif arguments.command == 'replay':
+        events = read_capture(arguments.capture)
+        node = arguments.node if arguments.node is not None else infer_node(events)
+
+        if node is None:
+            parser.error('the capture holds no sent events, --node is required')
+
+        ignored = set(arguments.ignore)
+        sent, responses = replay(events, Link(arguments.port), node, arguments.speed, arguments.timeout, ignored)
+
+        if report(events, node, sent, responses, ignored, sys.stdout):
+            sys.exit(1)
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,288 @@
+#!/usr/bin/env python3
+#
+# MIT License
+#
+# Copyright (c) 2019 Linas Nikiperavicius
+#
+# Permission is hereby granted, free of charge, to any person obtaining a copy
+# of this software and associated documentation files (the "Software"), to deal
+# in the Software without restriction, including without limitation the rights
+# to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+# copies of the Software, and to permit persons to whom the Software is
+# furnished to do so, subject to the following conditions:
+#
+# The above copyright notice and this permission notice shall be included in all
+# copies or substantial portions of the Software.
+#
+# THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+# IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+# FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+# AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+# LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+# OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+# SOFTWARE.
+
+
+"""
+Stream a firmware image to one or more nodes running the firmware update module.
+
+Events are exchanged through the UART interface of an osshs-prog-module as
+serialized events, each starting with its own length. Configure the serial
+port beforehand, e.g. `stty -F /dev/ttyUSB0 115200 raw -echo`.
+
+Blocks are sent to a destination address, which may be a group or broadcast,
+so every listed node receives the image in a single pass. Nodes reached by the
+destination but not listed are updated as well, without being waited for. Each node
+acknowledges the blocks it has programmed. The sender keeps at most a window
+of blocks ahead of the slowest node and goes back to it on a timeout.
+
+    ./tools/firmware_update.py image.bin --nodes 0x10 --restart
+    ./tools/firmware_update.py image.bin --nodes 1,2,3 --destination 0xff
+"""
+
+import argparse
+import os
+import select
+import struct
+import sys
+import time
+import zlib
+
+# Must match osshs::events::FirmwareEvent and osshs::events::FirmwareError.
+BEGIN, READY, BLOCK, ACKNOWLEDGE, FINISH, COMPLETE, ERROR = range(0x0401, 0x0408)
+ERRORS = ['NOT_STARTED', 'IMAGE_TOO_LARGE', 'IMAGE_INCOMPLETE', 'IMAGE_CRC_MISMATCH', 'FLASH_FAILED', 'TIMED_OUT']
+
+# Must match osshs::flash::Stm32f1Flash. A node erases the pages of the image and the
+# descriptor page before answering BEGIN; the STM32F103 datasheet gives 40 ms per page
+# at most, with the CPU stalled meanwhile.
+PAGE_SIZE = 2048
+PAGE_ERASE_TIME = 0.040
+
+HEADER = struct.Struct('<HHHBB')
+BROADCAST = 0xff
+SEQUENCE_BITS = 9
+
+
+class Link:
+    def __init__(self, path, source):
+        self.fd = os.open(path, os.O_RDWR | os.O_NOCTTY)
+        self.source = source
+        self.sequence = 0
+        self.data = b''
+
+    def send(self, event_type, destination, payload=b''):
+        cause_id = (self.source << SEQUENCE_BITS) | self.sequence
+        self.sequence = (self.sequence + 1) & ((1 << SEQUENCE_BITS) - 1)
+
+        os.write(self.fd, HEADER.pack(HEADER.size + len(payload), event_type, cause_id, destination, self.source) + payload)
+
+    def receive(self, timeout):
+        """
+        Return the next event addressed to this host as (type, source, payload),
+        or None once the timeout expires.
+        """
+        deadline = time.monotonic() + timeout
+
+        while True:
+            if len(self.data) >= HEADER.size:
+                length, event_type, _, destination, source = HEADER.unpack_from(self.data)
+
+                if length < HEADER.size:
+                    # Not an event header, resynchronise on the next byte.
+                    self.data = self.data[1:]
+                    continue
+
+                if len(self.data) >= length:
+                    payload = self.data[HEADER.size:length]
+                    self.data = self.data[length:]
+
+                    if destination in (self.source, BROADCAST):
+                        return event_type, source, payload
+
+                    continue
+
+            remaining = deadline - time.monotonic()
+
+            if remaining <= 0 or not select.select([self.fd], [], [], remaining)[0]:
+                return None
+
+            self.data += os.read(self.fd, 256)
+
+
+def collect(link, nodes, expected, timeout):
+    """
+    Wait for one response of the expected type from every node.
+    Returns the payloads of the nodes which answered and the nodes which failed.
+    """
+    payloads = {}
+    failed = set()
+    deadline = time.monotonic() + timeout
+
+    while len(payloads) + len(failed) < len(nodes) and time.monotonic() < deadline:
+        event = link.receive(deadline - time.monotonic())
+
+        if event is None:
+            break
+
+        event_type, source, payload = event
+
+        if source not in nodes or source in payloads or source in failed:
+            continue
+
+        if event_type == ERROR:
+            error = ERRORS[payload[0]] if payload[0] < len(ERRORS) else str(payload[0])
+            print('node 0x%02x: error %s' % (source, error), file=sys.stderr)
+            failed.add(source)
+        elif event_type == expected:
+            payloads[source] = payload
+
+    return payloads, failed
+
+
+def request(link, nodes, destination, event_type, payload, expected, timeout, retries):
+    """
+    Send a request to the destination and collect the responses of all nodes.
+    Nodes which do not answer are asked again one by one. Nodes which fail or
+    never answer are removed from nodes.
+    """
+    payloads = {}
+    link.send(event_type, destination, payload)
+
+    for attempt in range(retries + 1):
+        answered, failed = collect(link, nodes - payloads.keys(), expected, timeout)
+        payloads.update(answered)
+        nodes -= failed
+
+        missing = nodes - payloads.keys()
+
+        if not missing or attempt == retries:
+            break
+
+        for node in sorted(missing):
+            link.send(event_type, node, payload)
+
+    for node in nodes - payloads.keys():
+        print('node 0x%02x: no response' % node, file=sys.stderr)
+
+    nodes.intersection_update(payloads.keys())
+
+    return payloads
+
+
+def stream(link, nodes, destination, image, block_size, window, timeout, retries):
+    blocks = (len(image) + block_size - 1) // block_size
+    acknowledged = {node: 0 for node in nodes}
+    attempts = 0
+    sent = 0
+
+    while nodes and min(acknowledged[node] for node in nodes) < blocks:
+        base = min(acknowledged[node] for node in nodes)
+
+        while sent < blocks and sent < base + window:
+            data = image[sent * block_size:(sent + 1) * block_size]
+            link.send(BLOCK, destination, struct.pack('<HIH', sent, zlib.crc32(data), len(data)) + data)
+            sent += 1
+
+        event = link.receive(timeout)
+
+        if event is None:
+            attempts += 1
+
+            if attempts > retries:
+                for node in [node for node in nodes if acknowledged[node] == base]:
+                    print('node 0x%02x: stalled at block %u' % (node, base), file=sys.stderr)
+                    nodes.discard(node)
+
+                attempts = 0
+
+            # Go back to the oldest block not acknowledged by every node.
+            sent = min([acknowledged[node] for node in nodes] + [blocks])
+            continue
+
+        event_type, source, payload = event
+
+        if source not in nodes:
+            continue
+
+        if event_type == ERROR:
+            error = ERRORS[payload[0]] if payload[0] < len(ERRORS) else str(payload[0])
+            print('node 0x%02x: error %s at block %u' % (source, error, acknowledged[source]), file=sys.stderr)
+            nodes.discard(source)
+        elif event_type == ACKNOWLEDGE:
+            next_index, node_window = struct.unpack('<HB', payload)
+
+            if next_index > acknowledged[source]:
+                acknowledged[source] = next_index
+                attempts = 0
+
+            window = min(window, node_window)
+
+        sys.stderr.write('\r%u/%u blocks' % (min([acknowledged[node] for node in nodes] + [blocks]), blocks))
+
+    sys.stderr.write('\n')
+
+
+def parse_address(text):
+    return int(text, 0)
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Stream a firmware image to osshs nodes.')
+    parser.add_argument('image', help='raw binary image of the application')
+    parser.add_argument('--port', default='/dev/ttyUSB0', help='serial device of the programming module')
+    parser.add_argument('--nodes', required=True, help='comma separated node ids to update')
+    parser.add_argument('--destination', type=parse_address, help='address the image is sent to, a group the nodes joined or broadcast, defaults to the only node')
+    parser.add_argument('--source', type=parse_address, default=0x7e, help='node id of this host')
+    parser.add_argument('--restart', action='store_true', help='restart the nodes to install the image')
+    parser.add_argument('--timeout', type=float, default=1.0, help='seconds without an acknowledgement before going back')
+    parser.add_argument('--retries', type=int, default=5, help='timeouts before a stalled node is given up')
+    parser.add_argument('--erase-timeout', type=float, help='seconds to wait for the staging area to be erased, '
+                        'defaults to the worst case erase time of the image plus --timeout')
+    arguments = parser.parse_args()
+
+    with open(arguments.image, 'rb') as file:
+        image = file.read()
+
+    nodes = set(parse_address(node) for node in arguments.nodes.split(','))
+
+    if arguments.destination is None:
+        if len(nodes) != 1:
+            sys.exit('Updating several nodes needs a --destination reaching all of them.')
+
+        arguments.destination = next(iter(nodes))
+
+    if arguments.erase_timeout is None:
+        pages = (len(image) + PAGE_SIZE - 1) // PAGE_SIZE + 1
+        arguments.erase_timeout = pages * PAGE_ERASE_TIME + arguments.timeout
+
+    link = Link(arguments.port, arguments.source)
+    started = time.monotonic()
+
+    readies = request(link, nodes, arguments.destination, BEGIN, struct.pack('<II', len(image), zlib.crc32(image)),
+                      READY, arguments.erase_timeout, arguments.retries)
+
+    if not readies:
+        sys.exit('No node is ready for the update.')
+
+    block_sizes = set(struct.unpack('<HB', payload)[0] for payload in readies.values())
+
+    if len(block_sizes) != 1:
+        sys.exit('Nodes use different block sizes: %s' % ', '.join(map(str, sorted(block_sizes))))
+
+    window = min(struct.unpack('<HB', payload)[1] for payload in readies.values())
+    stream(link, nodes, arguments.destination, image, block_sizes.pop(), window, arguments.timeout, arguments.retries)
+
+    updated = set(nodes)
+    request(link, updated, arguments.destination, FINISH, struct.pack('<B', arguments.restart),
+            COMPLETE, arguments.timeout, arguments.retries)
+
+    elapsed = time.monotonic() - started
+    print('updated %u node(s) in %.1f s (%.0f B/s): %s' % (len(updated), elapsed, len(image) / elapsed,
+          ', '.join('0x%02x' % node for node in sorted(updated))))
+
+    if len(updated) != len(arguments.nodes.split(',')):
+        sys.exit(1)
+
+
+if __name__ == '__main__':
+    main()
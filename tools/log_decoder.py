@@ -0,0 +1,195 @@
+#!/usr/bin/env python3
+#
+# MIT License
+#
+# Copyright (c) 2019 Linas Nikiperavicius
+#
+# Permission is hereby granted, free of charge, to any person obtaining a copy
+# of this software and associated documentation files (the "Software"), to deal
+# in the Software without restriction, including without limitation the rights
+# to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+# copies of the Software, and to permit persons to whom the Software is
+# furnished to do so, subject to the following conditions:
+#
+# The above copyright notice and this permission notice shall be included in all
+# copies or substantial portions of the Software.
+#
+# THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+# IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+# FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+# AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+# LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+# OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+# SOFTWARE.
+
+"""
+Decode tokenized log records produced by firmware built with
+ENABLE_TOKENIZED_LOGGING.
+
+The token dictionary is rebuilt from the sources on every run, so it always
+matches the firmware built from the same tree.
+
+    ./tools/log_decoder.py capture.bin
+    stty -F /dev/ttyUSB0 115200 raw && ./tools/log_decoder.py /dev/ttyUSB0
+"""
+
+import argparse
+import os
+import re
+import struct
+import sys
+
+RECORD_MAGIC = 0xa5
+RECORD_HEADER_LENGTH = 11
+
+# Emitted by the logger in place of messages that did not fit into the log buffer.
+DROPPED_TOKEN = 0
+
+LEVELS = ['DISABLED', 'ERROR', 'WARNING', 'INFO', 'DEBUG']
+
+DEFAULT_SOURCES = ['common', 'osshs-prog-module', 'osshs-rgbw-module']
+
+LOG_CALL = re.compile(r'OSSHS_LOG_(?:ERROR|WARNING|INFO|DEBUG)\(\s*((?:"(?:[^"\\]|\\.)*"\s*)+)')
+LITERAL = re.compile(r'"((?:[^"\\]|\\.)*)"')
+CONVERSION = re.compile(r'%([-+ #0]*)(\d*)(?:\.(\d+))?(hh|h|ll|l|z|j|t)?([diouxXcps%])')
+
+
+def tokenize(filename, format):
+    """Must match osshs::log::tokenize()."""
+    token = 2166136261
+    for byte in (filename + ':' + format).encode():
+        token = ((token ^ byte) * 16777619) & 0xffffffff
+    return token
+
+
+def build_dictionary(paths):
+    dictionary = {}
+
+    for path in paths:
+        for root, _, files in os.walk(path):
+            for name in files:
+                if not name.endswith(('.cpp', '.hpp')):
+                    continue
+
+                with open(os.path.join(root, name), encoding='utf-8') as source:
+                    text = source.read()
+
+                for match in LOG_CALL.finditer(text):
+                    literal = ''.join(LITERAL.findall(match.group(1)))
+                    format = literal.encode().decode('unicode_escape')
+                    line = text.count('\n', 0, match.start()) + 1
+                    entry = dictionary.setdefault(tokenize(name, format), (name, format, []))
+                    entry[2].append(line)
+
+    return dictionary
+
+
+def format_message(format, arguments):
+    arguments = list(arguments)
+
+    def convert(match):
+        flags, width, precision, _, conversion = match.groups()
+
+        if conversion == '%':
+            return '%'
+
+        if not arguments:
+            return '<missing>'
+
+        value = arguments.pop(0)
+
+        if conversion in 'di' and value & 0x80000000:
+            value -= 1 << 32
+        elif conversion == 'p':
+            return '0x%08x' % value
+        elif conversion == 's':
+            return '<string>'
+
+        spec = '%' + flags + width + ('.' + precision if precision else '') + conversion
+        return spec % value
+
+    return CONVERSION.sub(convert, format)
+
+
+def decode(stream, dictionary, output):
+    data = b''
+
+    while True:
+        chunk = stream.read(256)
+
+        if not chunk:
+            break
+
+        data += chunk
+
+        while True:
+            start = data.find(bytes([RECORD_MAGIC]))
+
+            if start < 0:
+                data = b''
+                break
+
+            data = data[start:]
+
+            if len(data) < 2:
+                break
+
+            length = data[1]
+
+            if length < RECORD_HEADER_LENGTH - 2 or (length - RECORD_HEADER_LENGTH + 2) % 4 != 0:
+                # Not a record header, resynchronise on the next magic byte.
+                data = data[1:]
+                continue
+
+            if len(data) < length + 2:
+                break
+
+            record = data[:length + 2]
+            data = data[length + 2:]
+
+            token, timestamp, level = struct.unpack_from('<IIB', record, 2)
+            arguments = struct.unpack_from('<%dI' % ((length - RECORD_HEADER_LENGTH + 2) // 4), record, RECORD_HEADER_LENGTH)
+            level = LEVELS[level] if level < len(LEVELS) else str(level)
+
+            if token == DROPPED_TOKEN:
+                location = 'logger'
+                message = 'dropped %u messages' % arguments[0]
+            elif token in dictionary:
+                filename, format, lines = dictionary[token]
+                location = '%s:%u' % (filename, lines[0]) if len(lines) == 1 else filename
+                message = format_message(format, arguments)
+            else:
+                location = '?'
+                message = '<unknown token 0x%08x> %s' % (token, ' '.join('0x%08x' % a for a in arguments))
+
+            output.write('[%.3f][%s][%s] %s\n' % (timestamp / 1000.0, level, location, message))
+            output.flush()
+
+
+def main():
+    repository = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+
+    parser = argparse.ArgumentParser(description='Decode tokenized osshs log records.')
+    parser.add_argument('input', nargs='?', default='-', help='capture file or serial device, - for stdin')
+    parser.add_argument('--source', action='append', help='source directory to build the dictionary from')
+    parser.add_argument('--dictionary', action='store_true', help='print the token dictionary and exit')
+    arguments = parser.parse_args()
+
+    sources = arguments.source or [os.path.join(repository, path) for path in DEFAULT_SOURCES]
+    dictionary = build_dictionary(sources)
+
+    if arguments.dictionary:
+        for token, (filename, format, lines) in sorted(dictionary.items()):
+            print('0x%08x %s:%s %s' % (token, filename, ','.join(map(str, lines)), format))
+        return
+
+    stream = sys.stdin.buffer if arguments.input == '-' else open(arguments.input, 'rb', buffering=0)
+
+    try:
+        decode(stream, dictionary, sys.stdout)
+    except KeyboardInterrupt:
+        pass
+
+
+if __name__ == '__main__':
+    main()
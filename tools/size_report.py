@@ -0,0 +1,169 @@
+#!/usr/bin/env python3
+#
+# MIT License
+#
+# Copyright (c) 2019 Linas Nikiperavicius
+#
+# Permission is hereby granted, free of charge, to any person obtaining a copy
+# of this software and associated documentation files (the "Software"), to deal
+# in the Software without restriction, including without limitation the rights
+# to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+# copies of the Software, and to permit persons to whom the Software is
+# furnished to do so, subject to the following conditions:
+#
+# The above copyright notice and this permission notice shall be included in all
+# copies or substantial portions of the Software.
+#
+# THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+# IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+# FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+# AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+# LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+# OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+# SOFTWARE.
+
+
+"""
+Break the flash and RAM usage of a firmware image down by module.
+
+Symbols are attributed to modules by the source location in their debug
+information, so the breakdown stays meaningful with LTO, where the map file
+only knows the link-time partitions. Padding and symbols without debug
+information (libc, libgcc) are reported as unattributed.
+
+    ./tools/size_report.py build/osshs-rgbw-module/release/osshs-rgbw-module.elf
+    ./tools/size_report.py firmware.elf --symbols 20
+"""
+
+import argparse
+import collections
+import subprocess
+import sys
+
+# Sections by where they live: flash, RAM, or flash with a copy in RAM.
+FLASH_SECTIONS = ('.text', '.rodata', '.vector', '.reset', '.ARM.exidx', '.ARM.extab', '.init', '.fini', '.table', '.build_id', '.hardware_init')
+RAM_SECTIONS = ('.bss', '.noinit', '.stack', '.heap', '.faststack')
+COPIED_SECTIONS = ('.data', '.fastdata', '.fastcode')
+
+UNATTRIBUTED = '(unattributed)'
+
+
+def placement(section):
+    """
+    Return (flash, ram) weights of a section, None for sections not loaded on the target.
+    """
+    if section.startswith(COPIED_SECTIONS):
+        return 1, 1
+    if section.startswith(FLASH_SECTIONS):
+        return 1, 0
+    if section.startswith(RAM_SECTIONS):
+        return 0, 1
+    return None
+
+
+def module(location):
+    """
+    Map a source location to a module: the source file below 'osshs', the two
+    directories below 'modm', or the application directory.
+    """
+    if not location:
+        return UNATTRIBUTED
+
+    parts = location.rsplit(':', 1)[0].replace('\\', '/').split('/')
+    stem = parts[-1].rsplit('.', 1)[0]
+
+    if stem.endswith('_impl'):
+        stem = stem[:-len('_impl')]
+
+    if 'c++' in parts:
+        return 'libstdc++'
+
+    if 'osshs' in parts[:-1]:
+        index = len(parts) - 1 - parts[::-1].index('osshs')
+        return '/'.join(parts[index:-1] + [stem])
+
+    if 'modm' in parts[:-1]:
+        index = len(parts) - 1 - parts[::-1].index('modm')
+        return '/'.join(parts[index:-1][:3] or ['modm', stem])
+
+    return parts[-3] if len(parts) >= 3 and parts[-2] == 'src' else '/'.join(parts[-2:-1]) or stem
+
+
+def read_sections(size, elf):
+    sections = {}
+
+    for line in subprocess.check_output([size, '-A', elf], universal_newlines=True).splitlines():
+        fields = line.split()
+
+        if len(fields) == 3 and fields[1].isdigit() and placement(fields[0]) is not None:
+            sections[fields[0]] = int(fields[1])
+
+    return sections
+
+
+def read_symbols(nm, elf):
+    symbols = []
+    output = subprocess.check_output([nm, '-S', '-C', '-l', '--defined-only', '--format=sysv', elf], universal_newlines=True)
+
+    for line in output.splitlines():
+        symbol, _, location = line.partition('\t')
+        fields = symbol.rsplit('|', 6)
+
+        if len(fields) != 7 or not fields[4].strip():
+            continue
+
+        name, _, _, _, size, _, section = (field.strip() for field in fields)
+
+        if placement(section) is not None:
+            symbols.append((name, int(size, 16), section, module(location.strip())))
+
+    return symbols
+
+
+def report(sections, symbols, output, top):
+    usage = collections.defaultdict(lambda: [0, 0])
+    attributed = collections.Counter()
+
+    for name, size, section, owner in symbols:
+        flash, ram = placement(section)
+        usage[owner][0] += size * flash
+        usage[owner][1] += size * ram
+        attributed[section] += size
+
+    for section, size in sections.items():
+        flash, ram = placement(section)
+        rest = max(size - attributed[section], 0)
+        usage[UNATTRIBUTED][0] += rest * flash
+        usage[UNATTRIBUTED][1] += rest * ram
+
+    total_flash = sum(flash for flash, _ in usage.values())
+    total_ram = sum(ram for _, ram in usage.values())
+
+    output.write('%-48s %10s %10s\n' % ('module', 'flash', 'ram'))
+
+    for owner, (flash, ram) in sorted(usage.items(), key=lambda item: (-item[1][0], -item[1][1], item[0])):
+        if flash or ram:
+            output.write('%-48s %10u %10u\n' % (owner, flash, ram))
+
+    output.write('%-48s %10u %10u\n' % ('total', total_flash, total_ram))
+
+    if top:
+        output.write('\n%10s %-10s %-24s %s\n' % ('size', 'section', 'module', 'symbol'))
+
+        for name, size, section, owner in sorted(symbols, key=lambda symbol: -symbol[1])[:top]:
+            output.write('%10u %-10s %-24s %s\n' % (size, section, owner, name))
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Report flash and RAM usage of a firmware image by module.')
+    parser.add_argument('elf', help='linked firmware image with debug information')
+    parser.add_argument('--nm', default='arm-none-eabi-nm', help='nm of the target toolchain')
+    parser.add_argument('--size', default='arm-none-eabi-size', help='size of the target toolchain')
+    parser.add_argument('--symbols', type=int, default=0, metavar='N', help='also list the N largest symbols')
+    arguments = parser.parse_args()
+
+    report(read_sections(arguments.size, arguments.elf), read_symbols(arguments.nm, arguments.elf), sys.stdout, arguments.symbols)
+
+
+if __name__ == '__main__':
+    main()
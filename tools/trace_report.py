@@ -0,0 +1,153 @@
+#!/usr/bin/env python3
+#
+# MIT License
+#
+# Copyright (c) 2019 Linas Nikiperavicius
+#
+# Permission is hereby granted, free of charge, to any person obtaining a copy
+# of this software and associated documentation files (the "Software"), to deal
+# in the Software without restriction, including without limitation the rights
+# to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+# copies of the Software, and to permit persons to whom the Software is
+# furnished to do so, subject to the following conditions:
+#
+# The above copyright notice and this permission notice shall be included in all
+# copies or substantial portions of the Software.
+#
+# THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+# IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+# FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+# AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+# LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+# OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+# SOFTWARE.
+
+"""
+Render per-stage latency breakdowns from an event lifecycle trace recorded
+by firmware built with ENABLE_TRACE.
+
+Reads text log output, e.g. the result of a DiagnosticsRequestTraceEvent with
+the LOG target (decoded by tools/log_decoder.py in tokenized mode). Records read
+out over CAN with DiagnosticsTraceReadyEvent can be fed in the same format:
+
+    trace(causeId = 0x0012, type = 0x0101, stage = 1, time = 123456)
+
+    ./tools/log_decoder.py capture.bin | ./tools/trace_report.py
+    ./tools/trace_report.py --events capture.txt
+"""
+
+import argparse
+import re
+import sys
+
+# Must match osshs::events::DiagnosticsTraceStage.
+STAGES = ['MADE', 'REPORTED', 'QUEUED', 'DEQUEUED', 'LOCKED', 'TRANSFERRED', 'RESPONDED']
+
+RECORD = re.compile(r'trace\(causeId = 0x([0-9a-fA-F]+), type = 0x([0-9a-fA-F]+), stage = (\d+), time = (\d+)\)')
+
+
+def stage_name(stage):
+    return STAGES[stage] if stage < len(STAGES) else str(stage)
+
+
+def parse(lines):
+    records = []
+
+    for line in lines:
+        match = RECORD.search(line)
+
+        if match:
+            records.append((int(match.group(1), 16), int(match.group(2), 16), int(match.group(3)), int(match.group(4))))
+
+    return records
+
+
+def group(records):
+    """
+    Split the records into event lifecycles. A lifecycle is keyed by cause id and
+    ends when the request is seen again after it has been responded to, since
+    cause ids are reused.
+    """
+    open_lifecycles = {}
+    lifecycles = []
+
+    for cause_id, event_type, stage, timestamp in records:
+        lifecycle = open_lifecycles.get(cause_id)
+
+        if lifecycle is not None and lifecycle['responded'] and event_type == lifecycle['type'] and stage <= STAGES.index('REPORTED'):
+            lifecycle = None
+
+        if lifecycle is None:
+            lifecycle = {'cause_id': cause_id, 'type': event_type, 'responded': False, 'records': []}
+            open_lifecycles[cause_id] = lifecycle
+            lifecycles.append(lifecycle)
+
+        if stage == STAGES.index('RESPONDED'):
+            lifecycle['responded'] = True
+
+        lifecycle['records'].append((event_type, stage, timestamp))
+
+    return lifecycles
+
+
+def transitions(lifecycle):
+    records = lifecycle['records']
+
+    for (previous_type, previous_stage, previous_time), (event_type, stage, timestamp) in zip(records, records[1:]):
+        previous = stage_name(previous_stage) if previous_type == lifecycle['type'] else 'response ' + stage_name(previous_stage)
+        current = stage_name(stage) if event_type == lifecycle['type'] else 'response ' + stage_name(stage)
+
+        yield '%s -> %s' % (previous, current), (timestamp - previous_time) & 0xffffffff
+
+
+def report(lifecycles, output):
+    statistics = {}
+
+    for lifecycle in lifecycles:
+        per_type = statistics.setdefault(lifecycle['type'], {})
+        records = lifecycle['records']
+
+        for name, latency in transitions(lifecycle):
+            per_type.setdefault(name, []).append(latency)
+
+        if len(records) > 1:
+            per_type.setdefault('total', []).append((records[-1][2] - records[0][2]) & 0xffffffff)
+
+    for event_type in sorted(statistics):
+        output.write('event type 0x%04x\n' % event_type)
+        output.write('  %-40s %6s %10s %10s %10s\n' % ('stage', 'count', 'min [us]', 'avg [us]', 'max [us]'))
+
+        for name, latencies in statistics[event_type].items():
+            output.write('  %-40s %6u %10u %10u %10u\n' % (name, len(latencies), min(latencies), sum(latencies) // len(latencies), max(latencies)))
+
+        output.write('\n')
+
+
+def print_lifecycles(lifecycles, output):
+    for lifecycle in lifecycles:
+        output.write('causeId 0x%04x, type 0x%04x\n' % (lifecycle['cause_id'], lifecycle['type']))
+        start = lifecycle['records'][0][2]
+
+        for event_type, stage, timestamp in lifecycle['records']:
+            output.write('  %+10u us  0x%04x %s\n' % ((timestamp - start) & 0xffffffff, event_type, stage_name(stage)))
+
+        output.write('\n')
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Render per-stage latency breakdowns of an osshs event trace.')
+    parser.add_argument('input', nargs='?', default='-', help='log output containing trace records, - for stdin')
+    parser.add_argument('--events', action='store_true', help='also print every event lifecycle')
+    arguments = parser.parse_args()
+
+    stream = sys.stdin if arguments.input == '-' else open(arguments.input, 'r', errors='replace')
+    lifecycles = group(parse(stream))
+
+    if arguments.events:
+        print_lifecycles(lifecycles, sys.stdout)
+
+    report(lifecycles, sys.stdout)
+
+
+if __name__ == '__main__':
+    main()